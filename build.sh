@@ -15,8 +15,13 @@ make -C $RAYLIB_DIR/src
 
 # Build instancing examples
 cc -o build/asteroids_instanced src/instancing/asteroids_instanced.c $FLAGS $INCLUDES $LIBRARIES
+cc -o build/asteroids_streamed src/instancing/asteroids_streamed.c $FLAGS $INCLUDES $LIBRARIES
 cc -o build/particles_instanced src/instancing/particles_instanced.c $FLAGS $INCLUDES $LIBRARIES
 cc -o build/textures_bunnymark_instanced src/instancing/textures_bunnymark_instanced.c $FLAGS $INCLUDES $LIBRARIES
 cc -o build/quads_instanced src/instancing/quads_instanced.c $FLAGS $INCLUDES $LIBRARIES
 cc -o build/shapes_instanced_2d src/instancing/shapes_instanced_2d.c $FLAGS $INCLUDES $LIBRARIES
 cc -o build/shapes_instanced_3d src/instancing/shapes_instanced_3d.c $FLAGS $INCLUDES $LIBRARIES
+
+# Build and run checks, they need no window or GPU context
+cc -o build/occlusion_check src/checks/occlusion_check.c $FLAGS $INCLUDES $LIBRARIES
+./build/occlusion_check || exit 1
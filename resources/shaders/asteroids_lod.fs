@@ -0,0 +1,30 @@
+#version 330 core
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in float fragFade;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Ordered 4x4 dither threshold in [0, 1)
+float Dither(vec2 position)
+{
+    ivec2 p = ivec2(position) & 3;
+    int bayer[16] = int[16](0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5);
+    return float(bayer[p.y*4 + p.x])/16.0;
+}
+
+void main()
+{
+    // Crossfade with the impostor, the impostor keeps the fragments discarded here
+    if (Dither(gl_FragCoord.xy) < fragFade)
+        discard;
+
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    finalColor = texelColor*colDiffuse;
+}
@@ -0,0 +1,30 @@
+#version 330 core
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+
+layout (location = 12) in mat4 instance;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform vec3 viewPosition;  // Same space as instance transforms
+uniform vec2 fadeRange;     // Crossfade distances (start, end)
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out float fragFade;
+
+void main()
+{
+    // Send vertex attributes to fragment shader
+    fragTexCoord = vertexTexCoord;
+
+    // Fade is measured at the instance origin so the whole rock fades together
+    float distance = length(viewPosition - instance[3].xyz);
+    fragFade = clamp((distance - fadeRange.x)/max(fadeRange.y - fadeRange.x, 1e-4), 0.0, 1.0);
+
+    // Calculate final vertex position
+    mat4 mvpi = mvp * instance;
+    gl_Position = mvpi * vec4(vertexPosition, 1.0);
+}
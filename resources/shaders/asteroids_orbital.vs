@@ -0,0 +1,57 @@
+#version 330 core
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+
+// Orbital parameters (see OrbitalParams in src/orbital_motion.h)
+// [0]: radius, phase, angular velocity, inclination
+// [1]: node, height, scale, unused
+// [2]: spin axis, spin phase
+// [3]: spin rate
+layout (location = 12) in mat4 orbit;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float time;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+
+// Rotation matrix around a normalized axis, same as raymath MatrixRotate()
+mat3 rotate(vec3 axis, float angle)
+{
+    float s = sin(angle);
+    float c = cos(angle);
+    float t = 1.0 - c;
+    vec3 a = normalize(axis);
+
+    return mat3(a.x*a.x*t + c,       a.y*a.x*t + a.z*s,   a.z*a.x*t - a.y*s,
+                a.x*a.y*t - a.z*s,   a.y*a.y*t + c,       a.z*a.y*t + a.x*s,
+                a.x*a.z*t + a.y*s,   a.y*a.z*t - a.x*s,   a.z*a.z*t + c);
+}
+
+void main()
+{
+    // Send vertex attributes to fragment shader
+    fragTexCoord = vertexTexCoord;
+
+    // Position on the orbit, same as GetOrbitalPosition()
+    float angle = orbit[0].y + orbit[0].z*time;
+    vec3 planar = vec3(sin(angle)*orbit[0].x, orbit[1].y, cos(angle)*orbit[0].x);
+
+    float ci = cos(orbit[0].w), si = sin(orbit[0].w);
+    vec3 tilted = vec3(planar.x, ci*planar.y - si*planar.z, si*planar.y + ci*planar.z);
+
+    float cn = cos(orbit[1].x), sn = sin(orbit[1].x);
+    vec3 position = vec3(cn*tilted.x + sn*tilted.z, tilted.y, -sn*tilted.x + cn*tilted.z);
+
+    // Scale, spin then move onto the orbit
+    mat3 spin = rotate(orbit[2].xyz, orbit[2].w + orbit[3].x*time);
+    vec3 worldPosition = position + spin*(vertexPosition*orbit[1].z);
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(worldPosition, 1.0);
+}
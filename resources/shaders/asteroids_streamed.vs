@@ -0,0 +1,46 @@
+#version 330 core
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+
+// Quantized instance (see StreamInstance in src/instance_streaming.h)
+layout (location = 12) in vec3 instancePosition;    // Position in chunk, normalized
+layout (location = 13) in vec2 instanceParams;      // Scale, rotation, normalized
+
+// Input uniform values
+uniform mat4 mvp;
+uniform vec3 chunkOrigin;       // Chunk origin relative to the camera, mvp has no camera translation
+uniform float chunkSize;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+
+// Rotation matrix around a normalized axis, same as raymath MatrixRotate()
+mat3 rotate(vec3 axis, float angle)
+{
+    float s = sin(angle);
+    float c = cos(angle);
+    float t = 1.0 - c;
+    vec3 a = normalize(axis);
+
+    return mat3(a.x*a.x*t + c,       a.y*a.x*t + a.z*s,   a.z*a.x*t - a.y*s,
+                a.x*a.y*t - a.z*s,   a.y*a.y*t + c,       a.z*a.y*t + a.x*s,
+                a.x*a.z*t + a.y*s,   a.y*a.z*t - a.x*s,   a.z*a.z*t + c);
+}
+
+void main()
+{
+    // Send vertex attributes to fragment shader
+    fragTexCoord = vertexTexCoord;
+
+    // Dequantize instance, rocks rotate around the same axis as the static ring
+    float scale = 0.05 + instanceParams.x*0.2;
+    mat3 rotation = rotate(vec3(0.4, 0.6, 0.8), instanceParams.y*6.28318530718);
+    vec3 position = chunkOrigin + instancePosition*chunkSize;
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(position + rotation*(vertexPosition*scale), 1.0);
+}
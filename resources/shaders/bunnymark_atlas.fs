@@ -0,0 +1,30 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+flat in vec4 fragUvRect;
+flat in float fragLayer;
+
+// Input uniform values
+uniform sampler2DArray atlas;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// NOTE: Add here your custom variables
+
+void main()
+{
+    // Keep bilinear taps inside the sprite, coarser mip levels
+    // are covered by the gutter extruded around each sprite
+    vec2 halfTexel = 0.5/vec2(textureSize(atlas, 0).xy);
+    vec2 texCoord = clamp(fragTexCoord, fragUvRect.xy + halfTexel, fragUvRect.zw - halfTexel);
+
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(atlas, vec3(texCoord, fragLayer));
+
+    // Combine frag color with uniform colour
+    finalColor = texelColor*(colDiffuse*fragColor);
+}
@@ -0,0 +1,42 @@
+#version 330
+
+#include "vertex_pulling.glsl"
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Atlas entries, 2 x RGBA32F texels per sprite: uvRect, (layer, width, height, 0)
+uniform samplerBuffer atlasEntries;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+flat out vec4 fragUvRect;
+flat out float fragLayer;
+
+// NOTE: Add here your custom variables
+
+// Instance record: position.x, position.y, speed.x, speed.y, color(RGBA8), sprite
+const int bunnyStride = 6;
+
+void main()
+{
+    // Unit quad, scaled to the sprite size
+    PulledVertex vertex = PullVertex();
+    vec2 bunnyPosition = vec2(PullInstanceFloat(bunnyStride, 0), PullInstanceFloat(bunnyStride, 1));
+    int sprite = int(PullInstanceWord(bunnyStride, 5));
+
+    vec4 uvRect = texelFetch(atlasEntries, sprite*2);
+    vec4 info = texelFetch(atlasEntries, sprite*2 + 1);
+
+    // Send vertex attributes to fragment shader
+    fragTexCoord = mix(uvRect.xy, uvRect.zw, vertex.texcoord);
+    fragColor = PullInstanceColor(bunnyStride, 4);
+    fragUvRect = uvRect;
+    fragLayer = info.x;
+
+    vec3 position = vec3(vertex.position.xy*info.yz + bunnyPosition, 0.0);
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(position, 1.0);
+}
@@ -0,0 +1,68 @@
+#version 330
+
+// Input vertex attributes
+in vec2 vertexPosition;     // Unit quad corner in [-1, 1]
+in float instanceIndex;     // Instance transform index
+
+// Input uniform values
+uniform mat4 mvp;
+uniform samplerBuffer transforms;   // Instance transforms, 4 texels (columns) each
+uniform vec3 viewPosition;          // Same space as instance transforms
+uniform vec3 impostorCenter;        // Model bounds center
+uniform float impostorRadius;       // Model bounding sphere radius
+uniform int frames;                 // Atlas views per side
+uniform vec2 fadeRange;             // Crossfade distances (start, end)
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out float fragFade;
+
+// Map a direction to octahedral coordinates in [-1, 1], y is up
+vec2 OctahedralEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 p = n.xz;
+    if (n.y < 0.0)
+        p = (1.0 - abs(p.yx))*vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+    return p;
+}
+
+vec3 OctahedralDecode(vec2 p)
+{
+    vec3 v = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    float t = max(-v.y, 0.0);
+    v.x += (v.x >= 0.0) ? -t : t;
+    v.z += (v.z >= 0.0) ? -t : t;
+    return normalize(v);
+}
+
+void main()
+{
+    int index = int(instanceIndex)*4;
+    mat4 model = mat4(texelFetch(transforms, index), texelFetch(transforms, index + 1),
+        texelFetch(transforms, index + 2), texelFetch(transforms, index + 3));
+
+    vec3 center = (model*vec4(impostorCenter, 1.0)).xyz;
+    vec3 toView = viewPosition - center;
+
+    // View direction in model space picks the nearest atlas view
+    // NOTE: Instance scale is uniform, normalize() removes it
+    vec3 localView = normalize(transpose(mat3(model))*toView);
+    vec2 cell = clamp(floor((OctahedralEncode(localView)*0.5 + 0.5)*float(frames)), 0.0, float(frames - 1));
+    vec3 frameView = OctahedralDecode((cell + 0.5)/float(frames)*2.0 - 1.0);
+
+    // Quad faces the view it was rendered from, same basis as the atlas cameras
+    vec3 up0 = (abs(frameView.y) < 0.999) ? vec3(0.0, 1.0, 0.0) : vec3(0.0, 0.0, 1.0);
+    vec3 right = normalize(cross(up0, frameView));
+    vec3 up = cross(frameView, right);
+    vec3 position = impostorCenter + (right*vertexPosition.x + up*vertexPosition.y)*impostorRadius;
+
+    // Send vertex attributes to fragment shader
+    fragTexCoord = (cell + vertexPosition*0.5 + 0.5)/float(frames);
+    // Fade is measured at the instance origin, same as the mesh shader
+    float distance = length(viewPosition - model[3].xyz);
+    fragFade = clamp((distance - fadeRange.x)/max(fadeRange.y - fadeRange.x, 1e-4), 0.0, 1.0);
+
+    // Calculate final vertex position
+    gl_Position = mvp*model*vec4(position, 1.0);
+}
@@ -0,0 +1,74 @@
+#version 330 core
+
+// Instanced base shader, see instanced.vs for the feature defines
+
+#if defined(DEPTH_ONLY)
+void main()
+{
+}
+#else
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+#if defined(SHADOW_CASCADES)
+#define MAX_CASCADES 4
+
+in vec3 fragPosition;
+
+uniform sampler2D shadowMap;                // Cascades side by side
+uniform mat4 lightMatrices[MAX_CASCADES];   // Instance space to cascade clip space
+uniform int cascadeCount;
+
+// Lit fraction of a position, from the first cascade that contains it (3x3 PCF)
+float GetLight(vec3 position)
+{
+    vec2 texelSize = 1.0/vec2(textureSize(shadowMap, 0));
+
+    for (int i = 0; i < cascadeCount; i++)
+    {
+        vec4 clip = lightMatrices[i]*vec4(position, 1.0);
+        vec3 coord = clip.xyz/clip.w*0.5 + 0.5;
+        if (any(lessThan(coord, vec3(0.0))) || any(greaterThan(coord, vec3(1.0))))
+            continue;
+
+        vec2 uv = vec2((float(i) + coord.x)/float(cascadeCount), coord.y);
+        float bias = 0.0015*float(i + 1);
+
+        float lit = 0.0;
+        for (int y = -1; y <= 1; y++)
+        {
+            for (int x = -1; x <= 1; x++)
+                lit += (coord.z - bias <= texture(shadowMap, uv + vec2(x, y)*texelSize).r) ? 1.0 : 0.0;
+        }
+
+        return lit/9.0;
+    }
+
+    return 1.0;
+}
+#endif
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(texture0, fragTexCoord);
+
+#if defined(INSTANCE_COLOR)
+    finalColor = texelColor*(colDiffuse*fragColor);
+#else
+    finalColor = texelColor*colDiffuse;
+#endif
+
+#if defined(SHADOW_CASCADES)
+    finalColor.rgb *= mix(0.35, 1.0, GetLight(fragPosition));
+#endif
+}
+#endif
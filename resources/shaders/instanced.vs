@@ -0,0 +1,190 @@
+#version 330 core
+
+// Instanced base shader, features are enabled by the defines GetShaderVariant() adds
+// after the version line (see ShaderFeature in src/shader_variants.h):
+// INSTANCE_MATRIX: instance model matrix, else a 2D position offset
+// INSTANCE_COLOR: instance color multiplied with the texture
+// INSTANCE_RECORDS: instances fetched from a buffer texture of records (2D only)
+// VERTEX_PULLING: vertices and instances fetched from pools, no vertex layout
+// DEPTH_ONLY: only the position is computed (depth prepass, shadow maps)
+// SHADOW_CASCADES: instance space position sent to the fragment shader for shadow lookups
+// MULTI_VIEW: instances drawn once per view, gl_InstanceID selects the view (see src/multi_view.h)
+// QUANTIZED_VERTICES: 16-bit positions, octahedral normals and half float texcoords (see src/mesh_quantize.h)
+
+#if defined(VERTEX_PULLING)
+#include "vertex_pulling.glsl"
+#elif defined(QUANTIZED_VERTICES)
+// Input vertex attributes, integers as stored
+in vec4 vertexPosition;     // 16-bit position in the model bounds, w holds 8-bit normals
+in vec2 vertexTexCoord;     // Half float texcoord
+in vec2 vertexNormal;       // 16-bit octahedral normal
+
+// Position decode, position = offset + quantized*scale
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+uniform int normalBits;
+#else
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+#endif
+
+// Instance record, in words for 2D records and in vec4 texels for matrices
+#if defined(INSTANCE_MATRIX)
+// model matrix (4 x vec4 texels)
+const int instanceStride = 4;
+#else
+// position.x, position.y, speed.x, speed.y, color(RGBA8), sprite
+const int instanceStride = 6;
+#endif
+
+#if defined(INSTANCE_RECORDS)
+#if defined(INSTANCE_MATRIX)
+#error INSTANCE_RECORDS only stores 2D positions
+#endif
+// Instance records, 1 x R32UI texel per word
+uniform usamplerBuffer instanceRecords;
+#if !defined(VERTEX_PULLING)
+uniform int instanceBase;
+#endif
+#elif !defined(VERTEX_PULLING)
+// Input instance attributes
+#if defined(INSTANCE_MATRIX)
+layout (location = 12) in mat4 instance;
+#else
+in vec2 instancePosition;
+#endif
+#if defined(INSTANCE_COLOR)
+in vec4 instanceColor;
+#endif
+#endif
+
+// Input uniform values
+uniform mat4 mvp;
+
+#if defined(MULTI_VIEW)
+#if !defined(INSTANCE_MATRIX)
+#error MULTI_VIEW needs INSTANCE_MATRIX
+#endif
+#define MAX_VIEWS 16
+
+// Instance attributes advance every viewCount instances, consecutive instances are the views of one record
+uniform int viewCount;
+uniform mat4 viewProjections[MAX_VIEWS];    // Instance space to view clip space
+uniform vec4 viewRegions[MAX_VIEWS];        // View region in target clip space (scale, offset)
+
+out float gl_ClipDistance[4];
+#endif
+
+// Depth prepass and color pass use different variants, their depth must match exactly (EQUAL test)
+invariant gl_Position;
+
+// Output vertex attributes (to fragment shader)
+#if !defined(DEPTH_ONLY)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+#endif
+#if defined(SHADOW_CASCADES)
+#if !defined(INSTANCE_MATRIX)
+#error SHADOW_CASCADES needs INSTANCE_MATRIX
+#endif
+out vec3 fragPosition;
+#endif
+#if defined(QUANTIZED_VERTICES) && !defined(DEPTH_ONLY)
+out vec3 fragNormal;        // Decoded normal, for lit fragment shaders
+#endif
+
+vec4 UnpackColor(uint color)
+{
+    return vec4(color & 0xFFu, (color >> 8) & 0xFFu, (color >> 16) & 0xFFu, color >> 24)/255.0;
+}
+
+#if defined(QUANTIZED_VERTICES)
+// Decode octahedral normal, components in [-1, 1]
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#endif
+
+void main()
+{
+#if defined(VERTEX_PULLING)
+    PulledVertex vertex = PullVertex();
+    vec3 position = vertex.position;
+    vec2 texcoord = vertex.texcoord;
+#elif defined(QUANTIZED_VERTICES)
+    vec3 position = positionOffset + vertexPosition.xyz*positionScale;
+    vec2 texcoord = vertexTexCoord;
+    vec2 octahedral = vertexNormal/32767.0;
+    if (normalBits == 8)
+        octahedral = (vec2(floor(vertexPosition.w/256.0), mod(vertexPosition.w, 256.0)) - 127.0)/127.0;
+    vec3 normal = DecodeOctahedral(octahedral);
+#else
+    vec3 position = vertexPosition;
+    vec2 texcoord = vertexTexCoord;
+#endif
+
+    // Fetch instance data
+    vec4 color = vec4(1.0);
+#if defined(VERTEX_PULLING)
+#if defined(INSTANCE_MATRIX)
+    mat4 model = PullInstanceMatrix(instanceStride, 0);
+#else
+    vec2 offset = vec2(PullInstanceFloat(instanceStride, 0), PullInstanceFloat(instanceStride, 1));
+#endif
+#if defined(INSTANCE_COLOR)
+    color = PullInstanceColor(instanceStride, 4);
+#endif
+#elif defined(INSTANCE_RECORDS)
+    int base = (instanceBase + gl_InstanceID)*instanceStride;
+    vec2 offset = uintBitsToFloat(uvec2(texelFetch(instanceRecords, base).r, texelFetch(instanceRecords, base + 1).r));
+#if defined(INSTANCE_COLOR)
+    color = UnpackColor(texelFetch(instanceRecords, base + 4).r);
+#endif
+#else
+#if defined(INSTANCE_MATRIX)
+    mat4 model = instance;
+#else
+    vec2 offset = instancePosition;
+#endif
+#if defined(INSTANCE_COLOR)
+    color = instanceColor;
+#endif
+#endif
+
+    // Send vertex attributes to fragment shader
+#if !defined(DEPTH_ONLY)
+    fragTexCoord = texcoord;
+    fragColor = color;
+#endif
+#if defined(SHADOW_CASCADES)
+    fragPosition = (model*vec4(position, 1.0)).xyz;
+#endif
+#if defined(QUANTIZED_VERTICES) && !defined(DEPTH_ONLY)
+#if defined(INSTANCE_MATRIX)
+    fragNormal = normalize(mat3(model)*normal);
+#else
+    fragNormal = normal;
+#endif
+#endif
+
+    // Calculate final vertex position
+#if defined(MULTI_VIEW)
+    // Clip against the view frustum sides, then move the view into its region of the target
+    int view = gl_InstanceID%viewCount;
+    vec4 clip = viewProjections[view]*model*vec4(position, 1.0);
+    gl_ClipDistance[0] = clip.w + clip.x;
+    gl_ClipDistance[1] = clip.w - clip.x;
+    gl_ClipDistance[2] = clip.w + clip.y;
+    gl_ClipDistance[3] = clip.w - clip.y;
+    gl_Position = vec4(clip.xy*viewRegions[view].xy + viewRegions[view].zw*clip.w, clip.zw);
+#elif defined(INSTANCE_MATRIX)
+    gl_Position = mvp*model*vec4(position, 1.0);
+#else
+    gl_Position = mvp*vec4(position + vec3(offset, 0.0), 1.0);
+#endif
+}
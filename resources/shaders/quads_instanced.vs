@@ -8,7 +8,10 @@ in vec4 vertexColor;
 
 // Input uniform values
 uniform mat4 mvp;
-uniform vec2 offsets[100];
+
+// Per-instance offsets stored in a buffer texture (one RG32F texel per instance)
+uniform samplerBuffer offsets;
+uniform int instanceBase;
 
 // Output vertex attributes (to fragment shader)
 out vec2 fragTexCoord;
@@ -25,7 +28,7 @@ void main()
     // Calculate final vertex position
     vec3 position = vertexPosition;
 
-    vec2 offset = offsets[gl_InstanceID];
+    vec2 offset = texelFetch(offsets, instanceBase + gl_InstanceID).xy;
     //position.x += gl_InstanceID * 70.0f;
 
     gl_Position = mvp*vec4(position, 1.0);
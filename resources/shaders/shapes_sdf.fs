@@ -0,0 +1,80 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragLocal;
+flat in vec4 fragShape;
+flat in int fragType;
+in vec4 fragColor;
+
+// Input uniform values
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+#define SDF_CIRCLE 0
+#define SDF_RING 1
+#define SDF_RECTANGLE 2
+#define SDF_LINE 3
+
+#define SDF_CAP_BUTT 0
+#define SDF_CAP_ROUND 1
+
+// Signed distance to a box centered on origin with rounded corners
+float RoundedBox(vec2 p, vec2 halfSize, float radius)
+{
+    radius = min(radius, min(halfSize.x, halfSize.y));
+    vec2 q = abs(p) - halfSize + radius;
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
+
+void main()
+{
+    float dist = 0.0;
+
+    if (fragType == SDF_CIRCLE)
+    {
+        dist = length(fragLocal) - fragShape.x;
+    }
+    else if (fragType == SDF_RING)
+    {
+        dist = abs(length(fragLocal) - fragShape.x) - fragShape.y;
+    }
+    else if (fragType == SDF_RECTANGLE)
+    {
+        dist = RoundedBox(fragLocal, fragShape.xy, fragShape.z);
+
+        // Outline grows inwards from the rectangle bounds
+        float lineThick = fragShape.w;
+        if (lineThick > 0.0)
+            dist = abs(dist + 0.5*lineThick) - 0.5*lineThick;
+    }
+    else
+    {
+        float len = fragShape.x;
+        float halfThick = fragShape.y;
+        int cap = int(fragShape.z + 0.5);
+
+        if (cap == SDF_CAP_ROUND)
+        {
+            // Capsule, distance to closest point on segment
+            vec2 closest = vec2(clamp(fragLocal.x, 0.0, len), 0.0);
+            dist = length(fragLocal - closest) - halfThick;
+        }
+        else
+        {
+            // Square caps extend the segment by half its thickness
+            float extend = (cap == SDF_CAP_BUTT) ? 0.0 : halfThick;
+            vec2 halfSize = vec2(0.5*len + extend, halfThick);
+            dist = RoundedBox(fragLocal - vec2(0.5*len, 0.0), halfSize, 0.0);
+        }
+    }
+
+    // Anti-aliasing over one pixel using screen space derivative of distance
+    float width = max(fwidth(dist), 1e-4);
+    float coverage = clamp(0.5 - dist/width, 0.0, 1.0);
+    if (coverage <= 0.0)
+        discard;
+
+    finalColor = vec4(fragColor.rgb, fragColor.a*coverage)*colDiffuse;
+}
@@ -0,0 +1,81 @@
+#version 330
+
+// Input vertex attributes
+in vec2 vertexPosition;     // Unit quad corner in [-1, 1]
+
+in vec4 shapeGeometry;      // Shape placement, depends on type
+in vec2 shapeParams;        // Shape parameters, depends on type
+in vec4 shapeColor;
+in float shapeType;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float aaMargin;     // Quad growth for anti-aliased edges (world units)
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragLocal;         // Position in shape space
+flat out vec4 fragShape;    // Shape extents in shape space
+flat out int fragType;
+out vec4 fragColor;
+
+#define SDF_CIRCLE 0
+#define SDF_RING 1
+#define SDF_RECTANGLE 2
+#define SDF_LINE 3
+
+#define SDF_CAP_BUTT 0
+
+void main()
+{
+    int type = int(shapeType + 0.5);
+    vec2 position = vec2(0.0);
+
+    if (type == SDF_LINE)
+    {
+        // Quad aligned with the segment, origin at start point
+        vec2 start = shapeGeometry.xy;
+        vec2 end = shapeGeometry.zw;
+        float len = length(end - start);
+        vec2 dir = (len > 0.0) ? (end - start)/len : vec2(1.0, 0.0);
+        vec2 normal = vec2(-dir.y, dir.x);
+
+        float halfThick = 0.5*shapeParams.x;
+        float cap = (int(shapeParams.y + 0.5) == SDF_CAP_BUTT) ? 0.0 : halfThick;
+
+        vec2 corner = vertexPosition*0.5 + 0.5;
+        fragLocal.x = mix(-cap - aaMargin, len + cap + aaMargin, corner.x);
+        fragLocal.y = vertexPosition.y*(halfThick + aaMargin);
+        fragShape = vec4(len, halfThick, shapeParams.y, 0.0);
+
+        position = start + dir*fragLocal.x + normal*fragLocal.y;
+    }
+    else if (type == SDF_RECTANGLE)
+    {
+        // Quad centered on rectangle
+        vec2 halfSize = 0.5*shapeGeometry.zw;
+        vec2 center = shapeGeometry.xy + halfSize;
+
+        fragLocal = vertexPosition*(halfSize + aaMargin);
+        fragShape = vec4(halfSize, shapeParams);
+
+        position = center + fragLocal;
+    }
+    else
+    {
+        // Quad centered on circle, rings extend half their thickness outwards
+        float radius = shapeGeometry.z;
+        float halfThick = (type == SDF_RING) ? 0.5*shapeGeometry.w : 0.0;
+
+        fragLocal = vertexPosition*(radius + halfThick + aaMargin);
+        fragShape = vec4(radius, halfThick, 0.0, 0.0);
+
+        position = shapeGeometry.xy + fragLocal;
+    }
+
+    // Send vertex attributes to fragment shader
+    fragType = type;
+    fragColor = shapeColor;
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(position, 0.0, 1.0);
+}
@@ -0,0 +1,30 @@
+#version 330
+
+// Input vertex attributes
+in vec2 vertexPosition;     // Unit quad corner
+
+in vec2 spritePosition;     // Top-left corner of the sprite
+in vec4 spriteTint;
+in vec4 spriteSource;       // Sprite rectangle in texture (pixels)
+
+// Input uniform values
+uniform mat4 mvp;
+uniform sampler2D texture0;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main()
+{
+    vec2 texSize = vec2(textureSize(texture0, 0));
+
+    // Send vertex attributes to fragment shader
+    fragTexCoord = (spriteSource.xy + vertexPosition*spriteSource.zw)/texSize;
+    fragColor = spriteTint;
+
+    // Calculate final vertex position
+    vec2 position = spritePosition + vertexPosition*abs(spriteSource.zw);
+
+    gl_Position = mvp*vec4(position, 0.0, 1.0);
+}
@@ -0,0 +1,30 @@
+#version 330
+
+// Input vertex attributes
+in vec2 vertexPosition;     // Unit quad corner
+
+in vec3 glyphPlacement;     // Glyph position (xy) and scale (z)
+in vec4 glyphColor;
+in vec4 glyphSource;        // Glyph rectangle in font atlas (pixels)
+
+// Input uniform values
+uniform mat4 mvp;
+uniform sampler2D texture0;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main()
+{
+    vec2 atlasSize = vec2(textureSize(texture0, 0));
+
+    // Send vertex attributes to fragment shader
+    fragTexCoord = (glyphSource.xy + vertexPosition*glyphSource.zw)/atlasSize;
+    fragColor = glyphColor;
+
+    // Calculate final vertex position
+    vec2 position = glyphPlacement.xy + vertexPosition*glyphSource.zw*glyphPlacement.z;
+
+    gl_Position = mvp*vec4(position, 0.0, 1.0);
+}
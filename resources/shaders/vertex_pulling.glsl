@@ -0,0 +1,81 @@
+// Vertex pulling helpers
+// NOTE: Pasted by LoadShaderPulled() and LoadShaderVariantText() in place of the '#include "vertex_pulling.glsl"' line
+
+// Geometry pool: 2 x RGBA32F texels per vertex
+// texel 0: position.xyz, texcoord.x
+// texel 1: texcoord.y, normal.xyz
+uniform samplerBuffer vertexPool;
+
+// Index pool: 1 x R32UI texel per index, relative to vertexBase
+uniform usamplerBuffer indexPool;
+
+// Instance pool, same storage read as raw words and as vec4 texels
+uniform usamplerBuffer instanceWords;
+uniform samplerBuffer instanceTexels;
+
+// Base offsets of the current draw
+uniform int vertexBase;
+uniform int indexBase;
+uniform int instanceBase;
+
+struct PulledVertex {
+    vec3 position;
+    vec2 texcoord;
+    vec3 normal;
+};
+
+// Fetch vertex attributes for gl_VertexID
+PulledVertex PullVertex()
+{
+    int index = int(texelFetch(indexPool, indexBase + gl_VertexID).r);
+    int texel = (vertexBase + index)*2;
+
+    vec4 texel0 = texelFetch(vertexPool, texel);
+    vec4 texel1 = texelFetch(vertexPool, texel + 1);
+
+    PulledVertex vertex;
+    vertex.position = texel0.xyz;
+    vertex.texcoord = vec2(texel0.w, texel1.x);
+    vertex.normal = texel1.yzw;
+
+    return vertex;
+}
+
+// Index of the current instance record inside the instance pool
+int GetInstanceIndex()
+{
+    return instanceBase + gl_InstanceID;
+}
+
+// Fetch a 32 bit word of the current instance record, stride in words
+uint PullInstanceWord(int stride, int word)
+{
+    return texelFetch(instanceWords, GetInstanceIndex()*stride + word).r;
+}
+
+float PullInstanceFloat(int stride, int word)
+{
+    return uintBitsToFloat(PullInstanceWord(stride, word));
+}
+
+// Fetch an RGBA8 color packed in one word
+vec4 PullInstanceColor(int stride, int word)
+{
+    uint color = PullInstanceWord(stride, word);
+    return vec4(color & 0xFFu, (color >> 8) & 0xFFu, (color >> 16) & 0xFFu, color >> 24)/255.0;
+}
+
+// Fetch a vec4 texel of the current instance record, stride in texels
+vec4 PullInstanceTexel(int stride, int texel)
+{
+    return texelFetch(instanceTexels, GetInstanceIndex()*stride + texel);
+}
+
+// Fetch a column-major matrix stored in 4 consecutive texels
+mat4 PullInstanceMatrix(int stride, int texel)
+{
+    return mat4(PullInstanceTexel(stride, texel),
+                PullInstanceTexel(stride, texel + 1),
+                PullInstanceTexel(stride, texel + 2),
+                PullInstanceTexel(stride, texel + 3));
+}
@@ -0,0 +1,221 @@
+#ifndef BATCH_BUILDER_H
+#define BATCH_BUILDER_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "worker_pool.h"
+
+// Required for: offsetof()
+#include <stddef.h>
+
+// Batch vertex, same attributes as the rlgl default batch (24 bytes)
+typedef struct BatchVertex {
+    Vector3 position;
+    Vector2 texcoord;
+    Color color;
+} BatchVertex;
+
+// Record vertices of items [start, end), vertices of item i start at (i - start) * verticesPerItem
+// NOTE: Called from several threads at once on disjoint ranges, must not call raylib/rlgl
+typedef void (*BatchRecordFunc)(const void* items, int start, int end, BatchVertex* vertices, const void* userData);
+
+// Multithreaded batch builder, threads record disjoint ranges of a draw list straight
+// into one vertex array that is uploaded and drawn with one draw call per texture
+// NOTE: Fallback for hardware without instancing, every item still costs its vertices
+typedef struct BatchBuilder {
+    WorkerPool* pool;                       // Recording threads, main thread included
+    double recordTimes[WORKER_POOL_MAX_THREADS]; // Last recording time of each thread (seconds)
+
+    // Current job
+    BatchRecordFunc record;
+    const void* items;
+    const void* userData;
+    int itemCount;
+    int verticesPerItem;
+
+    BatchVertex* vertices;                  // Recorded vertices (CPU)
+    int vertexCount;                        // Recorded vertices count
+    int vertexCapacity;                     // Vertices allocated (CPU and GPU)
+
+    unsigned int vaoId;                     // Vertex array (default shader attributes)
+    unsigned int vboId;                     // Vertex buffer
+    unsigned int eboId;                     // Quad indices buffer (unsigned int)
+    int quadCapacity;                       // Quads covered by the indices buffer
+
+    double recordTime;                      // Last recording wall time (seconds)
+} BatchBuilder;
+
+// Record range of current job assigned to a pool thread
+void RecordBatchRange(void* data, int index)
+{
+    BatchBuilder* builder = (BatchBuilder*)data;
+    double start = GetWorkerTime();
+
+    int first = 0;
+    int last = 0;
+    GetWorkerRange(builder->pool, builder->itemCount, index, &first, &last);
+
+    if (last > first)
+        builder->record(builder->items, first, last, &builder->vertices[first * builder->verticesPerItem], builder->userData);
+
+    builder->recordTimes[index] = GetWorkerTime() - start;
+}
+
+// Load batch builder, threadCount <= 0 uses every core
+BatchBuilder* LoadBatchBuilder(int threadCount)
+{
+    BatchBuilder* builder = (BatchBuilder*)RL_CALLOC(1, sizeof(BatchBuilder));
+    builder->pool = LoadWorkerPool(threadCount);
+    builder->vaoId = rlLoadVertexArray();
+
+    TraceLog(LOG_INFO, "BATCH: Builder loaded (%i recording threads)", builder->pool->threadCount);
+
+    return builder;
+}
+
+// Stop recording threads and unload batch builder
+void UnloadBatchBuilder(BatchBuilder* builder)
+{
+    UnloadWorkerPool(builder->pool);
+
+    if (builder->vboId != 0)
+        rlUnloadVertexBuffer(builder->vboId);
+    if (builder->eboId != 0)
+        rlUnloadVertexBuffer(builder->eboId);
+    rlUnloadVertexArray(builder->vaoId);
+
+    RL_FREE(builder->vertices);
+    RL_FREE(builder);
+}
+
+// Grow vertex storage and GPU buffer, vertex layout is set up again on the new buffer
+void ReserveBatchVertices(BatchBuilder* builder, int vertexCount)
+{
+    if (vertexCount <= builder->vertexCapacity)
+        return;
+
+    int capacity = (builder->vertexCapacity > 0) ? builder->vertexCapacity : 4096;
+    while (capacity < vertexCount)
+        capacity *= 2;
+
+    RL_FREE(builder->vertices);
+    builder->vertices = (BatchVertex*)RL_MALLOC(capacity * sizeof(BatchVertex));
+    builder->vertexCapacity = capacity;
+
+    rlEnableVertexArray(builder->vaoId);
+
+    if (builder->vboId != 0)
+        rlUnloadVertexBuffer(builder->vboId);
+    builder->vboId = rlLoadVertexBuffer(NULL, capacity * sizeof(BatchVertex), true);
+
+    // Default shader attribute locations
+    int* locs = rlGetShaderLocsDefault();
+
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION], 3, RL_FLOAT, false, sizeof(BatchVertex), (void*)0);
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, sizeof(BatchVertex), (void*)offsetof(BatchVertex, texcoord));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, sizeof(BatchVertex), (void*)offsetof(BatchVertex, color));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR]);
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+}
+
+// Grow quad indices buffer, 6 indices per quad of 4 vertices
+void ReserveBatchQuads(BatchBuilder* builder, int quadCount)
+{
+    if (quadCount <= builder->quadCapacity)
+        return;
+
+    int capacity = (builder->quadCapacity > 0) ? builder->quadCapacity : 1024;
+    while (capacity < quadCount)
+        capacity *= 2;
+
+    unsigned int* indices = (unsigned int*)RL_MALLOC(capacity * 6 * sizeof(unsigned int));
+    for (int i = 0; i < capacity; i++)
+    {
+        indices[i * 6 + 0] = i * 4 + 0;
+        indices[i * 6 + 1] = i * 4 + 1;
+        indices[i * 6 + 2] = i * 4 + 2;
+        indices[i * 6 + 3] = i * 4 + 0;
+        indices[i * 6 + 4] = i * 4 + 2;
+        indices[i * 6 + 5] = i * 4 + 3;
+    }
+
+    rlEnableVertexArray(builder->vaoId);
+    if (builder->eboId != 0)
+        rlUnloadVertexBuffer(builder->eboId);
+    builder->eboId = rlLoadVertexBufferElement(indices, capacity * 6 * sizeof(unsigned int), false);
+    rlDisableVertexArray();
+    rlDisableVertexBufferElement();
+
+    builder->quadCapacity = capacity;
+    RL_FREE(indices);
+}
+
+// Record a draw list on every thread, returns once all ranges are recorded
+void RecordBatch(BatchBuilder* builder, BatchRecordFunc record, const void* items, int itemCount, int verticesPerItem, const void* userData)
+{
+    double start = GetWorkerTime();
+
+    ReserveBatchVertices(builder, itemCount * verticesPerItem);
+
+    builder->record = record;
+    builder->items = items;
+    builder->userData = userData;
+    builder->itemCount = itemCount;
+    builder->verticesPerItem = verticesPerItem;
+    RunWorkerPool(builder->pool, RecordBatchRange, builder);
+
+    builder->vertexCount = itemCount * verticesPerItem;
+    builder->recordTime = GetWorkerTime() - start;
+}
+
+// Upload recorded quads with one buffer update and draw them with the default shader
+void DrawBatchQuads(BatchBuilder* builder, Texture2D texture)
+{
+    int quadCount = builder->vertexCount / 4;
+    if (quadCount == 0)
+        return;
+
+    ReserveBatchQuads(builder, quadCount);
+
+    // Flush pending batched draws, recorded quads are drawn after them
+    rlDrawRenderBatchActive();
+
+    rlUpdateVertexBuffer(builder->vboId, builder->vertices, quadCount * 4 * sizeof(BatchVertex), 0);
+
+    rlEnableShader(rlGetShaderIdDefault());
+    int* locs = rlGetShaderLocsDefault();
+
+    Matrix matMVP = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(texture.id);
+
+    rlEnableVertexArray(builder->vaoId);
+    glDrawElements(GL_TRIANGLES, quadCount * 6, GL_UNSIGNED_INT, 0);
+    rlDisableVertexArray();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Write a textured quad, same corner order as the rlgl batch (top-left, bottom-left, bottom-right, top-right)
+// NOTE: source is given in normalized texture coordinates
+void WriteBatchQuad(BatchVertex* vertices, Rectangle dest, Rectangle source, Color tint)
+{
+    vertices[0] = (BatchVertex) { { dest.x, dest.y, 0.0f }, { source.x, source.y }, tint };
+    vertices[1] = (BatchVertex) { { dest.x, dest.y + dest.height, 0.0f }, { source.x, source.y + source.height }, tint };
+    vertices[2] = (BatchVertex) { { dest.x + dest.width, dest.y + dest.height, 0.0f }, { source.x + source.width, source.y + source.height }, tint };
+    vertices[3] = (BatchVertex) { { dest.x + dest.width, dest.y, 0.0f }, { source.x + source.width, source.y }, tint };
+}
+
+#endif // BATCH_BUILDER_H
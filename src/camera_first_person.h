@@ -3,6 +3,7 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "input_replay.h"
 
 // Camera constants
 const float MovementSpeed = 30.0f;
@@ -18,6 +19,7 @@ typedef struct CameraFP {
     float pitch;
     float zoom;
     bool constrainPitch;
+    bool dirty;             // Position, yaw/pitch or fovy changed, cleared by the user (see MarkCameraFPDirty)
 } CameraFP;
 
 CameraFP LoadCameraFP()
@@ -30,7 +32,8 @@ CameraFP LoadCameraFP()
         .yaw = -90.0f,
         .pitch = 0.0f,
         .zoom = 45.0f,
-        .constrainPitch = true
+        .constrainPitch = true,
+        .dirty = true
     };
 
     // Define the camera to look into our 3d world
@@ -45,6 +48,12 @@ CameraFP LoadCameraFP()
     return camera;
 }
 
+// Mark camera as changed, cached view dependent results must be checked again
+void MarkCameraFPDirty(CameraFP* camera)
+{
+    camera->dirty = true;
+}
+
 // Calculates the front vector from the Camera's (updated) Euler Angles
 void UpdateCameraVectors(CameraFP* camera)
 {
@@ -65,11 +74,12 @@ void UpdateCameraVectors(CameraFP* camera)
 // Adjust yaw and pitch to look around and contrain pitch(up and down).
 void UpdateMouseMovement(CameraFP* camera, int xoffset, int yoffset)
 {
-    xoffset *= MouseSensitivity * GetFrameTime();
-    yoffset *= MouseSensitivity * GetFrameTime();
+    xoffset *= MouseSensitivity * GetInputFrameTime();
+    yoffset *= MouseSensitivity * GetInputFrameTime();
 
     camera->yaw += xoffset;
     camera->pitch -= yoffset;
+    MarkCameraFPDirty(camera);
 
     // Make sure that when pitch is out of bounds, screen doesn't get flipped.
     if (camera->constrainPitch)
@@ -77,32 +87,36 @@ void UpdateMouseMovement(CameraFP* camera, int xoffset, int yoffset)
     UpdateCameraVectors(camera);
 }
 
-void UpdateZoom(Camera3D* camera, float zoom, int yoffset)
+bool UpdateZoom(Camera3D* camera, float zoom, int yoffset)
 {
+    float fovy = camera->fovy;
+
     if (camera->fovy >= 1.0f && camera->fovy <= 45.0f)
         camera->fovy -= yoffset;
     if (zoom <= 1.0f)
         camera->fovy = 1.0f;
     if (camera->fovy >= 45.0f)
         camera->fovy = 45.0f;
+
+    return camera->fovy != fovy;
 }
 
 // Move camera around in 3D.
 Vector3 GetMovement(CameraFP *camera, float dt)
 {
     Vector3 direction = Vector3Zero();
-    if (IsKeyDown(KEY_W))
+    if (IsInputKeyDown(KEY_W))
         direction = Vector3Add(direction, camera->front);
-    if (IsKeyDown(KEY_A))
+    if (IsInputKeyDown(KEY_A))
         direction = Vector3Add(direction, Vector3Negate(camera->right));
-    if (IsKeyDown(KEY_S))
+    if (IsInputKeyDown(KEY_S))
         direction = Vector3Add(direction, Vector3Negate(camera->front));
-    if (IsKeyDown(KEY_D))
+    if (IsInputKeyDown(KEY_D))
         direction = Vector3Add(direction, camera->right);
 
-    if (IsKeyDown(KEY_SPACE))
+    if (IsInputKeyDown(KEY_SPACE))
         direction = Vector3Add(direction, camera->up);
-    if (IsKeyDown(KEY_LEFT_SHIFT))
+    if (IsInputKeyDown(KEY_LEFT_SHIFT))
         direction =  Vector3Add(direction, Vector3Negate(camera->up));
 
     return Vector3Scale(direction,  camera->currentSpeed * dt);
@@ -111,14 +125,16 @@ Vector3 GetMovement(CameraFP *camera, float dt)
 void UpdateCameraCustom(CameraFP* camera, Vector2 mouseDelta, float dt)
 {
     // Speed up/slow down
-    if (IsKeyPressed(KEY_LEFT_CONTROL))
+    if (IsInputKeyPressed(KEY_LEFT_CONTROL))
         camera->currentSpeed = MovementSpeed * 2.0f;
-    if (IsKeyReleased(KEY_LEFT_CONTROL))
+    if (IsInputKeyReleased(KEY_LEFT_CONTROL))
         camera->currentSpeed = MovementSpeed;
 
     // Flying first person camera movement
     Vector3 movementDelta = GetMovement(camera, dt);
     camera->view.position = Vector3Add(camera->view.position, movementDelta);
+    if ((movementDelta.x != 0.0f) || (movementDelta.y != 0.0f) || (movementDelta.z != 0.0f))
+        MarkCameraFPDirty(camera);
 
     // Look around using mouse movement
     if (mouseDelta.x != 0 || mouseDelta.y != 0)
@@ -127,9 +143,9 @@ void UpdateCameraCustom(CameraFP* camera, Vector2 mouseDelta, float dt)
     camera->view.target = Vector3Add(camera->view.position, camera->front);
 
     // Zoom in and out with the scroll wheel
-    int scrollY = GetMouseWheelMove();
-    if (scrollY != 0)
-        UpdateZoom(&camera->view, camera->zoom, scrollY);
+    int scrollY = GetInputMouseWheelMove();
+    if ((scrollY != 0) && UpdateZoom(&camera->view, camera->zoom, scrollY))
+        MarkCameraFPDirty(camera);
 }
 
 #endif // CAMERA_FIRST_PERSON_H
@@ -0,0 +1,21 @@
+/*******************************************************************************************
+ *
+ *   Occlusion culling check
+ *
+ *   Runs CheckOcclusionCulling() without a window or GPU context,
+ *   exits with a non-zero status when the check fails
+ *
+ ********************************************************************************************/
+
+#include "raylib.h"
+#include "occlusion_culling.h"
+
+int main(void)
+{
+    if (!CheckOcclusionCulling())
+        return 1;
+
+    TraceLog(LOG_INFO, "OCCLUSION: Self-check passed");
+
+    return 0;
+}
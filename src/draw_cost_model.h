@@ -0,0 +1,350 @@
+#ifndef DRAW_COST_MODEL_H
+#define DRAW_COST_MODEL_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// Timestamp query pairs in flight per draw group, results are read a few frames late
+#ifndef DRAW_COST_QUERIES
+#define DRAW_COST_QUERIES 4
+#endif
+
+// Calibration runs per submission path, from calibration instances / 4^(runs - 1) up to all of them
+#define DRAW_COST_CALIBRATION_RUNS 4
+// Repeats of each calibration run, the fastest one is kept
+#define DRAW_COST_CALIBRATION_REPEATS 3
+
+// Ways to submit a draw group
+typedef enum DrawSubmission {
+    DRAW_SUBMIT_BATCHED = 0,    // Vertices of every instance written to a render batch
+    DRAW_SUBMIT_INSTANCED,      // One instanced draw call
+    DRAW_SUBMIT_INDIRECT,       // One instanced draw call, parameters read from an indirect buffer
+    DRAW_SUBMIT_COUNT
+} DrawSubmission;
+
+static const char* drawSubmissionText[DRAW_SUBMIT_COUNT] = {
+    "batched",
+    "instanced",
+    "indirect",
+};
+
+// Draw instanceCount instances of a group with a submission path
+typedef void (*DrawGroupCallback)(int submission, int instanceCount, void* userData);
+
+// Linear cost of a submission path (seconds), CPU submit and GPU time are fitted separately
+// and a draw costs the slowest of both since they overlap in a pipelined frame
+typedef struct DrawCost {
+    float cpuFixed;
+    float cpuPerInstance;
+    float gpuFixed;
+    float gpuPerInstance;
+} DrawCost;
+
+// Draw group stats, times in seconds
+typedef struct DrawGroupStats {
+    int submission;                         // Submission path used last frame
+    int instances;                          // Instances drawn last frame
+    double predicted[DRAW_SUBMIT_COUNT];    // Predicted cost of every path for last frame instances
+    double cpuTime;                         // Measured submit time (latest result)
+    double gpuTime;                         // Measured GPU time (latest result)
+    int switches;                           // Submission path changes (total)
+} DrawGroupStats;
+
+// Group of identical instances, submitted through the path the cost model predicts cheapest
+// NOTE: Model is calibrated once at load, then every frame corrects the prediction of the
+// path in use with its measured cost. A cheaper path must stay cheaper by hysteresis for
+// holdFrames frames before the group switches to it, so close costs never flip every frame
+typedef struct DrawGroup {
+    const char* name;
+    DrawGroupCallback draw;
+    void* userData;
+
+    bool supported[DRAW_SUBMIT_COUNT];      // Paths the group can be drawn with
+    DrawCost costs[DRAW_SUBMIT_COUNT];      // Calibrated cost of every path
+    float correction[DRAW_SUBMIT_COUNT];    // Measured / predicted cost ratio (running average)
+    float hysteresis;                       // Relative saving needed to switch path
+    int holdFrames;                         // Frames the saving must hold before switching
+
+    int submission;                         // Current submission path
+    int candidate;                          // Cheaper path waiting for holdFrames
+    int candidateFrames;
+
+    unsigned int queries[DRAW_COST_QUERIES][2];     // Start and end timestamps
+    bool queryPending[DRAW_COST_QUERIES];
+    int querySubmission[DRAW_COST_QUERIES];
+    int queryInstances[DRAW_COST_QUERIES];
+    double queryCpuTime[DRAW_COST_QUERIES];
+    int queryIndex;
+
+    DrawGroupStats stats;
+} DrawGroup;
+
+// Load draw group, every path is supported until calibration
+DrawGroup LoadDrawGroup(const char* name, DrawGroupCallback draw, void* userData)
+{
+    DrawGroup group = { 0 };
+    group.name = name;
+    group.draw = draw;
+    group.userData = userData;
+    group.hysteresis = 0.15f;
+    group.holdFrames = 30;
+    group.submission = DRAW_SUBMIT_BATCHED;
+    group.candidate = DRAW_SUBMIT_BATCHED;
+
+    for (int i = 0; i < DRAW_SUBMIT_COUNT; i++)
+    {
+        group.supported[i] = true;
+        group.correction[i] = 1.0f;
+    }
+
+    glGenQueries(2 * DRAW_COST_QUERIES, &group.queries[0][0]);
+
+    return group;
+}
+
+// Unload draw group timestamp queries
+void UnloadDrawGroup(DrawGroup* group)
+{
+    glDeleteQueries(2 * DRAW_COST_QUERIES, &group->queries[0][0]);
+}
+
+// Set whether a submission path can be used (e.g. indirect draws need OpenGL 4.0)
+void SetDrawGroupSupported(DrawGroup* group, int submission, bool supported)
+{
+    group->supported[submission] = supported;
+}
+
+// Get calibrated cost of a path (seconds)
+double GetDrawCost(DrawCost cost, int instances)
+{
+    double cpu = cost.cpuFixed + cost.cpuPerInstance * instances;
+    double gpu = cost.gpuFixed + cost.gpuPerInstance * instances;
+
+    return (cpu > gpu) ? cpu : gpu;
+}
+
+// Get predicted cost of a path, calibrated cost corrected by measurements (seconds)
+double GetDrawCostPrediction(DrawGroup* group, int submission, int instances)
+{
+    return GetDrawCost(group->costs[submission], instances) * group->correction[submission];
+}
+
+// Fit cost = fixed + perInstance * instances by least squares, both clamped to positive
+void FitDrawCost(const int* instances, const double* times, int count, float* fixed, float* perInstance)
+{
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        meanX += instances[i];
+        meanY += times[i];
+    }
+    meanX /= count;
+    meanY /= count;
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        covariance += (instances[i] - meanX) * (times[i] - meanY);
+        variance += (instances[i] - meanX) * (instances[i] - meanX);
+    }
+
+    double slope = (variance > 0.0) ? covariance / variance : 0.0;
+    if (slope < 0.0)
+        slope = 0.0;
+
+    double intercept = meanY - slope * meanX;
+    if (intercept < 0.0)
+        intercept = 0.0;
+
+    *fixed = (float)intercept;
+    *perInstance = (float)slope;
+}
+
+// Draw the group once with the GPU idle before and after, waits for the timestamps
+void MeasureDrawGroup(DrawGroup* group, int submission, int instances, double* cpuTime, double* gpuTime)
+{
+    rlDrawRenderBatchActive();
+    glFinish();
+
+    glQueryCounter(group->queries[0][0], GL_TIMESTAMP);
+    double start = GetTime();
+
+    group->draw(submission, instances, group->userData);
+    rlDrawRenderBatchActive();
+
+    *cpuTime = GetTime() - start;
+    glQueryCounter(group->queries[0][1], GL_TIMESTAMP);
+
+    GLuint64 begin = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(group->queries[0][0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(group->queries[0][1], GL_QUERY_RESULT, &end);
+    *gpuTime = (double)(end - begin) * 1e-9;
+}
+
+// Calibrate every supported path with up to maxInstances instances, draws to the current target
+// NOTE: Call once between BeginDrawing() and EndDrawing(), instance data must be uploaded for every path
+void CalibrateDrawGroup(DrawGroup* group, int maxInstances)
+{
+    double start = GetTime();
+
+    for (int submission = 0; submission < DRAW_SUBMIT_COUNT; submission++)
+    {
+        if (!group->supported[submission])
+            continue;
+
+        int instances[DRAW_COST_CALIBRATION_RUNS] = { 0 };
+        double cpuTimes[DRAW_COST_CALIBRATION_RUNS] = { 0 };
+        double gpuTimes[DRAW_COST_CALIBRATION_RUNS] = { 0 };
+
+        // Warm up (shader and buffer first use)
+        double cpuTime = 0.0;
+        double gpuTime = 0.0;
+        MeasureDrawGroup(group, submission, maxInstances, &cpuTime, &gpuTime);
+
+        for (int run = 0; run < DRAW_COST_CALIBRATION_RUNS; run++)
+        {
+            instances[run] = maxInstances >> (2 * (DRAW_COST_CALIBRATION_RUNS - 1 - run));
+            if (instances[run] < 1)
+                instances[run] = 1;
+
+            cpuTimes[run] = 1e9;
+            gpuTimes[run] = 1e9;
+            for (int repeat = 0; repeat < DRAW_COST_CALIBRATION_REPEATS; repeat++)
+            {
+                MeasureDrawGroup(group, submission, instances[run], &cpuTime, &gpuTime);
+                if (cpuTime < cpuTimes[run])
+                    cpuTimes[run] = cpuTime;
+                if (gpuTime < gpuTimes[run])
+                    gpuTimes[run] = gpuTime;
+            }
+        }
+
+        DrawCost* cost = &group->costs[submission];
+        FitDrawCost(instances, cpuTimes, DRAW_COST_CALIBRATION_RUNS, &cost->cpuFixed, &cost->cpuPerInstance);
+        FitDrawCost(instances, gpuTimes, DRAW_COST_CALIBRATION_RUNS, &cost->gpuFixed, &cost->gpuPerInstance);
+        group->correction[submission] = 1.0f;
+
+        TraceLog(LOG_INFO, "COST: [%s] %s: cpu %.1f us + %.1f ns/instance, gpu %.1f us + %.1f ns/instance", group->name, drawSubmissionText[submission],
+            cost->cpuFixed * 1e6f, cost->cpuPerInstance * 1e9f, cost->gpuFixed * 1e6f, cost->gpuPerInstance * 1e9f);
+    }
+
+    TraceLog(LOG_INFO, "COST: [%s] Calibrated in %.1f ms (%i instances)", group->name, (GetTime() - start) * 1000.0, maxInstances);
+}
+
+// Read finished timestamp queries, measured cost corrects the prediction of the path that was drawn
+void ReadDrawGroupQueries(DrawGroup* group)
+{
+    for (int i = 1; i <= DRAW_COST_QUERIES; i++)
+    {
+        // Oldest query first
+        int index = (group->queryIndex + i) % DRAW_COST_QUERIES;
+        if (!group->queryPending[index])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(group->queries[index][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(group->queries[index][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(group->queries[index][1], GL_QUERY_RESULT, &end);
+        group->queryPending[index] = false;
+
+        group->stats.cpuTime = group->queryCpuTime[index];
+        group->stats.gpuTime = (double)(end - begin) * 1e-9;
+
+        int submission = group->querySubmission[index];
+        double calibrated = GetDrawCost(group->costs[submission], group->queryInstances[index]);
+        if ((calibrated > 0.0) && (group->queryInstances[index] > 0))
+        {
+            double measured = (group->stats.cpuTime > group->stats.gpuTime) ? group->stats.cpuTime : group->stats.gpuTime;
+            float ratio = (float)(measured / calibrated);
+            if (ratio < 0.25f)
+                ratio = 0.25f;
+            if (ratio > 4.0f)
+                ratio = 4.0f;
+
+            group->correction[submission] = 0.9f * group->correction[submission] + 0.1f * ratio;
+        }
+    }
+}
+
+// Select submission path for a number of instances, call once per frame before uploading instance data
+int UpdateDrawGroup(DrawGroup* group, int instances)
+{
+    ReadDrawGroupQueries(group);
+
+    int best = group->submission;
+    for (int i = 0; i < DRAW_SUBMIT_COUNT; i++)
+    {
+        group->stats.predicted[i] = group->supported[i] ? GetDrawCostPrediction(group, i, instances) : 0.0;
+        if (group->supported[i] && (group->stats.predicted[i] < group->stats.predicted[best]))
+            best = i;
+    }
+
+    // Cheaper path has to save enough for long enough
+    double current = group->stats.predicted[group->submission];
+    if ((best != group->submission) && (group->stats.predicted[best] < current * (1.0f - group->hysteresis)))
+    {
+        if (best != group->candidate)
+        {
+            group->candidate = best;
+            group->candidateFrames = 0;
+        }
+
+        group->candidateFrames++;
+        if (group->candidateFrames >= group->holdFrames)
+        {
+            TraceLog(LOG_INFO, "COST: [%s] %s -> %s (%i instances, predicted %.3f ms -> %.3f ms)", group->name,
+                drawSubmissionText[group->submission], drawSubmissionText[best], instances, current * 1000.0, group->stats.predicted[best] * 1000.0);
+
+            group->submission = best;
+            group->candidateFrames = 0;
+            group->stats.switches++;
+        }
+    }
+    else
+    {
+        group->candidate = group->submission;
+        group->candidateFrames = 0;
+    }
+
+    group->stats.submission = group->submission;
+    group->stats.instances = instances;
+
+    return group->submission;
+}
+
+// Draw group instances with the selected path, CPU and GPU time of the draw are measured
+void DrawGroupInstances(DrawGroup* group, int instances)
+{
+    rlDrawRenderBatchActive();
+
+    int index = group->queryIndex;
+    bool measure = !group->queryPending[index];
+    if (measure)
+        glQueryCounter(group->queries[index][0], GL_TIMESTAMP);
+
+    double start = GetTime();
+
+    group->draw(group->submission, instances, group->userData);
+    rlDrawRenderBatchActive();
+
+    if (measure)
+    {
+        group->queryCpuTime[index] = GetTime() - start;
+        glQueryCounter(group->queries[index][1], GL_TIMESTAMP);
+        group->querySubmission[index] = group->submission;
+        group->queryInstances[index] = instances;
+        group->queryPending[index] = true;
+        group->queryIndex = (index + 1) % DRAW_COST_QUERIES;
+    }
+}
+
+#endif // DRAW_COST_MODEL_H
@@ -0,0 +1,461 @@
+#ifndef DRAW_QUEUE_H
+#define DRAW_QUEUE_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// Required for: offsetof()
+#include <stddef.h>
+
+// Required for: memset()
+#include <string.h>
+
+// Sort key layout, most significant bits first:
+//   layer (8) | shader (12) | texture (12) | mesh (12) | depth (20)
+// Sprites have no mesh, their submission order takes both mesh and depth bits (32)
+// Draws in lower layers are drawn first, inside a layer draws are grouped by state
+// NOTE: Draws in the same layer may be reordered between different states,
+// use layers when drawing order matters (e.g. UI over sprites)
+#define DRAW_QUEUE_LAYER_SHIFT 56
+#define DRAW_QUEUE_SHADER_SHIFT 44
+#define DRAW_QUEUE_TEXTURE_SHIFT 32
+#define DRAW_QUEUE_MESH_SHIFT 20
+#define DRAW_QUEUE_ID_MASK 0xfff
+#define DRAW_QUEUE_DEPTH_MASK 0xfffff
+#define DRAW_QUEUE_ORDER_MASK 0xffffffffu
+
+// Far distance of quantized mesh depth (world units)
+#ifndef DRAW_QUEUE_MAX_DEPTH
+#define DRAW_QUEUE_MAX_DEPTH 1000.0f
+#endif
+
+// Queued draw types
+typedef enum QueuedDrawType {
+    QUEUED_SPRITE = 0,
+    QUEUED_MESH
+} QueuedDrawType;
+
+// Sprite instance record, textured rectangle at scale 1 (2 x vec4)
+typedef struct SpriteInstance {
+    Vector2 position;   // Top-left corner of the sprite
+    Color tint;         // Sprite tint
+    float unused;
+    Rectangle source;   // Rectangle in texture (pixels)
+} SpriteInstance;
+
+// Queued draw, merged with its neighbours after sorting when state matches
+typedef struct QueuedDraw {
+    int type;               // QueuedDrawType
+    unsigned int shaderId;  // Shader used to draw
+    unsigned int textureId; // Sprite texture or mesh diffuse texture
+
+    SpriteInstance sprite;  // Sprite instance data
+
+    Mesh* mesh;             // Mesh (owned by the model)
+    Material* material;     // Mesh material (owned by the model)
+    Color tint;             // Mesh tint
+    Matrix transform;       // Mesh transform
+} QueuedDraw;
+
+// Draw queue statistics for last flush
+typedef struct DrawQueueStats {
+    int draws;              // Queued draws
+    int drawCalls;          // Draw calls issued after merging
+    double sortTime;        // Radix sort time (seconds)
+} DrawQueueStats;
+
+// Deferred draw queue, draws are sorted by key and merged into instanced draws
+typedef struct DrawQueue {
+    QueuedDraw* draws;          // Queued draws, in submission order
+    unsigned long long* keys;   // Sort keys
+    unsigned int* order;        // Draw indices, sorted by key
+    unsigned long long* sortKeys;   // Radix sort scratch keys
+    unsigned int* sortOrder;        // Radix sort scratch indices
+    int count;                  // Number of queued draws
+    int capacity;               // Queue capacity, grows when full
+
+    int layer;                  // Layer of next queued draws
+    Vector3 viewPosition;       // Mesh depth origin
+    Shader meshShader;          // Instancing shader for merged meshes (id 0 draws meshes one by one)
+
+    Shader spriteShader;        // Sprite instancing shader
+    SpriteInstance* sprites;    // Sprite instances, in sorted order
+    int maxSprites;             // Sprite instance buffer capacity
+    unsigned int vaoId;         // Vertex array (unit quad + sprite instances)
+    unsigned int quadVboId;     // Unit quad vertex buffer
+    unsigned int instanceVboId; // Sprite instances buffer
+
+    Matrix* transforms;         // Merged mesh transforms
+    int maxTransforms;          // Merged mesh transforms capacity
+
+    DrawQueueStats stats;       // Last flush statistics
+} DrawQueue;
+
+// Set sprite instance attribute pointers, vertex array must be enabled
+void SetDrawQueueSpriteAttributes(DrawQueue* queue)
+{
+    rlEnableVertexBuffer(queue->instanceVboId);
+
+    // sprite position (2 x GL_FLOAT)
+    int positionAttrib = rlGetLocationAttrib(queue->spriteShader.id, "spritePosition");
+    rlEnableVertexAttribute(positionAttrib);
+    rlSetVertexAttribute(positionAttrib, 2, RL_FLOAT, false, sizeof(SpriteInstance), (void*)0);
+    rlSetVertexAttributeDivisor(positionAttrib, 1);
+
+    // sprite tint (4 x GL_UNSIGNED_BYTE)
+    int tintAttrib = rlGetLocationAttrib(queue->spriteShader.id, "spriteTint");
+    rlEnableVertexAttribute(tintAttrib);
+    rlSetVertexAttribute(tintAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, tint));
+    rlSetVertexAttributeDivisor(tintAttrib, 1);
+
+    // sprite source rectangle (4 x GL_FLOAT)
+    int sourceAttrib = rlGetLocationAttrib(queue->spriteShader.id, "spriteSource");
+    rlEnableVertexAttribute(sourceAttrib);
+    rlSetVertexAttribute(sourceAttrib, 4, RL_FLOAT, false, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, source));
+    rlSetVertexAttributeDivisor(sourceAttrib, 1);
+}
+
+// Load draw queue, meshShader is used to merge mesh draws (can be { 0 })
+DrawQueue LoadDrawQueue(int capacity, Shader meshShader)
+{
+    DrawQueue queue = { 0 };
+    queue.capacity = (capacity > 0) ? capacity : 1024;
+    queue.draws = (QueuedDraw*)RL_CALLOC(queue.capacity, sizeof(QueuedDraw));
+    queue.keys = (unsigned long long*)RL_CALLOC(queue.capacity, sizeof(unsigned long long));
+    queue.order = (unsigned int*)RL_CALLOC(queue.capacity, sizeof(unsigned int));
+    queue.sortKeys = (unsigned long long*)RL_CALLOC(queue.capacity, sizeof(unsigned long long));
+    queue.sortOrder = (unsigned int*)RL_CALLOC(queue.capacity, sizeof(unsigned int));
+    queue.meshShader = meshShader;
+
+    queue.spriteShader = LoadShader("resources/shaders/sprites_instanced.vs", NULL);
+    queue.maxSprites = queue.capacity;
+    queue.sprites = (SpriteInstance*)RL_CALLOC(queue.maxSprites, sizeof(SpriteInstance));
+
+    // Unit quad, two triangles
+    float quad[12] = {
+        0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f
+    };
+
+    queue.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(queue.vaoId);
+
+    queue.quadVboId = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    int cornerAttrib = rlGetLocationAttrib(queue.spriteShader.id, "vertexPosition");
+    rlSetVertexAttribute(cornerAttrib, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(cornerAttrib);
+
+    queue.instanceVboId = rlLoadVertexBuffer(NULL, queue.maxSprites * sizeof(SpriteInstance), true);
+    SetDrawQueueSpriteAttributes(&queue);
+
+    rlDisableVertexArray();
+
+    return queue;
+}
+
+// Unload draw queue (mesh shader is not unloaded)
+void UnloadDrawQueue(DrawQueue* queue)
+{
+    RL_FREE(queue->draws);
+    RL_FREE(queue->keys);
+    RL_FREE(queue->order);
+    RL_FREE(queue->sortKeys);
+    RL_FREE(queue->sortOrder);
+    RL_FREE(queue->sprites);
+    RL_FREE(queue->transforms);
+
+    rlUnloadVertexBuffer(queue->quadVboId);
+    rlUnloadVertexBuffer(queue->instanceVboId);
+    rlUnloadVertexArray(queue->vaoId);
+    UnloadShader(queue->spriteShader);
+}
+
+// Build sort key from draw state
+unsigned long long GetDrawQueueKey(int layer, unsigned int shaderId, unsigned int textureId, unsigned int meshId, unsigned int depth)
+{
+    return ((unsigned long long)(layer & 0xff) << DRAW_QUEUE_LAYER_SHIFT) |
+        ((unsigned long long)(shaderId & DRAW_QUEUE_ID_MASK) << DRAW_QUEUE_SHADER_SHIFT) |
+        ((unsigned long long)(textureId & DRAW_QUEUE_ID_MASK) << DRAW_QUEUE_TEXTURE_SHIFT) |
+        ((unsigned long long)(meshId & DRAW_QUEUE_ID_MASK) << DRAW_QUEUE_MESH_SHIFT) |
+        (unsigned long long)(depth & DRAW_QUEUE_DEPTH_MASK);
+}
+
+// Sort indices by 64-bit keys, LSD radix sort with 8-bit digits
+// NOTE: Stable, digits shared by every key are skipped
+void SortDrawQueueKeys(unsigned long long* keys, unsigned int* order, unsigned long long* scratchKeys, unsigned int* scratchOrder, int count)
+{
+    unsigned long long* srcKeys = keys;
+    unsigned int* srcOrder = order;
+    unsigned long long* dstKeys = scratchKeys;
+    unsigned int* dstOrder = scratchOrder;
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        int histogram[256] = { 0 };
+        for (int i = 0; i < count; i++)
+            histogram[(srcKeys[i] >> shift) & 0xff]++;
+
+        // Skip digit when all keys fall in one bucket
+        if (histogram[(srcKeys[0] >> shift) & 0xff] == count)
+            continue;
+
+        int offset = 0;
+        for (int d = 0; d < 256; d++)
+        {
+            int bucketSize = histogram[d];
+            histogram[d] = offset;
+            offset += bucketSize;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            int dst = histogram[(srcKeys[i] >> shift) & 0xff]++;
+            dstKeys[dst] = srcKeys[i];
+            dstOrder[dst] = srcOrder[i];
+        }
+
+        unsigned long long* tmpKeys = srcKeys;
+        srcKeys = dstKeys;
+        dstKeys = tmpKeys;
+        unsigned int* tmpOrder = srcOrder;
+        srcOrder = dstOrder;
+        dstOrder = tmpOrder;
+    }
+
+    // Sorted data ended in scratch buffers after an odd number of passes
+    if (srcKeys != keys)
+    {
+        memcpy(keys, srcKeys, count * sizeof(unsigned long long));
+        memcpy(order, srcOrder, count * sizeof(unsigned int));
+    }
+}
+
+// Start queuing draws, depth of meshes is measured from view position
+void BeginDrawQueue(DrawQueue* queue, Vector3 viewPosition)
+{
+    queue->count = 0;
+    queue->layer = 0;
+    queue->viewPosition = viewPosition;
+}
+
+// Set layer of next queued draws (0..255)
+void SetDrawQueueLayer(DrawQueue* queue, int layer)
+{
+    queue->layer = layer;
+}
+
+// Get next free draw, queue storage grows when full
+QueuedDraw* PushDrawQueue(DrawQueue* queue, unsigned long long key)
+{
+    if (queue->count >= queue->capacity)
+    {
+        int capacity = queue->capacity * 2;
+        queue->draws = (QueuedDraw*)RL_REALLOC(queue->draws, capacity * sizeof(QueuedDraw));
+        queue->keys = (unsigned long long*)RL_REALLOC(queue->keys, capacity * sizeof(unsigned long long));
+        queue->order = (unsigned int*)RL_REALLOC(queue->order, capacity * sizeof(unsigned int));
+        queue->sortKeys = (unsigned long long*)RL_REALLOC(queue->sortKeys, capacity * sizeof(unsigned long long));
+        queue->sortOrder = (unsigned int*)RL_REALLOC(queue->sortOrder, capacity * sizeof(unsigned int));
+        queue->capacity = capacity;
+    }
+
+    queue->keys[queue->count] = key;
+    queue->order[queue->count] = queue->count;
+
+    QueuedDraw* draw = &queue->draws[queue->count++];
+    memset(draw, 0, sizeof(QueuedDraw));
+
+    return draw;
+}
+
+// Queue a part of a texture, same as DrawTextureRec()
+void QueueTextureRec(DrawQueue* queue, Texture2D texture, Rectangle source, Vector2 position, Color tint)
+{
+    // Submission order replaces mesh and depth, sprites sharing a texture keep their order
+    unsigned long long key = GetDrawQueueKey(queue->layer, queue->spriteShader.id, texture.id, 0, 0) |
+        ((unsigned long long)queue->count & DRAW_QUEUE_ORDER_MASK);
+
+    QueuedDraw* draw = PushDrawQueue(queue, key);
+    draw->type = QUEUED_SPRITE;
+    draw->shaderId = queue->spriteShader.id;
+    draw->textureId = texture.id;
+    draw->sprite = (SpriteInstance) { position, tint, 0.0f, source };
+}
+
+// Queue a texture, same as DrawTexture()
+void QueueTexture(DrawQueue* queue, Texture2D texture, int posX, int posY, Color tint)
+{
+    Rectangle source = { 0.0f, 0.0f, (float)texture.width, (float)texture.height };
+    QueueTextureRec(queue, texture, source, (Vector2) { (float)posX, (float)posY }, tint);
+}
+
+// Queue all meshes of a model, same as DrawModel()
+void QueueModel(DrawQueue* queue, Model model, Vector3 position, float scale, Color tint)
+{
+    Matrix matScale = MatrixScale(scale, scale, scale);
+    Matrix matTranslation = MatrixTranslate(position.x, position.y, position.z);
+    Matrix transform = MatrixMultiply(model.transform, MatrixMultiply(matScale, matTranslation));
+
+    // Front-to-back inside a state, quantized over [0, DRAW_QUEUE_MAX_DEPTH]
+    Vector3 translation = { transform.m12, transform.m13, transform.m14 };
+    float distance = Vector3Distance(translation, queue->viewPosition) / DRAW_QUEUE_MAX_DEPTH;
+    unsigned int depth = (unsigned int)(Clamp(distance, 0.0f, 1.0f) * DRAW_QUEUE_DEPTH_MASK);
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        Material* material = &model.materials[model.meshMaterial[i]];
+        unsigned int textureId = material->maps[MATERIAL_MAP_DIFFUSE].texture.id;
+        unsigned int shaderId = (queue->meshShader.id != 0) ? queue->meshShader.id : material->shader.id;
+
+        QueuedDraw* draw = PushDrawQueue(queue, GetDrawQueueKey(queue->layer, shaderId, textureId, model.meshes[i].vaoId, depth));
+        draw->type = QUEUED_MESH;
+        draw->shaderId = shaderId;
+        draw->textureId = textureId;
+        draw->mesh = &model.meshes[i];
+        draw->material = material;
+        draw->tint = tint;
+        draw->transform = transform;
+    }
+}
+
+// Check if two queued draws can be drawn by the same instanced draw
+bool CanMergeQueuedDraws(const QueuedDraw* a, const QueuedDraw* b)
+{
+    if ((a->type != b->type) || (a->shaderId != b->shaderId) || (a->textureId != b->textureId))
+        return false;
+
+    if (a->type == QUEUED_MESH)
+    {
+        return (a->mesh->vaoId == b->mesh->vaoId) && (a->material == b->material) &&
+            (ColorToInt(a->tint) == ColorToInt(b->tint));
+    }
+
+    return true;
+}
+
+// Draw a run of sprites sharing a texture with one instanced draw
+void DrawQueuedSprites(DrawQueue* queue, int first, int count)
+{
+    if (count > queue->maxSprites)
+    {
+        RL_FREE(queue->sprites);
+        queue->maxSprites = count;
+        queue->sprites = (SpriteInstance*)RL_CALLOC(queue->maxSprites, sizeof(SpriteInstance));
+
+        rlUnloadVertexBuffer(queue->instanceVboId);
+        rlEnableVertexArray(queue->vaoId);
+        queue->instanceVboId = rlLoadVertexBuffer(NULL, queue->maxSprites * sizeof(SpriteInstance), true);
+        SetDrawQueueSpriteAttributes(queue);
+        rlDisableVertexArray();
+    }
+
+    for (int i = 0; i < count; i++)
+        queue->sprites[i] = queue->draws[queue->order[first + i]].sprite;
+
+    rlUpdateVertexBuffer(queue->instanceVboId, queue->sprites, count * sizeof(SpriteInstance), 0);
+
+    rlEnableShader(queue->spriteShader.id);
+
+    Matrix matMVP = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+    rlSetUniformMatrix(queue->spriteShader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(queue->spriteShader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(queue->draws[queue->order[first]].textureId);
+
+    rlEnableVertexArray(queue->vaoId);
+    rlDrawVertexArrayInstanced(0, 6, count);
+    rlDisableVertexArray();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Draw a run of meshes sharing mesh, material and tint
+void DrawQueuedMeshes(DrawQueue* queue, int first, int count)
+{
+    const QueuedDraw* draw = &queue->draws[queue->order[first]];
+
+    Material material = *draw->material;
+    Color color = material.maps[MATERIAL_MAP_DIFFUSE].color;
+    Color tint = draw->tint;
+
+    // Tint material color the same way DrawModelEx() does
+    Color colorTinted = WHITE;
+    colorTinted.r = (unsigned char)((((float)color.r / 255.0) * ((float)tint.r / 255.0)) * 255.0f);
+    colorTinted.g = (unsigned char)((((float)color.g / 255.0) * ((float)tint.g / 255.0)) * 255.0f);
+    colorTinted.b = (unsigned char)((((float)color.b / 255.0) * ((float)tint.b / 255.0)) * 255.0f);
+    colorTinted.a = (unsigned char)((((float)color.a / 255.0) * ((float)tint.a / 255.0)) * 255.0f);
+    material.maps[MATERIAL_MAP_DIFFUSE].color = colorTinted;
+
+    if ((queue->meshShader.id != 0) && (count > 1))
+    {
+        if (count > queue->maxTransforms)
+        {
+            queue->maxTransforms = count;
+            queue->transforms = (Matrix*)RL_REALLOC(queue->transforms, count * sizeof(Matrix));
+        }
+
+        for (int i = 0; i < count; i++)
+            queue->transforms[i] = queue->draws[queue->order[first + i]].transform;
+
+        material.shader = queue->meshShader;
+        DrawMeshInstanced(*draw->mesh, material, queue->transforms, count);
+        queue->stats.drawCalls++;
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+            DrawMesh(*draw->mesh, material, queue->draws[queue->order[first + i]].transform);
+        queue->stats.drawCalls += count;
+    }
+
+    // Material maps are shared with the model
+    material.maps[MATERIAL_MAP_DIFFUSE].color = color;
+}
+
+// Sort queued draws and draw them, adjacent draws sharing state are merged
+// NOTE: Current rlgl transform is applied to all draws, as with immediate draws
+void EndDrawQueue(DrawQueue* queue)
+{
+    queue->stats = (DrawQueueStats) { 0 };
+    queue->stats.draws = queue->count;
+
+    if (queue->count == 0)
+        return;
+
+    // Flush pending batched draws first, queued draws go over them
+    rlDrawRenderBatchActive();
+
+    double sortStart = GetTime();
+    SortDrawQueueKeys(queue->keys, queue->order, queue->sortKeys, queue->sortOrder, queue->count);
+    queue->stats.sortTime = GetTime() - sortStart;
+
+    int first = 0;
+    while (first < queue->count)
+    {
+        const QueuedDraw* draw = &queue->draws[queue->order[first]];
+
+        int last = first + 1;
+        while ((last < queue->count) && CanMergeQueuedDraws(draw, &queue->draws[queue->order[last]]))
+            last++;
+
+        if (draw->type == QUEUED_SPRITE)
+        {
+            DrawQueuedSprites(queue, first, last - first);
+            queue->stats.drawCalls++;
+        }
+        else
+        {
+            DrawQueuedMeshes(queue, first, last - first);
+        }
+
+        first = last;
+    }
+
+    queue->count = 0;
+}
+
+#endif // DRAW_QUEUE_H
@@ -0,0 +1,263 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "input_replay.h"
+
+// Required for: sqrtf()
+#include <math.h>
+
+// Timer queries in flight, results are read a few frames late to never wait on the GPU
+#ifndef DYNAMIC_RESOLUTION_QUERIES
+#define DYNAMIC_RESOLUTION_QUERIES 4
+#endif
+
+// Render scale is applied in steps, a decision is logged when the step changes
+#ifndef DYNAMIC_RESOLUTION_STEPS
+#define DYNAMIC_RESOLUTION_STEPS 64
+#endif
+
+// Key switching dynamic resolution on and off in the examples
+#ifndef DYNAMIC_RESOLUTION_TOGGLE_KEY
+#define DYNAMIC_RESOLUTION_TOGGLE_KEY KEY_F2
+#endif
+
+// Dynamic resolution stats, times are from the last measured frame (seconds)
+typedef struct DynamicResolutionStats {
+    double cpuTime;         // Scene submit time between Begin/End
+    double gpuTime;         // Scene GPU time (timer query)
+    int decisions;          // Render scale changes (total)
+    int cpuBoundFrames;     // Frames over target that held the scale because submit was slower than the GPU (total)
+} DynamicResolutionStats;
+
+// Scene rendered to an offscreen target at a scale adjusted to hold a GPU frame time
+// NOTE: Target is allocated at maxScale, lower scales only use a smaller viewport of it.
+// Scale is driven by a PID controller on the relative GPU time error, acting on the
+// rendered pixel count (scale^2) since fill cost is proportional to it. A frame over target
+// whose CPU submit time exceeds its GPU time holds the scale, fewer pixels would not shorten it
+typedef struct DynamicResolution {
+    RenderTexture2D target;
+    int screenWidth;        // Window size the target was allocated for
+    int screenHeight;
+    int renderWidth;        // Viewport size used by last Begin
+    int renderHeight;
+
+    float scale;            // Render scale for next frame
+    float minScale;
+    float maxScale;
+    float targetTime;       // GPU frame time to hold (seconds)
+    float kp;               // Controller gains
+    float ki;
+    float kd;
+    float integral;         // Controller state
+    float lastError;
+    bool enabled;           // Disabled renders straight to the window (still measured)
+
+    unsigned int queries[DYNAMIC_RESOLUTION_QUERIES];
+    bool queryPending[DYNAMIC_RESOLUTION_QUERIES];
+    int queryIndex;
+    double submitStart;
+
+    DynamicResolutionStats stats;
+} DynamicResolution;
+
+// Load dynamic resolution for current window size, targetTime in seconds
+// NOTE: Loaded disabled, enabled with SetDynamicResolutionEnabled() or UpdateDynamicResolutionToggle()
+DynamicResolution LoadDynamicResolution(float targetTime, float minScale, float maxScale)
+{
+    DynamicResolution resolution = { 0 };
+    resolution.scale = maxScale;
+    resolution.minScale = minScale;
+    resolution.maxScale = maxScale;
+    resolution.targetTime = targetTime;
+    resolution.kp = 0.4f;
+    resolution.ki = 0.05f;
+    resolution.kd = 0.1f;
+
+    glGenQueries(DYNAMIC_RESOLUTION_QUERIES, resolution.queries);
+
+    return resolution;
+}
+
+// Unload render target and timer queries
+void UnloadDynamicResolution(DynamicResolution* resolution)
+{
+    if (resolution->target.id > 0)
+        UnloadRenderTexture(resolution->target);
+
+    glDeleteQueries(DYNAMIC_RESOLUTION_QUERIES, resolution->queries);
+}
+
+// Enable or disable dynamic resolution, controller restarts from full scale
+void SetDynamicResolutionEnabled(DynamicResolution* resolution, bool enabled)
+{
+    resolution->enabled = enabled;
+    resolution->scale = resolution->maxScale;
+    resolution->integral = 0.0f;
+    resolution->lastError = 0.0f;
+}
+
+// Read finished timer queries, latest result is kept
+bool ReadDynamicResolutionQueries(DynamicResolution* resolution)
+{
+    bool measured = false;
+
+    for (int i = 1; i <= DYNAMIC_RESOLUTION_QUERIES; i++)
+    {
+        // Oldest query first
+        int index = (resolution->queryIndex + i) % DYNAMIC_RESOLUTION_QUERIES;
+        if (!resolution->queryPending[index])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(resolution->queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(resolution->queries[index], GL_QUERY_RESULT, &elapsed);
+        resolution->queryPending[index] = false;
+        resolution->stats.gpuTime = (double)elapsed * 1e-9;
+        measured = true;
+    }
+
+    return measured;
+}
+
+// Update render scale from last measured GPU time
+void UpdateDynamicResolutionScale(DynamicResolution* resolution)
+{
+    float error = ((float)resolution->stats.gpuTime - resolution->targetTime) / resolution->targetTime;
+    float derivative = error - resolution->lastError;
+    resolution->lastError = error;
+
+    // CPU bound frame, a lower scale would only cost image quality
+    if ((error > 0.0f) && (resolution->stats.cpuTime >= resolution->stats.gpuTime))
+    {
+        resolution->stats.cpuBoundFrames++;
+        return;
+    }
+
+    float minArea = resolution->minScale * resolution->minScale;
+    float maxArea = resolution->maxScale * resolution->maxScale;
+    float area = resolution->scale * resolution->scale;
+
+    float output = resolution->kp * error + resolution->ki * (resolution->integral + error) + resolution->kd * derivative;
+    float nextArea = area * (1.0f - output);
+
+    // Integrate only while not saturated (anti windup)
+    if ((nextArea > minArea) && (nextArea < maxArea))
+        resolution->integral += error;
+
+    if (nextArea < minArea)
+        nextArea = minArea;
+    if (nextArea > maxArea)
+        nextArea = maxArea;
+
+    float scale = sqrtf(nextArea);
+
+    // Log decisions that change the rendered resolution step
+    int step = (int)(resolution->scale * DYNAMIC_RESOLUTION_STEPS + 0.5f);
+    int nextStep = (int)(scale * DYNAMIC_RESOLUTION_STEPS + 0.5f);
+    if (step != nextStep)
+    {
+        resolution->stats.decisions++;
+        TraceLog(LOG_INFO, "DRS: Scale %.3f -> %.3f (gpu: %.2f ms, cpu: %.2f ms, target: %.2f ms)",
+            (float)step / DYNAMIC_RESOLUTION_STEPS, (float)nextStep / DYNAMIC_RESOLUTION_STEPS,
+            resolution->stats.gpuTime * 1000.0, resolution->stats.cpuTime * 1000.0, resolution->targetTime * 1000.0f);
+    }
+
+    resolution->scale = scale;
+}
+
+// Begin scene rendering, to the offscreen target if enabled
+// NOTE: Scene is drawn in window coordinates, projection is set so it fills the scaled viewport
+void BeginDynamicResolution(DynamicResolution* resolution)
+{
+    rlDrawRenderBatchActive();
+    resolution->submitStart = GetTime();
+
+    int queryIndex = resolution->queryIndex;
+    if (!resolution->queryPending[queryIndex])
+        glBeginQuery(GL_TIME_ELAPSED, resolution->queries[queryIndex]);
+
+    if (!resolution->enabled)
+        return;
+
+    // Reallocate target on window resize
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    if ((resolution->target.id == 0) || (screenWidth != resolution->screenWidth) || (screenHeight != resolution->screenHeight))
+    {
+        if (resolution->target.id > 0)
+            UnloadRenderTexture(resolution->target);
+
+        resolution->screenWidth = screenWidth;
+        resolution->screenHeight = screenHeight;
+        resolution->target = LoadRenderTexture((int)(screenWidth * resolution->maxScale), (int)(screenHeight * resolution->maxScale));
+        SetTextureFilter(resolution->target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    float scale = (float)(int)(resolution->scale * DYNAMIC_RESOLUTION_STEPS + 0.5f) / DYNAMIC_RESOLUTION_STEPS;
+    resolution->renderWidth = (int)(screenWidth * scale);
+    resolution->renderHeight = (int)(screenHeight * scale);
+
+    BeginTextureMode(resolution->target);
+
+    rlViewport(0, 0, resolution->renderWidth, resolution->renderHeight);
+    rlMatrixMode(RL_PROJECTION);
+    rlLoadIdentity();
+    rlOrtho(0, screenWidth, screenHeight, 0, 0.0f, 1.0f);
+    rlMatrixMode(RL_MODELVIEW);
+    rlLoadIdentity();
+}
+
+// End scene rendering, update render scale and upscale the scene to the window
+void EndDynamicResolution(DynamicResolution* resolution)
+{
+    if (resolution->enabled)
+        EndTextureMode();
+    else
+        rlDrawRenderBatchActive();
+
+    int queryIndex = resolution->queryIndex;
+    if (!resolution->queryPending[queryIndex])
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        resolution->queryPending[queryIndex] = true;
+        resolution->queryIndex = (queryIndex + 1) % DYNAMIC_RESOLUTION_QUERIES;
+    }
+
+    resolution->stats.cpuTime = GetTime() - resolution->submitStart;
+
+    if (ReadDynamicResolutionQueries(resolution) && resolution->enabled)
+        UpdateDynamicResolutionScale(resolution);
+
+    if (!resolution->enabled)
+        return;
+
+    // Scene is in the bottom-left corner of the target, flipped vertically
+    Rectangle source = { 0.0f, 0.0f, (float)resolution->renderWidth, -(float)resolution->renderHeight };
+    Rectangle dest = { 0.0f, 0.0f, (float)resolution->screenWidth, (float)resolution->screenHeight };
+    DrawTexturePro(resolution->target.texture, source, dest, (Vector2) { 0.0f, 0.0f }, 0.0f, WHITE);
+}
+
+// Switch dynamic resolution on and off with DYNAMIC_RESOLUTION_TOGGLE_KEY (recorded by input replays)
+void UpdateDynamicResolutionToggle(DynamicResolution* resolution)
+{
+    if (IsInputKeyPressed(DYNAMIC_RESOLUTION_TOGGLE_KEY))
+        SetDynamicResolutionEnabled(resolution, !resolution->enabled);
+}
+
+// Draw dynamic resolution state and last measured times, call after EndDynamicResolution()
+void DrawDynamicResolutionStats(const DynamicResolution* resolution, int posX, int posY)
+{
+    DrawText(TextFormat("dynamic resolution: %i, scale: %.2f, gpu: %.2f ms, cpu: %.2f ms, decisions: %i, cpu bound: %i",
+                 resolution->enabled, resolution->scale, resolution->stats.gpuTime * 1000.0, resolution->stats.cpuTime * 1000.0,
+                 resolution->stats.decisions, resolution->stats.cpuBoundFrames),
+        posX, posY, 14, MAROON);
+}
+
+#endif // DYNAMIC_RESOLUTION_H
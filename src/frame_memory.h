@@ -0,0 +1,251 @@
+#ifndef FRAME_MEMORY_H
+#define FRAME_MEMORY_H
+
+#include "raylib.h"
+
+// Required for: size_t
+#include <stddef.h>
+// Required for: mmap(), mprotect(), madvise(), munmap()
+#include <sys/mman.h>
+// Required for: sysconf()
+#include <unistd.h>
+
+// Allocations are aligned for any vector type
+#define FRAME_ARENA_ALIGNMENT 16
+
+// Frames over which the arena peak use is measured, pages above it are returned after each window
+#ifndef FRAME_ARENA_WINDOW
+#define FRAME_ARENA_WINDOW 120
+#endif
+
+// Per frame linear allocator for transient data (visible lists, sort scratch, LOD buckets...)
+// NOTE: Allocations are only valid until the next ResetFrameArena(), nothing is freed on its own.
+// Address space is reserved once and pages are committed as the frame use grows, pages above
+// the peak of the last window are returned to the system, so resident memory follows actual use
+typedef struct FrameArena {
+    unsigned char* base;    // Reserved address range
+    size_t reserved;        // Bytes reserved
+    size_t committed;       // Bytes committed from base
+    size_t used;            // Bytes allocated this frame
+    size_t peak;            // Largest frame use of current window
+    size_t lastPeak;        // Largest frame use of last window
+    int frame;              // Frames of current window
+} FrameArena;
+
+// Growable instance storage, elements keep their address while the store grows
+// NOTE: Address space for maxCount elements is reserved up front, pages are committed as
+// elements are pushed. GPU capacity grows by doubling with the count, buffers sized from it
+// are reloaded when UpdateInstanceStoreCapacity() returns true, so both limits stay the same
+typedef struct InstanceStore {
+    unsigned char* data;    // First element (stable)
+    int elementSize;        // Element size in bytes
+    int count;              // Elements pushed
+    int maxCount;           // Elements reserved
+    size_t committed;       // Bytes committed from data
+    int gpuCapacity;        // Elements GPU buffers of the store are sized for
+} InstanceStore;
+
+//----------------------------------------------------------------------------------
+// Virtual memory
+//----------------------------------------------------------------------------------
+
+// Get system page size
+size_t GetMemoryPageSize(void)
+{
+    long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? (size_t)size : 4096;
+}
+
+// Round size up to whole pages
+size_t GetMemoryPageBytes(size_t size)
+{
+    size_t page = GetMemoryPageSize();
+    return (size + page - 1) / page * page;
+}
+
+// Reserve address space, no memory is used until pages are committed
+void* ReserveMemory(size_t size)
+{
+    void* address = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (address == MAP_FAILED) ? NULL : address;
+}
+
+// Commit reserved pages for reading and writing, pages use memory once written
+bool CommitMemory(void* address, size_t size)
+{
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+// Return committed pages to the system, the address range stays reserved
+void DecommitMemory(void* address, size_t size)
+{
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+// Release reserved address space
+void ReleaseMemory(void* address, size_t size)
+{
+    munmap(address, size);
+}
+
+//----------------------------------------------------------------------------------
+// Frame arena
+//----------------------------------------------------------------------------------
+
+// Load frame arena, reserveSize is the largest frame use (bytes)
+FrameArena LoadFrameArena(size_t reserveSize)
+{
+    FrameArena arena = { 0 };
+    arena.reserved = GetMemoryPageBytes(reserveSize);
+    arena.base = (unsigned char*)ReserveMemory(arena.reserved);
+
+    if (arena.base == NULL)
+    {
+        TraceLog(LOG_WARNING, "ARENA: Failed to reserve %zu bytes", arena.reserved);
+        arena.reserved = 0;
+    }
+    else
+        TraceLog(LOG_INFO, "ARENA: Frame arena reserved (%zu MB)", arena.reserved >> 20);
+
+    return arena;
+}
+
+// Unload frame arena, every allocation is released
+void UnloadFrameArena(FrameArena* arena)
+{
+    if (arena->base != NULL)
+        ReleaseMemory(arena->base, arena->reserved);
+
+    *arena = (FrameArena) { 0 };
+}
+
+// Allocate transient memory (uninitialized), valid until next reset
+// NOTE: Returns NULL when the reserved size is used up
+void* AllocFrameArena(FrameArena* arena, size_t size)
+{
+    size_t offset = (arena->used + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+    if (offset + size > arena->reserved)
+    {
+        TraceLog(LOG_WARNING, "ARENA: Failed to allocate %zu bytes (%zu of %zu bytes used)", size, arena->used, arena->reserved);
+        return NULL;
+    }
+
+    if (offset + size > arena->committed)
+    {
+        size_t committed = GetMemoryPageBytes(offset + size);
+        if (!CommitMemory(arena->base + arena->committed, committed - arena->committed))
+        {
+            TraceLog(LOG_WARNING, "ARENA: Failed to commit %zu bytes", committed - arena->committed);
+            return NULL;
+        }
+
+        arena->committed = committed;
+    }
+
+    arena->used = offset + size;
+
+    return arena->base + offset;
+}
+
+// Reset frame arena, call once at the start of each frame
+void ResetFrameArena(FrameArena* arena)
+{
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+    arena->used = 0;
+
+    if (++arena->frame < FRAME_ARENA_WINDOW)
+        return;
+
+    // Keep pages for the peak of the window, return the rest
+    size_t keep = GetMemoryPageBytes(arena->peak);
+    if (arena->committed > keep)
+    {
+        DecommitMemory(arena->base + keep, arena->committed - keep);
+        arena->committed = keep;
+    }
+
+    arena->lastPeak = arena->peak;
+    arena->peak = 0;
+    arena->frame = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Instance store
+//----------------------------------------------------------------------------------
+
+// Load instance store with address space for maxCount elements, GPU buffers start at gpuCapacity elements
+InstanceStore LoadInstanceStore(int elementSize, int maxCount, int gpuCapacity)
+{
+    InstanceStore store = { 0 };
+    store.elementSize = elementSize;
+    store.data = (unsigned char*)ReserveMemory(GetMemoryPageBytes((size_t)elementSize * maxCount));
+    store.maxCount = (store.data != NULL) ? maxCount : 0;
+    store.gpuCapacity = (gpuCapacity < store.maxCount) ? gpuCapacity : store.maxCount;
+
+    if (store.data == NULL)
+        TraceLog(LOG_WARNING, "STORE: Failed to reserve %i elements (%i bytes each)", maxCount, elementSize);
+    else
+        TraceLog(LOG_INFO, "STORE: Instance store reserved (%i elements, %zu MB)", maxCount, ((size_t)elementSize * maxCount) >> 20);
+
+    return store;
+}
+
+// Unload instance store
+void UnloadInstanceStore(InstanceStore* store)
+{
+    if (store->data != NULL)
+        ReleaseMemory(store->data, GetMemoryPageBytes((size_t)store->elementSize * store->maxCount));
+
+    *store = (InstanceStore) { 0 };
+}
+
+// Push count elements (uninitialized), returns first new element or NULL when the store is full
+void* PushInstanceStore(InstanceStore* store, int count)
+{
+    if (store->count + count > store->maxCount)
+        return NULL;
+
+    size_t size = (size_t)(store->count + count) * store->elementSize;
+    if (size > store->committed)
+    {
+        size_t committed = GetMemoryPageBytes(size);
+        if (!CommitMemory(store->data + store->committed, committed - store->committed))
+        {
+            TraceLog(LOG_WARNING, "STORE: Failed to commit %zu bytes", committed - store->committed);
+            return NULL;
+        }
+
+        store->committed = committed;
+    }
+
+    unsigned char* first = store->data + (size_t)store->count * store->elementSize;
+    store->count += count;
+
+    return first;
+}
+
+// Remove every element, committed pages are kept for the next pushes
+void ClearInstanceStore(InstanceStore* store)
+{
+    store->count = 0;
+}
+
+// Grow GPU capacity to hold every element, returns true when GPU buffers must be reloaded
+bool UpdateInstanceStoreCapacity(InstanceStore* store)
+{
+    if (store->count <= store->gpuCapacity)
+        return false;
+
+    int capacity = (store->gpuCapacity > 0) ? store->gpuCapacity : 1024;
+    while (capacity < store->count)
+        capacity *= 2;
+    store->gpuCapacity = (capacity < store->maxCount) ? capacity : store->maxCount;
+
+    TraceLog(LOG_INFO, "STORE: GPU capacity grown to %i elements (%i bytes)", store->gpuCapacity, store->gpuCapacity * store->elementSize);
+
+    return true;
+}
+
+#endif // FRAME_MEMORY_H
@@ -0,0 +1,22 @@
+#ifndef HASH_FNV_H
+#define HASH_FNV_H
+
+// FNV-1a offset basis, start value of a new key
+#define HASH_FNV_BASIS 2166136261u
+#define HASH_FNV_PRIME 16777619u
+
+// Hash data into a running FNV-1a key, start from HASH_FNV_BASIS
+// NOTE: Cache keys and hash table slots only, not a cryptographic hash
+unsigned int HashFNV(unsigned int key, const void* data, int size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (int i = 0; i < size; i++)
+    {
+        key ^= bytes[i];
+        key *= HASH_FNV_PRIME;
+    }
+
+    return key;
+}
+
+#endif // HASH_FNV_H
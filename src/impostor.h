@@ -0,0 +1,296 @@
+#ifndef IMPOSTOR_H
+#define IMPOSTOR_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "rlgl_buffer_texture.h"
+#include "hash_fnv.h"
+
+// Required for: memcpy(), strlen()
+#include <string.h>
+
+// Cache file identification
+#define IMPOSTOR_CACHE_MAGIC 0x504d4949 // "IIMP"
+#define IMPOSTOR_CACHE_VERSION 1
+
+// Impostor atlas, a model rendered from frames x frames view directions
+// NOTE: Directions are laid out on an octahedral map of the whole sphere,
+// view (x, y) looks at the model from OctahedralDecode() of the cell center
+typedef struct ImpostorAtlas {
+    Texture2D texture;  // Views atlas, (frames * frameSize)^2 pixels
+    int frames;         // Views per atlas side
+    int frameSize;      // View size in pixels
+    Vector3 center;     // Model bounds center (model space)
+    float radius;       // Model bounding sphere radius
+} ImpostorAtlas;
+
+// Cache file header, followed by the atlas pixel data (RGBA8)
+typedef struct ImpostorCacheHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int key;
+    int frames;
+    int frameSize;
+    Vector3 center;
+    float radius;
+} ImpostorCacheHeader;
+
+// Impostor renderer, camera-facing quads for instances listed by index
+// NOTE: Transforms are stored once in a buffer texture, only indices are uploaded per frame
+typedef struct ImpostorRenderer {
+    Shader shader;                  // Impostor shader
+    rlBufferTexture transforms;     // Instance transforms (4 RGBA32F texels each)
+    int capacity;                   // Number of instances
+
+    unsigned int vaoId;             // Vertex array (unit quad + instance indices)
+    unsigned int quadVboId;         // Unit quad vertex buffer
+    unsigned int indexVboId;        // Instance indices buffer (float)
+    float* indices;                 // Instance indices staging
+} ImpostorRenderer;
+
+// Map octahedral coordinates in [-1, 1] to a direction, y is up
+Vector3 OctahedralDecode(Vector2 p)
+{
+    Vector3 v = { p.x, 1.0f - fabsf(p.x) - fabsf(p.y), p.y };
+
+    // Fold lower hemisphere over the diagonals
+    float t = fmaxf(-v.y, 0.0f);
+    v.x += (v.x >= 0.0f) ? -t : t;
+    v.z += (v.z >= 0.0f) ? -t : t;
+
+    return Vector3Normalize(v);
+}
+
+// Get view direction of an atlas frame, pointing from the model towards the viewer
+Vector3 GetImpostorViewDirection(int x, int y, int frames)
+{
+    Vector2 p = { (x + 0.5f) / frames * 2.0f - 1.0f, (y + 0.5f) / frames * 2.0f - 1.0f };
+    return OctahedralDecode(p);
+}
+
+// Render model views into an atlas image
+Image RenderImpostorAtlas(Model model, int frames, int frameSize, Vector3 center, float radius)
+{
+    int size = frames * frameSize;
+    RenderTexture2D target = LoadRenderTexture(size, size);
+
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+
+    for (int y = 0; y < frames; y++)
+    {
+        for (int x = 0; x < frames; x++)
+        {
+            Vector3 direction = GetImpostorViewDirection(x, y, frames);
+
+            // Same basis as the impostor shader, up falls back to z near the poles
+            Camera3D camera = { 0 };
+            camera.position = Vector3Add(center, Vector3Scale(direction, radius * 3.0f));
+            camera.target = center;
+            camera.up = (fabsf(direction.y) < 0.999f) ? (Vector3) { 0.0f, 1.0f, 0.0f } : (Vector3) { 0.0f, 0.0f, 1.0f };
+            camera.fovy = radius * 2.0f;
+            camera.projection = CAMERA_ORTHOGRAPHIC;
+
+            // NOTE: Viewport origin is bottom-left, matching texture coordinates
+            rlViewport(x * frameSize, y * frameSize, frameSize, frameSize);
+
+            BeginMode3D(camera);
+            DrawModel(model, Vector3Zero(), 1.0f, WHITE);
+            EndMode3D();
+        }
+    }
+
+    EndTextureMode();
+
+    Image image = LoadImageFromTexture(target.texture);
+    UnloadRenderTexture(target);
+
+    return image;
+}
+
+// Load impostor atlas for a model, rendered offscreen at load time
+// NOTE: Atlas is stored in cacheFileName (can be NULL) and reused while
+// sourceFileName and the settings are unchanged
+ImpostorAtlas LoadImpostorAtlas(Model model, const char* sourceFileName, int frames, int frameSize, const char* cacheFileName)
+{
+    ImpostorAtlas atlas = { 0 };
+    atlas.frames = frames;
+    atlas.frameSize = frameSize;
+
+    BoundingBox bounds = GetModelBoundingBox(model);
+    atlas.center = Vector3Scale(Vector3Add(bounds.min, bounds.max), 0.5f);
+    atlas.radius = Vector3Distance(bounds.max, atlas.center);
+
+    int size = frames * frameSize;
+    size_t pixelsSize = (size_t)size * size * 4;
+
+    // Cache key
+    unsigned int key = HASH_FNV_BASIS;
+    int settings[2] = { frames, frameSize };
+    long modTime = GetFileModTime(sourceFileName);
+    key = HashFNV(key, settings, sizeof(settings));
+    key = HashFNV(key, sourceFileName, strlen(sourceFileName));
+    key = HashFNV(key, &modTime, sizeof(modTime));
+
+    // Try rendered atlas from cache
+    if ((cacheFileName != NULL) && FileExists(cacheFileName))
+    {
+        unsigned int dataSize = 0;
+        unsigned char* data = LoadFileData(cacheFileName, &dataSize);
+
+        ImpostorCacheHeader header = { 0 };
+        if ((data != NULL) && (dataSize >= sizeof(header)))
+            memcpy(&header, data, sizeof(header));
+
+        if ((header.magic == IMPOSTOR_CACHE_MAGIC) && (header.version == IMPOSTOR_CACHE_VERSION)
+            && (header.key == key) && (header.frames == frames) && (header.frameSize == frameSize)
+            && (dataSize == sizeof(header) + pixelsSize))
+        {
+            Image image = { data + sizeof(header), size, size, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            atlas.texture = LoadTextureFromImage(image);
+            UnloadFileData(data);
+
+            GenTextureMipmaps(&atlas.texture);
+            SetTextureFilter(atlas.texture, TEXTURE_FILTER_TRILINEAR);
+
+            TraceLog(LOG_INFO, "IMPOSTOR: Atlas loaded from cache: %s", cacheFileName);
+            return atlas;
+        }
+
+        UnloadFileData(data);
+        TraceLog(LOG_INFO, "IMPOSTOR: Cache %s is out of date, rendering atlas again", cacheFileName);
+    }
+
+    Image image = RenderImpostorAtlas(model, frames, frameSize, atlas.center, atlas.radius);
+    atlas.texture = LoadTextureFromImage(image);
+
+    // Store rendered atlas
+    if (cacheFileName != NULL)
+    {
+        ImpostorCacheHeader header = { IMPOSTOR_CACHE_MAGIC, IMPOSTOR_CACHE_VERSION, key, frames, frameSize, atlas.center, atlas.radius };
+
+        unsigned char* data = (unsigned char*)RL_MALLOC(sizeof(header) + pixelsSize);
+        memcpy(data, &header, sizeof(header));
+        memcpy(data + sizeof(header), image.data, pixelsSize);
+        SaveFileData(cacheFileName, data, sizeof(header) + pixelsSize);
+        RL_FREE(data);
+    }
+
+    UnloadImage(image);
+
+    GenTextureMipmaps(&atlas.texture);
+    SetTextureFilter(atlas.texture, TEXTURE_FILTER_TRILINEAR);
+
+    TraceLog(LOG_INFO, "IMPOSTOR: Atlas rendered (%i x %i views of %i pixels)", frames, frames, frameSize);
+
+    return atlas;
+}
+
+// Unload impostor atlas
+void UnloadImpostorAtlas(ImpostorAtlas atlas)
+{
+    UnloadTexture(atlas.texture);
+}
+
+// Load impostor renderer for a static set of instance transforms
+ImpostorRenderer LoadImpostorRenderer(const Matrix* transforms, int count)
+{
+    ImpostorRenderer renderer = { 0 };
+    renderer.shader = LoadShader("resources/shaders/impostor.vs", "resources/shaders/impostor.fs");
+    renderer.capacity = count;
+    renderer.indices = (float*)RL_CALLOC(count, sizeof(float));
+
+    float16* data = (float16*)RL_MALLOC(count * sizeof(float16));
+    for (int i = 0; i < count; i++)
+        data[i] = MatrixToFloatV(transforms[i]);
+    renderer.transforms = rlLoadBufferTexture(data, count * sizeof(float16), RL_BUFFER_TEXTURE_RGBA32F, false);
+    RL_FREE(data);
+
+    // Unit quad corners in [-1, 1], two triangles
+    float quad[12] = {
+        -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f,
+        -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f
+    };
+
+    renderer.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(renderer.vaoId);
+
+    renderer.quadVboId = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    int cornerAttrib = rlGetLocationAttrib(renderer.shader.id, "vertexPosition");
+    rlSetVertexAttribute(cornerAttrib, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(cornerAttrib);
+
+    // instance index (1 x GL_FLOAT, exact up to 2^24 instances)
+    renderer.indexVboId = rlLoadVertexBuffer(NULL, count * sizeof(float), true);
+    int indexAttrib = rlGetLocationAttrib(renderer.shader.id, "instanceIndex");
+    rlEnableVertexAttribute(indexAttrib);
+    rlSetVertexAttribute(indexAttrib, 1, RL_FLOAT, false, 0, 0);
+    rlSetVertexAttributeDivisor(indexAttrib, 1);
+
+    rlDisableVertexArray();
+
+    return renderer;
+}
+
+// Unload impostor renderer
+void UnloadImpostorRenderer(ImpostorRenderer* renderer)
+{
+    RL_FREE(renderer->indices);
+
+    rlUnloadBufferTexture(renderer->transforms);
+    rlUnloadVertexBuffer(renderer->quadVboId);
+    rlUnloadVertexBuffer(renderer->indexVboId);
+    rlUnloadVertexArray(renderer->vaoId);
+    UnloadShader(renderer->shader);
+}
+
+// Draw impostors of the listed instances
+// NOTE: Impostors fade in between fadeStart and fadeEnd distances from viewPosition (fadeStart == fadeEnd disables the crossfade),
+// viewPosition is given in the same space as the instance transforms
+void DrawImpostors(ImpostorRenderer* renderer, ImpostorAtlas atlas, const unsigned int* indices, int count, Vector3 viewPosition, float fadeStart, float fadeEnd)
+{
+    if (count > renderer->capacity)
+        count = renderer->capacity;
+    if (count <= 0)
+        return;
+
+    for (int i = 0; i < count; i++)
+        renderer->indices[i] = (float)indices[i];
+    rlUpdateVertexBuffer(renderer->indexVboId, renderer->indices, count * sizeof(float), 0);
+
+    // Flush pending batched draws first
+    rlDrawRenderBatchActive();
+
+    Shader shader = renderer->shader;
+    rlEnableShader(shader.id);
+
+    Matrix matMVP = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    int transformsSlot = 1;
+    float fade[2] = { fadeStart, fadeEnd };
+    rlSetUniform(rlGetLocationUniform(shader.id, "transforms"), &transformsSlot, SHADER_UNIFORM_INT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "viewPosition"), &viewPosition, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "impostorCenter"), &atlas.center, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "impostorRadius"), &atlas.radius, SHADER_UNIFORM_FLOAT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "frames"), &atlas.frames, SHADER_UNIFORM_INT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "fadeRange"), fade, SHADER_UNIFORM_VEC2, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(atlas.texture.id);
+    rlEnableBufferTexture(renderer->transforms, transformsSlot);
+
+    rlEnableVertexArray(renderer->vaoId);
+    rlDrawVertexArrayInstanced(0, 6, count);
+    rlDisableVertexArray();
+
+    rlDisableBufferTexture(transformsSlot);
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+#endif // IMPOSTOR_H
@@ -0,0 +1,328 @@
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#include "raylib.h"
+
+// Required for: time()
+#include <time.h>
+// Required for: strcmp()
+#include <string.h>
+
+// Log file identification
+#define INPUT_REPLAY_MAGIC 0x504c5052 // "RPLP"
+#define INPUT_REPLAY_VERSION 2
+
+// Keys stored in the log, camera keys and every mode key of the examples (draw paths, toggles),
+// so a replay switches paths on the same frames as the recording. Other keys are read live
+#define INPUT_REPLAY_KEY_COUNT 32
+
+static const int inputReplayKeys[INPUT_REPLAY_KEY_COUNT] = {
+    KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, KEY_LEFT_SHIFT, KEY_LEFT_CONTROL,
+    KEY_ZERO, KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE, KEY_SIX, KEY_SEVEN, KEY_EIGHT, KEY_NINE,
+    KEY_O, KEY_N, KEY_M, KEY_U, KEY_Q, KEY_C, KEY_P, KEY_V, KEY_R, KEY_F2, KEY_F3,
+    KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT
+};
+
+typedef enum {
+    INPUT_LIVE = 0,         // Read input from the window, frame time as measured
+    INPUT_RECORD,           // Read input from the window and log it, fixed frame time
+    INPUT_REPLAY,           // Read input from the log, fixed frame time
+} InputMode;
+
+// Input of one frame (24 bytes)
+typedef struct InputRecord {
+    unsigned int keys;      // Stored keys down, bit i is inputReplayKeys[i]
+    unsigned int buttons;   // Mouse buttons down
+    float wheel;            // Mouse wheel move
+    Vector2 mousePosition;
+    float frameTime;        // Measured frame time while recording (seconds)
+} InputRecord;
+
+// Log file header, followed by the frames input
+typedef struct InputReplayHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int seed;      // Random seed set at load
+    float frameTime;        // Fixed frame time of the simulation
+    int screenWidth;        // Window size while recording
+    int screenHeight;
+    InputRecord start;      // Input at load, previous input of the first frame
+    int frameCount;
+} InputReplayHeader;
+
+// Input source of the examples, camera movement and spawn loops read input through it
+// NOTE: Record and replay set the same random seed and step the simulation with a fixed
+// frame time, a replay reproduces the recorded camera path and spawn sequence exactly.
+// Examples take "--record <file>", "--replay <file>" and "--headless" (hidden window)
+typedef struct InputReplay {
+    InputMode mode;
+    const char* fileName;
+    bool headless;
+    unsigned int seed;
+    float frameTime;        // Fixed frame time (record and replay)
+
+    InputRecord* records;
+    int count;              // Frames recorded or loaded
+    int capacity;
+    int frame;              // Current frame
+    bool finished;          // Replay reached the end of the log
+
+    InputRecord start;      // Input at load
+    InputRecord current;
+    InputRecord previous;
+    double replayTime;      // Measured time of all replayed frames (seconds)
+} InputReplay;
+
+// Input source read by the Get/IsInput* functions, live input if NULL
+static InputReplay* activeInputReplay = NULL;
+
+// Capture window input of this frame
+InputRecord GetLiveInputRecord(void)
+{
+    InputRecord record = { 0 };
+    for (int i = 0; i < INPUT_REPLAY_KEY_COUNT; i++)
+    {
+        if (IsKeyDown(inputReplayKeys[i]))
+            record.keys |= 1u << i;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (IsMouseButtonDown(i))
+            record.buttons |= 1u << i;
+    }
+
+    record.wheel = GetMouseWheelMove();
+    record.mousePosition = GetMousePosition();
+    record.frameTime = GetFrameTime();
+
+    return record;
+}
+
+// Load input source from program arguments, call after InitWindow()
+InputReplay* LoadInputReplay(int argc, char** argv, float frameTime)
+{
+    InputReplay* input = (InputReplay*)RL_CALLOC(1, sizeof(InputReplay));
+    input->frameTime = frameTime;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc))
+        {
+            input->mode = INPUT_RECORD;
+            input->fileName = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+        {
+            input->mode = INPUT_REPLAY;
+            input->fileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--headless") == 0)
+            input->headless = true;
+    }
+
+    if (input->mode == INPUT_RECORD)
+    {
+        input->seed = (unsigned int)time(NULL);
+        SetRandomSeed(input->seed);
+
+        TraceLog(LOG_INFO, "REPLAY: Recording input to %s (seed: %u, frame time: %.2f ms)", input->fileName, input->seed, frameTime * 1000.0f);
+    }
+    else if (input->mode == INPUT_REPLAY)
+    {
+        unsigned int dataSize = 0;
+        unsigned char* data = LoadFileData(input->fileName, &dataSize);
+
+        InputReplayHeader header = { 0 };
+        if ((data != NULL) && (dataSize >= sizeof(header)))
+            memcpy(&header, data, sizeof(header));
+
+        if ((header.magic == INPUT_REPLAY_MAGIC) && (header.version == INPUT_REPLAY_VERSION)
+            && (dataSize == sizeof(header) + header.frameCount * sizeof(InputRecord)))
+        {
+            input->seed = header.seed;
+            input->start = header.start;
+            input->frameTime = header.frameTime;
+            input->count = header.frameCount;
+            input->capacity = header.frameCount;
+            input->records = (InputRecord*)RL_MALLOC(header.frameCount * sizeof(InputRecord));
+            memcpy(input->records, data + sizeof(header), header.frameCount * sizeof(InputRecord));
+
+            // Same random sequence and window size as the recording
+            SetRandomSeed(input->seed);
+            SetWindowSize(header.screenWidth, header.screenHeight);
+
+            TraceLog(LOG_INFO, "REPLAY: Replaying %i frames from %s (seed: %u)", input->count, input->fileName, input->seed);
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "REPLAY: Failed to load input log %s, using live input", input->fileName);
+            input->mode = INPUT_LIVE;
+        }
+
+        UnloadFileData(data);
+    }
+
+    if (input->mode != INPUT_REPLAY)
+        input->start = GetLiveInputRecord();
+    input->current = input->start;
+
+    if (input->headless)
+        SetWindowState(FLAG_WINDOW_HIDDEN);
+
+    activeInputReplay = input;
+
+    return input;
+}
+
+// Unload input source, a recording is saved to its log file
+void UnloadInputReplay(InputReplay* input)
+{
+    if ((input->mode == INPUT_RECORD) && (input->fileName != NULL))
+    {
+        InputReplayHeader header = { INPUT_REPLAY_MAGIC, INPUT_REPLAY_VERSION, input->seed, input->frameTime, GetScreenWidth(), GetScreenHeight(), input->start, input->count };
+
+        unsigned int dataSize = sizeof(header) + input->count * sizeof(InputRecord);
+        unsigned char* data = (unsigned char*)RL_MALLOC(dataSize);
+        memcpy(data, &header, sizeof(header));
+        memcpy(data + sizeof(header), input->records, input->count * sizeof(InputRecord));
+        SaveFileData(input->fileName, data, dataSize);
+        RL_FREE(data);
+
+        TraceLog(LOG_INFO, "REPLAY: Recorded %i frames to %s", input->count, input->fileName);
+    }
+
+    if (activeInputReplay == input)
+        activeInputReplay = NULL;
+
+    RL_FREE(input->records);
+    RL_FREE(input);
+}
+
+// Advance input to next frame, call once at the start of each frame update
+void UpdateInputReplay(InputReplay* input)
+{
+    input->previous = input->current;
+
+    if (input->mode == INPUT_REPLAY)
+    {
+        if (input->frame > 0)
+            input->replayTime += GetFrameTime();
+
+        if (input->frame >= input->count)
+        {
+            if (!input->finished)
+                TraceLog(LOG_INFO, "REPLAY: Finished %i frames, average frame: %.3f ms", input->count, input->replayTime * 1000.0 / (input->count > 1 ? input->count - 1 : 1));
+
+            input->finished = true;
+            input->current = (InputRecord) { 0 };
+            input->current.mousePosition = input->previous.mousePosition;
+            return;
+        }
+
+        input->current = input->records[input->frame];
+    }
+    else
+    {
+        input->current = GetLiveInputRecord();
+
+        if (input->mode == INPUT_RECORD)
+        {
+            if (input->count == input->capacity)
+            {
+                input->capacity = (input->capacity > 0) ? input->capacity * 2 : 1024;
+                input->records = (InputRecord*)RL_REALLOC(input->records, input->capacity * sizeof(InputRecord));
+            }
+
+            input->records[input->count++] = input->current;
+        }
+    }
+
+    input->frame++;
+}
+
+// Check if input replay ended (examples close after it)
+bool IsInputReplayFinished(void)
+{
+    return (activeInputReplay != NULL) && activeInputReplay->finished;
+}
+
+// Get key bit in the log, -1 for keys read live
+int GetInputReplayKeyIndex(int key)
+{
+    for (int i = 0; i < INPUT_REPLAY_KEY_COUNT; i++)
+    {
+        if (inputReplayKeys[i] == key)
+            return i;
+    }
+
+    return -1;
+}
+
+// Check if a key is being pressed
+bool IsInputKeyDown(int key)
+{
+    int index = GetInputReplayKeyIndex(key);
+    if ((activeInputReplay == NULL) || (index < 0))
+        return IsKeyDown(key);
+
+    return (activeInputReplay->current.keys & (1u << index)) != 0;
+}
+
+// Check if a key has been pressed this frame
+bool IsInputKeyPressed(int key)
+{
+    int index = GetInputReplayKeyIndex(key);
+    if ((activeInputReplay == NULL) || (index < 0))
+        return IsKeyPressed(key);
+
+    return IsInputKeyDown(key) && !(activeInputReplay->previous.keys & (1u << index));
+}
+
+// Check if a key has been released this frame
+bool IsInputKeyReleased(int key)
+{
+    int index = GetInputReplayKeyIndex(key);
+    if ((activeInputReplay == NULL) || (index < 0))
+        return IsKeyReleased(key);
+
+    return !IsInputKeyDown(key) && (activeInputReplay->previous.keys & (1u << index));
+}
+
+// Check if a mouse button is being pressed
+bool IsInputMouseButtonDown(int button)
+{
+    if (activeInputReplay == NULL)
+        return IsMouseButtonDown(button);
+
+    return (activeInputReplay->current.buttons & (1u << button)) != 0;
+}
+
+// Get mouse position
+Vector2 GetInputMousePosition(void)
+{
+    if (activeInputReplay == NULL)
+        return GetMousePosition();
+
+    return activeInputReplay->current.mousePosition;
+}
+
+// Get mouse wheel move
+float GetInputMouseWheelMove(void)
+{
+    if (activeInputReplay == NULL)
+        return GetMouseWheelMove();
+
+    return activeInputReplay->current.wheel;
+}
+
+// Get simulation frame time, fixed while recording or replaying
+float GetInputFrameTime(void)
+{
+    if ((activeInputReplay == NULL) || (activeInputReplay->mode == INPUT_LIVE))
+        return GetFrameTime();
+
+    return activeInputReplay->frameTime;
+}
+
+#endif // INPUT_REPLAY_H
@@ -0,0 +1,537 @@
+#ifndef INSTANCE_PASSES_H
+#define INSTANCE_PASSES_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "model_instanced.h"
+#include "visibility_cache.h"
+
+// Required for: qsort()
+#include <stdlib.h>
+
+// Required for: memcpy()
+#include <string.h>
+
+// Instances per chunk, chunks are the culling unit of every pass
+#ifndef INSTANCE_CHUNK_SIZE
+#define INSTANCE_CHUNK_SIZE 256
+#endif
+
+// Maximum shadow cascades (lightMatrices array size in instanced.fs)
+#define SHADOW_MAX_CASCADES 4
+
+// Instances sorted into spatially coherent chunks
+// NOTE: Instances are sorted once along a Morton curve of their positions, so the instances
+// of a chunk are close to each other and a pass culls whole chunks. Visible chunks become
+// ranges of the instance buffer, every pass draws from the same buffer and uploads nothing
+typedef struct InstanceChunks {
+    int instanceCount;
+    int chunkCount;
+    Vector4* spheres;       // Chunk bounds (center, radius)
+} InstanceChunks;
+
+// Instance ranges drawn by a pass, adjacent visible chunks are merged
+typedef struct InstanceRanges {
+    int* offsets;
+    int* counts;
+    int count;              // Number of ranges
+    int capacity;
+    int instances;          // Instances in all ranges
+} InstanceRanges;
+
+// Cascaded shadow map, cascades are tiles side by side in one depth texture
+typedef struct ShadowCascades {
+    unsigned int fboId;
+    Texture2D depth;
+    int cascadeCount;
+    int size;                                   // Cascade tile size (pixels)
+    Vector3 lightDirection;                     // Direction light travels (normalized)
+    float splits[SHADOW_MAX_CASCADES + 1];      // Cascade view distances
+    Matrix lightView[SHADOW_MAX_CASCADES];
+    Matrix lightProjection[SHADOW_MAX_CASCADES];
+
+    int lightMatrixLocs[SHADOW_MAX_CASCADES];   // Receiver shader locations, set by SetShadowCascadesShader()
+    int cascadeCountLoc;
+    int shadowMapLoc;
+
+    Matrix savedModelview;                      // State restored by EndShadowCascade()
+    Matrix savedProjection;
+    int savedViewport[4];
+} ShadowCascades;
+
+// Samples passed counter of a pass, results are read a few frames late without waiting
+typedef struct PassSamples {
+    unsigned int query;
+    bool active;            // Query started by last BeginPassSamples()
+    bool pending;           // Query result not read yet
+    unsigned int samples;   // Samples that passed depth test (latest result)
+} PassSamples;
+
+//----------------------------------------------------------------------------------
+// Instance chunks
+//----------------------------------------------------------------------------------
+
+// Spread the low 10 bits of a value to every third bit
+unsigned int ExpandInstanceChunkBits(unsigned int v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+int CompareInstanceChunkKeys(const void* a, const void* b)
+{
+    unsigned long long ka = *(const unsigned long long*)a;
+    unsigned long long kb = *(const unsigned long long*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// Sort transforms into chunks (transforms are reordered in place), meshBounds is the instanced mesh bounds
+InstanceChunks LoadInstanceChunks(Matrix* transforms, int count, BoundingBox meshBounds)
+{
+    InstanceChunks chunks = { 0 };
+    chunks.instanceCount = count;
+    chunks.chunkCount = (count + INSTANCE_CHUNK_SIZE - 1) / INSTANCE_CHUNK_SIZE;
+    chunks.spheres = (Vector4*)RL_CALLOC(chunks.chunkCount, sizeof(Vector4));
+
+    // Instance bounding spheres (see rockSpheres in asteroids_instanced.c)
+    Vector3 meshCenter = Vector3Scale(Vector3Add(meshBounds.min, meshBounds.max), 0.5f);
+    float meshRadius = Vector3Distance(meshBounds.max, meshCenter);
+
+    Vector4* spheres = (Vector4*)RL_MALLOC(count * sizeof(Vector4));
+    Vector3 min = { 1e30f, 1e30f, 1e30f };
+    Vector3 max = { -1e30f, -1e30f, -1e30f };
+    for (int i = 0; i < count; i++)
+    {
+        Matrix mat = transforms[i];
+        float scale = fmaxf(Vector3Length((Vector3) { mat.m0, mat.m1, mat.m2 }), fmaxf(Vector3Length((Vector3) { mat.m4, mat.m5, mat.m6 }), Vector3Length((Vector3) { mat.m8, mat.m9, mat.m10 })));
+        Vector3 center = Vector3Transform(meshCenter, mat);
+        spheres[i] = (Vector4) { center.x, center.y, center.z, meshRadius * scale };
+
+        min = Vector3Min(min, center);
+        max = Vector3Max(max, center);
+    }
+
+    // Morton code (10 bits per axis) in the high word, instance index in the low word
+    Vector3 extent = Vector3Subtract(max, min);
+    unsigned long long* keys = (unsigned long long*)RL_MALLOC(count * sizeof(unsigned long long));
+    for (int i = 0; i < count; i++)
+    {
+        unsigned int q[3] = { 0 };
+        float p[3] = { spheres[i].x - min.x, spheres[i].y - min.y, spheres[i].z - min.z };
+        float e[3] = { extent.x, extent.y, extent.z };
+        for (int k = 0; k < 3; k++)
+            q[k] = (e[k] > 0.0f) ? (unsigned int)(p[k] / e[k] * 1023.0f) : 0;
+
+        unsigned int code = (ExpandInstanceChunkBits(q[0]) << 2) | (ExpandInstanceChunkBits(q[1]) << 1) | ExpandInstanceChunkBits(q[2]);
+        keys[i] = ((unsigned long long)code << 32) | (unsigned int)i;
+    }
+
+    qsort(keys, count, sizeof(unsigned long long), CompareInstanceChunkKeys);
+
+    Matrix* sorted = (Matrix*)RL_MALLOC(count * sizeof(Matrix));
+    Vector4* sortedSpheres = (Vector4*)RL_MALLOC(count * sizeof(Vector4));
+    for (int i = 0; i < count; i++)
+    {
+        unsigned int index = (unsigned int)keys[i];
+        sorted[i] = transforms[index];
+        sortedSpheres[i] = spheres[index];
+    }
+    memcpy(transforms, sorted, count * sizeof(Matrix));
+
+    // Chunk bounds enclose the spheres of its instances
+    for (int c = 0; c < chunks.chunkCount; c++)
+    {
+        int start = c * INSTANCE_CHUNK_SIZE;
+        int end = (start + INSTANCE_CHUNK_SIZE < count) ? start + INSTANCE_CHUNK_SIZE : count;
+
+        Vector3 chunkMin = { 1e30f, 1e30f, 1e30f };
+        Vector3 chunkMax = { -1e30f, -1e30f, -1e30f };
+        for (int i = start; i < end; i++)
+        {
+            Vector4 s = sortedSpheres[i];
+            chunkMin = Vector3Min(chunkMin, (Vector3) { s.x - s.w, s.y - s.w, s.z - s.w });
+            chunkMax = Vector3Max(chunkMax, (Vector3) { s.x + s.w, s.y + s.w, s.z + s.w });
+        }
+
+        Vector3 center = Vector3Scale(Vector3Add(chunkMin, chunkMax), 0.5f);
+        float radius = 0.0f;
+        for (int i = start; i < end; i++)
+        {
+            Vector4 s = sortedSpheres[i];
+            radius = fmaxf(radius, Vector3Distance(center, (Vector3) { s.x, s.y, s.z }) + s.w);
+        }
+
+        chunks.spheres[c] = (Vector4) { center.x, center.y, center.z, radius };
+    }
+
+    RL_FREE(sorted);
+    RL_FREE(sortedSpheres);
+    RL_FREE(keys);
+    RL_FREE(spheres);
+
+    return chunks;
+}
+
+// Unload instance chunks
+void UnloadInstanceChunks(InstanceChunks* chunks)
+{
+    RL_FREE(chunks->spheres);
+    chunks->spheres = NULL;
+    chunks->chunkCount = 0;
+}
+
+// Get bounding sphere of every chunk
+Vector4 GetInstanceChunksSphere(InstanceChunks chunks)
+{
+    Vector3 min = { 1e30f, 1e30f, 1e30f };
+    Vector3 max = { -1e30f, -1e30f, -1e30f };
+    for (int c = 0; c < chunks.chunkCount; c++)
+    {
+        Vector4 s = chunks.spheres[c];
+        min = Vector3Min(min, (Vector3) { s.x - s.w, s.y - s.w, s.z - s.w });
+        max = Vector3Max(max, (Vector3) { s.x + s.w, s.y + s.w, s.z + s.w });
+    }
+
+    Vector3 center = Vector3Scale(Vector3Add(min, max), 0.5f);
+    float radius = 0.0f;
+    for (int c = 0; c < chunks.chunkCount; c++)
+    {
+        Vector4 s = chunks.spheres[c];
+        radius = fmaxf(radius, Vector3Distance(center, (Vector3) { s.x, s.y, s.z }) + s.w);
+    }
+
+    return (Vector4) { center.x, center.y, center.z, radius };
+}
+
+// Load ranges with capacity for every chunk of a chunk list
+InstanceRanges LoadInstanceRanges(InstanceChunks chunks)
+{
+    InstanceRanges ranges = { 0 };
+    ranges.capacity = chunks.chunkCount;
+    ranges.offsets = (int*)RL_CALLOC(ranges.capacity, sizeof(int));
+    ranges.counts = (int*)RL_CALLOC(ranges.capacity, sizeof(int));
+    return ranges;
+}
+
+// Unload instance ranges
+void UnloadInstanceRanges(InstanceRanges* ranges)
+{
+    RL_FREE(ranges->offsets);
+    RL_FREE(ranges->counts);
+    *ranges = (InstanceRanges) { 0 };
+}
+
+// Cull chunks against a view projection (in the space of the instance transforms)
+void CullInstanceChunks(InstanceChunks chunks, Matrix viewProjection, InstanceRanges* ranges)
+{
+    Vector4 planes[6];
+    GetFrustumPlanes(viewProjection, planes);
+
+    ranges->count = 0;
+    ranges->instances = 0;
+
+    bool previousVisible = false;
+    for (int c = 0; c < chunks.chunkCount; c++)
+    {
+        Vector4 s = chunks.spheres[c];
+        float margin = 0.0f;
+        bool visible = TestFrustumSphere(planes, (Vector3) { s.x, s.y, s.z }, s.w, &margin);
+        if (!visible)
+        {
+            previousVisible = false;
+            continue;
+        }
+
+        int start = c * INSTANCE_CHUNK_SIZE;
+        int count = (start + INSTANCE_CHUNK_SIZE < chunks.instanceCount) ? INSTANCE_CHUNK_SIZE : chunks.instanceCount - start;
+
+        // Extend the previous range when the previous chunk is visible too
+        if (previousVisible)
+        {
+            ranges->counts[ranges->count - 1] += count;
+        }
+        else
+        {
+            ranges->offsets[ranges->count] = start;
+            ranges->counts[ranges->count] = count;
+            ranges->count++;
+        }
+
+        ranges->instances += count;
+        previousVisible = true;
+    }
+}
+
+// Draw instance ranges of a model with a pass shader, shader instance attribute must use the model layout
+void DrawInstancedModelRanges(InstancedModel instanced, Shader shader, InstanceRanges ranges)
+{
+    instanced.shader = shader;
+
+    for (int i = 0; i < ranges.count; i++)
+        DrawInstancedModel(instanced, ranges.offsets[i], ranges.counts[i]);
+}
+
+//----------------------------------------------------------------------------------
+// Pass state
+//----------------------------------------------------------------------------------
+
+// Begin depth prepass, only depth is written
+void BeginDepthPrepass(void)
+{
+    rlDrawRenderBatchActive();
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+}
+
+// End depth prepass
+void EndDepthPrepass(void)
+{
+    rlDrawRenderBatchActive();
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+// Begin color pass over prepass depth, only the nearest surface of each pixel is shaded
+// NOTE: Prepass and color shaders must compute the same position (invariant gl_Position)
+void BeginEqualDepthPass(void)
+{
+    rlDrawRenderBatchActive();
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+}
+
+// End color pass, rlgl depth state is restored
+void EndEqualDepthPass(void)
+{
+    rlDrawRenderBatchActive();
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_TRUE);
+}
+
+// Load samples counter
+PassSamples LoadPassSamples(void)
+{
+    PassSamples counter = { 0 };
+    glGenQueries(1, &counter.query);
+    return counter;
+}
+
+// Unload samples counter
+void UnloadPassSamples(PassSamples* counter)
+{
+    glDeleteQueries(1, &counter->query);
+}
+
+// Begin counting samples, skipped while the previous result is not available
+void BeginPassSamples(PassSamples* counter)
+{
+    if (counter->pending)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(counter->query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            glGetQueryObjectuiv(counter->query, GL_QUERY_RESULT, &counter->samples);
+            counter->pending = false;
+        }
+    }
+
+    rlDrawRenderBatchActive();
+    counter->active = !counter->pending;
+    if (counter->active)
+        glBeginQuery(GL_SAMPLES_PASSED, counter->query);
+}
+
+// End counting samples
+void EndPassSamples(PassSamples* counter)
+{
+    rlDrawRenderBatchActive();
+    if (counter->active)
+    {
+        glEndQuery(GL_SAMPLES_PASSED);
+        counter->active = false;
+        counter->pending = true;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Shadow cascades
+//----------------------------------------------------------------------------------
+
+// Load shadow cascades, depth texture is cascadeCount tiles of size x size
+ShadowCascades LoadShadowCascades(int cascadeCount, int size, Vector3 lightDirection)
+{
+    ShadowCascades shadows = { 0 };
+    shadows.cascadeCount = (cascadeCount < SHADOW_MAX_CASCADES) ? cascadeCount : SHADOW_MAX_CASCADES;
+    shadows.size = size;
+    shadows.lightDirection = Vector3Normalize(lightDirection);
+
+    int width = size * shadows.cascadeCount;
+    shadows.fboId = rlLoadFramebuffer(width, size);
+    shadows.depth.id = rlLoadTextureDepth(width, size, false);
+    shadows.depth.width = width;
+    shadows.depth.height = size;
+    shadows.depth.mipmaps = 1;
+    shadows.depth.format = RL_PIXELFORMAT_UNCOMPRESSED_R32;   // Single channel, rlgl has no depth pixel format
+    rlFramebufferAttach(shadows.fboId, shadows.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+
+    // Depth only framebuffer, no color buffer is read or drawn
+    rlEnableFramebuffer(shadows.fboId);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (rlFramebufferComplete(shadows.fboId))
+        TraceLog(LOG_INFO, "SHADOW: [ID %i] Shadow cascades loaded (%i x %i, %i cascades)", shadows.fboId, width, size, shadows.cascadeCount);
+    else
+        TraceLog(LOG_WARNING, "SHADOW: [ID %i] Shadow cascades framebuffer is not complete", shadows.fboId);
+    rlDisableFramebuffer();
+
+    return shadows;
+}
+
+// Unload shadow cascades framebuffer and depth texture
+void UnloadShadowCascades(ShadowCascades* shadows)
+{
+    rlUnloadTexture(shadows->depth.id);
+    rlUnloadFramebuffer(shadows->fboId);
+}
+
+// Fit cascades to slices of the camera view up to maxDistance, casters is the bounding sphere of every caster
+// NOTE: Slices are split between uniform and logarithmic distances, each cascade covers the
+// bounding sphere of its slice and is snapped to shadow texels so it does not shimmer when the camera moves
+void UpdateShadowCascades(ShadowCascades* shadows, Camera3D camera, float aspect, float maxDistance, Vector4 casters)
+{
+    const float nearDistance = 1.0f;
+    const float lambda = 0.75f;
+
+    shadows->splits[0] = nearDistance;
+    for (int i = 1; i <= shadows->cascadeCount; i++)
+    {
+        float t = (float)i / shadows->cascadeCount;
+        float logSplit = nearDistance * powf(maxDistance / nearDistance, t);
+        float uniformSplit = nearDistance + (maxDistance - nearDistance) * t;
+        shadows->splits[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+    }
+
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    float tanHalfFov = tanf(camera.fovy * 0.5f * DEG2RAD);
+
+    // Light orientation is fixed, only the ortho bounds follow the camera
+    Vector3 lightUp = (fabsf(shadows->lightDirection.y) > 0.99f) ? (Vector3) { 0.0f, 0.0f, 1.0f } : (Vector3) { 0.0f, 1.0f, 0.0f };
+    Matrix lightView = MatrixLookAt(Vector3Negate(shadows->lightDirection), Vector3Zero(), lightUp);
+    Vector3 casterCenter = Vector3Transform((Vector3) { casters.x, casters.y, casters.z }, lightView);
+
+    for (int i = 0; i < shadows->cascadeCount; i++)
+    {
+        // Bounding sphere of the view slice corners
+        Vector3 corners[8];
+        float distances[2] = { shadows->splits[i], shadows->splits[i + 1] };
+        for (int k = 0; k < 8; k++)
+        {
+            float d = distances[k / 4];
+            float x = ((k & 1) ? 1.0f : -1.0f) * d * tanHalfFov * aspect;
+            float y = ((k & 2) ? 1.0f : -1.0f) * d * tanHalfFov;
+            corners[k] = Vector3Add(camera.position, Vector3Add(Vector3Scale(forward, d), Vector3Add(Vector3Scale(right, x), Vector3Scale(up, y))));
+        }
+
+        Vector3 center = Vector3Zero();
+        for (int k = 0; k < 8; k++)
+            center = Vector3Add(center, Vector3Scale(corners[k], 1.0f / 8.0f));
+
+        float radius = 0.0f;
+        for (int k = 0; k < 8; k++)
+            radius = fmaxf(radius, Vector3Distance(center, corners[k]));
+        radius = ceilf(radius * 16.0f) / 16.0f;
+
+        // Snap the slice center to shadow texels in light space
+        Vector3 lightCenter = Vector3Transform(center, lightView);
+        float texel = 2.0f * radius / shadows->size;
+        lightCenter.x = floorf(lightCenter.x / texel) * texel;
+        lightCenter.y = floorf(lightCenter.y / texel) * texel;
+
+        // Depth range covers the slice and every caster between it and the light (view looks down -z)
+        float farPlane = -lightCenter.z + radius;
+        float nearPlane = fminf(-(casterCenter.z + casters.w), farPlane - 2.0f * radius);
+
+        shadows->lightView[i] = lightView;
+        shadows->lightProjection[i] = MatrixOrtho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius, nearPlane, farPlane);
+    }
+}
+
+// Get world to clip space matrix of a cascade, transform is applied first (see rlGetMatrixTransform())
+Matrix GetShadowCascadeMatrix(ShadowCascades shadows, int cascade, Matrix transform)
+{
+    return MatrixMultiply(transform, MatrixMultiply(shadows.lightView[cascade], shadows.lightProjection[cascade]));
+}
+
+// Begin drawing casters to a cascade, light view and projection replace the current matrices
+void BeginShadowCascade(ShadowCascades* shadows, int cascade)
+{
+    rlDrawRenderBatchActive();
+
+    glGetIntegerv(GL_VIEWPORT, shadows->savedViewport);
+    shadows->savedModelview = rlGetMatrixModelview();
+    shadows->savedProjection = rlGetMatrixProjection();
+
+    rlEnableFramebuffer(shadows->fboId);
+    if (cascade == 0)
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+    rlViewport(cascade * shadows->size, 0, shadows->size, shadows->size);
+    rlEnableDepthTest();
+
+    rlSetMatrixProjection(shadows->lightProjection[cascade]);
+    rlSetMatrixModelview(shadows->lightView[cascade]);
+    rlMatrixMode(RL_MODELVIEW);
+}
+
+// End drawing casters to a cascade, matrices and viewport are restored
+void EndShadowCascade(ShadowCascades* shadows)
+{
+    rlDrawRenderBatchActive();
+    rlDisableFramebuffer();
+
+    rlSetMatrixProjection(shadows->savedProjection);
+    rlSetMatrixModelview(shadows->savedModelview);
+    rlViewport(shadows->savedViewport[0], shadows->savedViewport[1], shadows->savedViewport[2], shadows->savedViewport[3]);
+    rlDisableDepthTest();
+}
+
+// Set receiver shader locations of the cascades (SHADER_FEATURE_SHADOW_CASCADES), call once after loading it
+void SetShadowCascadesShader(ShadowCascades* shadows, Shader shader)
+{
+    for (int i = 0; i < SHADOW_MAX_CASCADES; i++)
+        shadows->lightMatrixLocs[i] = GetShaderLocation(shader, TextFormat("lightMatrices[%i]", i));
+
+    shadows->cascadeCountLoc = GetShaderLocation(shader, "cascadeCount");
+    shadows->shadowMapLoc = GetShaderLocation(shader, "shadowMap");
+}
+
+// Bind cascades to the receiver shader, transform is applied to receivers first
+// NOTE: Shader locations are set by SetShadowCascadesShader()
+void EnableShadowCascades(ShadowCascades shadows, Shader shader, Matrix transform, int slot)
+{
+    for (int i = 0; i < shadows.cascadeCount; i++)
+        SetShaderValueMatrix(shader, shadows.lightMatrixLocs[i], GetShadowCascadeMatrix(shadows, i, transform));
+
+    SetShaderValue(shader, shadows.cascadeCountLoc, &shadows.cascadeCount, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, shadows.shadowMapLoc, &slot, SHADER_UNIFORM_INT);
+
+    rlActiveTextureSlot(slot);
+    rlEnableTexture(shadows.depth.id);
+    rlActiveTextureSlot(0);
+}
+
+// Unbind cascades depth texture
+void DisableShadowCascades(int slot)
+{
+    rlActiveTextureSlot(slot);
+    rlDisableTexture();
+    rlActiveTextureSlot(0);
+}
+
+#endif // INSTANCE_PASSES_H
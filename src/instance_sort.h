@@ -0,0 +1,291 @@
+#ifndef INSTANCE_SORT_H
+#define INSTANCE_SORT_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "worker_pool.h"
+
+// Required for: memcpy(), memset()
+#include <string.h>
+
+// Sort keys are depths quantized to 24 bits, sorted 8 bits per pass
+#define SORT_KEY_BITS 24
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX_SIZE (1 << SORT_RADIX_BITS)
+#define SORT_PASSES (SORT_KEY_BITS / SORT_RADIX_BITS)
+
+typedef enum InstanceSortOrder {
+    SORT_UNSORTED = 0,      // Input order (generation or spawn order)
+    SORT_FRONT_TO_BACK,     // Nearest first, opaque meshes (least overdraw)
+    SORT_BACK_TO_FRONT,     // Farthest first, alpha blended sprites
+    SORT_ORDER_COUNT
+} InstanceSortOrder;
+
+static const char* instanceSortOrderText[] = {
+    "UNSORTED",
+    "FRONT_TO_BACK",
+    "BACK_TO_FRONT",
+};
+
+// Work done by every thread on its range
+typedef enum InstanceSortPhase {
+    SORT_PHASE_KEYS,        // Compute depth keys of the input
+    SORT_PHASE_HISTOGRAM,   // Count digits of current pass
+    SORT_PHASE_SCATTER,     // Move keys to their digit offsets
+    SORT_PHASE_PERMUTE,     // Copy records in sorted order
+} InstanceSortPhase;
+
+// Sort timings of the last sort (seconds)
+typedef struct InstanceSortStats {
+    double keyTime;
+    double sortTime;
+    double permuteTime;
+    int passes;             // Radix passes run, passes on a digit shared by every key are skipped
+} InstanceSortStats;
+
+// Multithreaded depth sort of visible instances
+// NOTE: Depth along the view direction is quantized to an order preserving integer key and sorted
+// with a stable LSD radix sort, every thread counts and scatters its own range of each pass.
+// The sorted order is kept, so a frame that skips sorting still permutes current records with it
+typedef struct InstanceSorter {
+    WorkerPool* pool;                       // Sorting threads, main thread included
+
+    // Current sort
+    InstanceSortPhase phase;
+    int shift;                              // Digit of current pass
+    const unsigned char* positions;
+    int positionStride;
+    int positionComponents;
+    const unsigned int* indices;
+    Vector3 viewPosition;
+    Vector3 viewDirection;
+    InstanceSortOrder order;
+
+    // Current permute
+    const unsigned char* records;
+    int recordSize;
+    unsigned char* destination;
+
+    unsigned int* keys[2];                  // Double buffered keys and item indices
+    unsigned int* values[2];
+    int current;                            // Buffer holding the sorted result
+    int count;                              // Items of last sort
+    int capacity;
+
+    unsigned int histograms[WORKER_POOL_MAX_THREADS][SORT_RADIX_SIZE]; // Digit counts, then scatter offsets
+
+    InstanceSortStats stats;
+} InstanceSorter;
+
+// Quantize depth to an order preserving key, float bits with the sign flipped
+unsigned int GetSortKey(float depth, InstanceSortOrder order)
+{
+    union { float f; unsigned int u; } bits = { depth };
+    unsigned int key = (bits.u & 0x80000000u) ? ~bits.u : (bits.u | 0x80000000u);
+
+    // Low mantissa bits are dropped, a relative depth error of 2^-15 does not change draw order
+    key >>= 32 - SORT_KEY_BITS;
+
+    return (order == SORT_BACK_TO_FRONT) ? (~key & ((1u << SORT_KEY_BITS) - 1)) : key;
+}
+
+// Run current phase on the range assigned to a thread
+void RunSortRange(void* data, int index)
+{
+    InstanceSorter* sorter = (InstanceSorter*)data;
+
+    int first = 0;
+    int last = 0;
+    GetWorkerRange(sorter->pool, sorter->count, index, &first, &last);
+
+    unsigned int* keys = sorter->keys[sorter->current];
+    unsigned int* values = sorter->values[sorter->current];
+
+    if (sorter->phase == SORT_PHASE_KEYS)
+    {
+        Vector3 p = sorter->viewPosition;
+        Vector3 d = sorter->viewDirection;
+        for (int i = first; i < last; i++)
+        {
+            unsigned int item = (sorter->indices != NULL) ? sorter->indices[i] : (unsigned int)i;
+            const float* position = (const float*)(sorter->positions + (size_t)item * sorter->positionStride);
+
+            float depth = (position[0] - p.x) * d.x + (position[1] - p.y) * d.y;
+            if (sorter->positionComponents > 2)
+                depth += (position[2] - p.z) * d.z;
+
+            keys[i] = GetSortKey(depth, sorter->order);
+            values[i] = item;
+        }
+    }
+    else if (sorter->phase == SORT_PHASE_HISTOGRAM)
+    {
+        unsigned int* histogram = sorter->histograms[index];
+        memset(histogram, 0, SORT_RADIX_SIZE * sizeof(unsigned int));
+        for (int i = first; i < last; i++)
+            histogram[(keys[i] >> sorter->shift) & (SORT_RADIX_SIZE - 1)]++;
+    }
+    else if (sorter->phase == SORT_PHASE_SCATTER)
+    {
+        unsigned int* offsets = sorter->histograms[index];
+        unsigned int* outKeys = sorter->keys[1 - sorter->current];
+        unsigned int* outValues = sorter->values[1 - sorter->current];
+        for (int i = first; i < last; i++)
+        {
+            unsigned int slot = offsets[(keys[i] >> sorter->shift) & (SORT_RADIX_SIZE - 1)]++;
+            outKeys[slot] = keys[i];
+            outValues[slot] = values[i];
+        }
+    }
+    else
+    {
+        int size = sorter->recordSize;
+        for (int i = first; i < last; i++)
+            memcpy(sorter->destination + (size_t)i * size, sorter->records + (size_t)values[i] * size, size);
+    }
+}
+
+// Run a phase on every thread, returns when all ranges are done
+void RunSortPhase(InstanceSorter* sorter, InstanceSortPhase phase)
+{
+    sorter->phase = phase;
+    RunWorkerPool(sorter->pool, RunSortRange, sorter);
+}
+
+// Load instance sorter, threadCount <= 0 uses every core
+InstanceSorter* LoadInstanceSorter(int threadCount)
+{
+    InstanceSorter* sorter = (InstanceSorter*)RL_CALLOC(1, sizeof(InstanceSorter));
+    sorter->pool = LoadWorkerPool(threadCount);
+
+    TraceLog(LOG_INFO, "SORT: Instance sorter loaded (%i sorting threads)", sorter->pool->threadCount);
+
+    return sorter;
+}
+
+// Stop sorting threads and unload instance sorter
+void UnloadInstanceSorter(InstanceSorter* sorter)
+{
+    UnloadWorkerPool(sorter->pool);
+
+    for (int i = 0; i < 2; i++)
+    {
+        RL_FREE(sorter->keys[i]);
+        RL_FREE(sorter->values[i]);
+    }
+    RL_FREE(sorter);
+}
+
+// Sort items by depth along the view direction, item positions are 2 or 3 floats every positionStride bytes
+// NOTE: indices lists the visible items (NULL sorts items [0, count)), sorted item indices are
+// read with GetSortedInstances(). SORT_UNSORTED keeps the input order
+void SortInstances(InstanceSorter* sorter, const void* positions, int positionStride, int positionComponents,
+    const unsigned int* indices, int count, Vector3 viewPosition, Vector3 viewDirection, InstanceSortOrder order)
+{
+    if (count > sorter->capacity)
+    {
+        sorter->capacity = (count > sorter->capacity * 2) ? count : sorter->capacity * 2;
+        for (int i = 0; i < 2; i++)
+        {
+            sorter->keys[i] = (unsigned int*)RL_REALLOC(sorter->keys[i], sorter->capacity * sizeof(unsigned int));
+            sorter->values[i] = (unsigned int*)RL_REALLOC(sorter->values[i], sorter->capacity * sizeof(unsigned int));
+        }
+    }
+
+    sorter->positions = (const unsigned char*)positions;
+    sorter->positionStride = positionStride;
+    sorter->positionComponents = positionComponents;
+    sorter->indices = indices;
+    sorter->count = count;
+    sorter->viewPosition = viewPosition;
+    sorter->viewDirection = viewDirection;
+    sorter->order = order;
+    sorter->current = 0;
+    sorter->stats.passes = 0;
+
+    double start = GetWorkerTime();
+    RunSortPhase(sorter, SORT_PHASE_KEYS);
+    double keysDone = GetWorkerTime();
+
+    for (int pass = 0; (pass < SORT_PASSES) && (order != SORT_UNSORTED); pass++)
+    {
+        sorter->shift = pass * SORT_RADIX_BITS;
+        RunSortPhase(sorter, SORT_PHASE_HISTOGRAM);
+
+        // Exclusive prefix sum over digits then threads, each thread scatters to its own offsets
+        bool sharedDigit = false;
+        unsigned int offset = 0;
+        for (int digit = 0; digit < SORT_RADIX_SIZE; digit++)
+        {
+            unsigned int digitStart = offset;
+            for (int t = 0; t < sorter->pool->threadCount; t++)
+            {
+                unsigned int digitCount = sorter->histograms[t][digit];
+                sorter->histograms[t][digit] = offset;
+                offset += digitCount;
+            }
+
+            if (offset - digitStart == (unsigned int)count)
+                sharedDigit = true;
+        }
+
+        if (sharedDigit)
+            continue;
+
+        RunSortPhase(sorter, SORT_PHASE_SCATTER);
+        sorter->current = 1 - sorter->current;
+        sorter->stats.passes++;
+    }
+
+    sorter->stats.keyTime = keysDone - start;
+    sorter->stats.sortTime = GetWorkerTime() - keysDone;
+}
+
+// Get sorted item indices of last sort
+const unsigned int* GetSortedInstances(const InstanceSorter* sorter)
+{
+    return sorter->values[sorter->current];
+}
+
+// Copy records in last sorted order, destination[i] is records[sorted[i]]
+// NOTE: Records can change between sorts, the last order is applied to current records
+void PermuteSortedInstances(InstanceSorter* sorter, const void* records, int recordSize, void* destination)
+{
+    double start = GetWorkerTime();
+
+    sorter->records = (const unsigned char*)records;
+    sorter->recordSize = recordSize;
+    sorter->destination = (unsigned char*)destination;
+    RunSortPhase(sorter, SORT_PHASE_PERMUTE);
+
+    sorter->stats.permuteTime = GetWorkerTime() - start;
+}
+
+// Permute records in last sorted order straight into a vertex buffer, previous contents are discarded
+// Returns uploaded bytes
+long long UploadSortedInstances(InstanceSorter* sorter, const void* records, int recordSize, unsigned int vboId)
+{
+    long long size = (long long)sorter->count * recordSize;
+    if (size == 0)
+        return 0;
+
+    rlEnableVertexBuffer(vboId);
+    void* destination = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (destination == NULL)
+    {
+        TraceLog(LOG_WARNING, "SORT: [VBO ID %i] Failed to map instance buffer", vboId);
+        rlDisableVertexBuffer();
+        return 0;
+    }
+
+    PermuteSortedInstances(sorter, records, recordSize, destination);
+
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    rlDisableVertexBuffer();
+
+    return size;
+}
+
+#endif // INSTANCE_SORT_H
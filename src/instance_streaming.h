@@ -0,0 +1,645 @@
+#ifndef INSTANCE_STREAMING_H
+#define INSTANCE_STREAMING_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "model_instanced.h"
+
+// Required for: offsetof()
+#include <stddef.h>
+// Required for: pthread_create(), pthread_mutex_lock(), pthread_cond_wait()
+#include <pthread.h>
+// Required for: fopen(), fread(), fwrite(), snprintf()
+#include <stdio.h>
+// Required for: mkdir()
+#include <sys/stat.h>
+
+// Chunk file identification
+#define STREAM_CHUNK_MAGIC 0x4b484353 // "SCHK"
+#define STREAM_CHUNK_VERSION 1
+
+// Chunk requests in flight between the main thread and the loader
+#ifndef STREAM_MAX_PENDING
+#define STREAM_MAX_PENDING 16
+#endif
+
+// Field description, chunks are generated on first use and stored in directory
+// NOTE: The field is a flat belt around the origin, chunk density falls off across its width
+typedef struct StreamField {
+    char directory[256];        // Chunk files directory
+    float chunkSize;            // Chunk side length
+    int instancesPerChunk;      // Instances of a chunk at full density
+    float beltRadius;           // Belt center line radius
+    float beltWidth;            // Belt width (radial)
+    float beltHeight;           // Belt height
+    unsigned int seed;          // Generation seed
+} StreamField;
+
+// Chunk coordinates, chunk origin is key * chunkSize
+typedef struct StreamChunkKey {
+    int x, y, z;
+} StreamChunkKey;
+
+// Quantized instance, position is relative to the chunk origin (8 bytes)
+typedef struct StreamInstance {
+    unsigned short position[3]; // Position in chunk, [0, 65535] maps to [0, chunkSize]
+    unsigned char scale;        // Uniform scale, [0, 255] maps to [0.05, 0.25]
+    unsigned char rotation;     // Rotation angle, [0, 255] maps to [0, 2*PI]
+} StreamInstance;
+
+// Chunk file header, followed by count instances
+typedef struct StreamChunkHeader {
+    unsigned int magic;
+    unsigned int version;
+    StreamChunkKey key;
+    int count;
+} StreamChunkHeader;
+
+// Pool slot states
+typedef enum StreamSlotState {
+    STREAM_SLOT_FREE = 0,       // Unused
+    STREAM_SLOT_PENDING,        // Chunk requested, waiting for the loader
+    STREAM_SLOT_UPLOADING,      // Chunk loaded, partially uploaded
+    STREAM_SLOT_RESIDENT        // Chunk fully uploaded
+} StreamSlotState;
+
+// GPU pool slot, holds one chunk
+typedef struct StreamSlot {
+    StreamChunkKey key;         // Chunk stored in slot
+    int state;                  // StreamSlotState
+    int count;                  // Chunk instance count
+    int uploadedCount;          // Instances uploaded so far (drawn)
+    StreamInstance* data;       // Loaded instances, freed once uploaded
+    unsigned int lastUsedFrame; // Last frame the chunk was wanted (LRU)
+} StreamSlot;
+
+// Loader request and result, slot is reserved when requesting
+typedef struct StreamChunkJob {
+    StreamChunkKey key;
+    int slot;
+    int count;
+    StreamInstance* data;
+    bool generated;
+} StreamChunkJob;
+
+// Streaming stats
+typedef struct StreamStats {
+    int wanted;                 // Chunks wanted around the camera
+    int resident;               // Chunks drawn (fully or partially uploaded)
+    int pending;                // Chunks waiting for the loader
+    int loaded;                 // Chunks loaded since start
+    int generated;              // Chunks generated (not found on disk) since start
+    int evicted;                // Chunks evicted since start
+    int uploadedBytes;          // Bytes uploaded this frame
+    int drawnInstances;         // Instances drawn this frame
+} StreamStats;
+
+// Instance stream, fixed GPU pool of chunks fed by a background loader thread
+typedef struct InstanceStream {
+    StreamField field;          // Field description
+    Model model;                // Drawn model (not owned)
+    Shader shader;              // Streaming shader
+    int originLoc;              // Shader location: chunkOrigin
+    int chunkSizeLoc;           // Shader location: chunkSize
+
+    StreamSlot* slots;          // Pool slots
+    int slotCount;              // Number of pool slots
+    unsigned int vboId;         // Pool instance buffer (slotCount * instancesPerChunk instances)
+    unsigned int* vaoIds;       // Vertex array per mesh (mesh buffers + pool instances)
+    int uploadBudget;           // Upload bytes allowed per frame
+
+    StreamChunkKey* wanted;     // Chunks wanted this frame, nearest first
+    float* wantedDistances;     // Distances of wanted chunks (sorting)
+    int maxWanted;              // Wanted list capacity
+    unsigned int frame;         // Frame counter (LRU)
+
+    pthread_t thread;           // Loader thread
+    pthread_mutex_t mutex;      // Protects the job queues and running flag
+    pthread_cond_t cond;        // Signals new requests or shutdown
+    bool running;               // Loader thread keeps running while set
+    StreamChunkJob requests[STREAM_MAX_PENDING];    // Requests, nearest first
+    int requestCount;
+    StreamChunkJob completed[STREAM_MAX_PENDING];   // Loaded chunks waiting for the main thread
+    int completedCount;
+    int pendingCount;           // Requests not collected yet (main thread only)
+
+    StreamStats stats;          // Streaming stats
+} InstanceStream;
+
+// Get chunk density in [0, 1], measured at the chunk center
+float GetStreamChunkDensity(StreamField field, StreamChunkKey key)
+{
+    Vector3 center = { (key.x + 0.5f) * field.chunkSize, (key.y + 0.5f) * field.chunkSize, (key.z + 0.5f) * field.chunkSize };
+
+    if (fabsf(center.y) > field.beltHeight * 0.5f)
+        return 0.0f;
+
+    float across = fabsf(sqrtf(center.x * center.x + center.z * center.z) - field.beltRadius) / (field.beltWidth * 0.5f);
+    if (across >= 1.0f)
+        return 0.0f;
+
+    return 1.0f - across * across;
+}
+
+// Get chunk instance count
+int GetStreamChunkCount(StreamField field, StreamChunkKey key)
+{
+    return (int)(field.instancesPerChunk * GetStreamChunkDensity(field, key));
+}
+
+// Get chunk file name
+void GetStreamChunkFileName(StreamField field, StreamChunkKey key, char* fileName, int size)
+{
+    snprintf(fileName, size, "%s/chunk_%i_%i_%i.bin", field.directory, key.x, key.y, key.z);
+}
+
+// Xorshift random generator, rand() is not used from the loader thread
+unsigned int GetStreamRandom(unsigned int* state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Generate chunk instances, same key and seed always give the same chunk
+StreamInstance* GenerateStreamChunk(StreamField field, StreamChunkKey key, int* count)
+{
+    *count = GetStreamChunkCount(field, key);
+    if (*count <= 0)
+        return NULL;
+
+    StreamInstance* instances = (StreamInstance*)RL_MALLOC(*count * sizeof(StreamInstance));
+
+    unsigned int state = field.seed ^ ((unsigned int)key.x * 73856093u) ^ ((unsigned int)key.y * 19349663u) ^ ((unsigned int)key.z * 83492791u);
+    if (state == 0)
+        state = 1;
+
+    for (int i = 0; i < *count; i++)
+    {
+        unsigned int a = GetStreamRandom(&state);
+        unsigned int b = GetStreamRandom(&state);
+        unsigned int c = GetStreamRandom(&state);
+
+        instances[i].position[0] = a & 0xffff;
+        instances[i].position[1] = a >> 16;
+        instances[i].position[2] = b & 0xffff;
+        instances[i].scale = (b >> 16) & 0xff;
+        instances[i].rotation = c & 0xff;
+    }
+
+    return instances;
+}
+
+// Load chunk from disk, generated and saved when missing
+// NOTE: Called from the loader thread, only stdio is used (no raylib logging)
+StreamInstance* LoadStreamChunk(StreamField field, StreamChunkKey key, int* count, bool* generated)
+{
+    char fileName[512] = { 0 };
+    GetStreamChunkFileName(field, key, fileName, sizeof(fileName));
+
+    *generated = false;
+    *count = 0;
+
+    FILE* file = fopen(fileName, "rb");
+    if (file != NULL)
+    {
+        StreamChunkHeader header = { 0 };
+        StreamInstance* instances = NULL;
+
+        bool valid = (fread(&header, sizeof(header), 1, file) == 1) && (header.magic == STREAM_CHUNK_MAGIC) && (header.version == STREAM_CHUNK_VERSION) && (header.count > 0);
+        if (valid)
+        {
+            instances = (StreamInstance*)RL_MALLOC(header.count * sizeof(StreamInstance));
+            valid = (fread(instances, sizeof(StreamInstance), header.count, file) == (size_t)header.count);
+        }
+        fclose(file);
+
+        if (valid)
+        {
+            *count = header.count;
+            return instances;
+        }
+
+        // Invalid or truncated chunk is generated again
+        RL_FREE(instances);
+    }
+
+    StreamInstance* instances = GenerateStreamChunk(field, key, count);
+    *generated = true;
+
+    file = fopen(fileName, "wb");
+    if ((file != NULL) && (instances != NULL))
+    {
+        StreamChunkHeader header = { STREAM_CHUNK_MAGIC, STREAM_CHUNK_VERSION, key, *count };
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(instances, sizeof(StreamInstance), *count, file);
+    }
+    if (file != NULL)
+        fclose(file);
+
+    return instances;
+}
+
+// Loader thread, loads requested chunks in order
+void* StreamLoaderThread(void* arg)
+{
+    InstanceStream* stream = (InstanceStream*)arg;
+
+    pthread_mutex_lock(&stream->mutex);
+    while (stream->running)
+    {
+        if (stream->requestCount == 0)
+        {
+            pthread_cond_wait(&stream->cond, &stream->mutex);
+            continue;
+        }
+
+        // Take the nearest request
+        StreamChunkJob job = stream->requests[0];
+        stream->requestCount--;
+        for (int i = 0; i < stream->requestCount; i++)
+            stream->requests[i] = stream->requests[i + 1];
+
+        pthread_mutex_unlock(&stream->mutex);
+
+        job.data = LoadStreamChunk(stream->field, job.key, &job.count, &job.generated);
+
+        pthread_mutex_lock(&stream->mutex);
+        stream->completed[stream->completedCount++] = job;
+    }
+    pthread_mutex_unlock(&stream->mutex);
+
+    return NULL;
+}
+
+// Set pool instance attributes, starting at a slot
+void SetStreamSlotBase(InstanceStream* stream, int slot)
+{
+    size_t base = (size_t)slot * stream->field.instancesPerChunk * sizeof(StreamInstance);
+
+    rlEnableVertexBuffer(stream->vboId);
+
+    // position (3 x GL_UNSIGNED_SHORT, normalized)
+    rlEnableVertexAttribute(12);
+    rlSetVertexAttribute(12, 3, GL_UNSIGNED_SHORT, true, sizeof(StreamInstance), (void*)base);
+    rlSetVertexAttributeDivisor(12, 1);
+
+    // scale, rotation (2 x GL_UNSIGNED_BYTE, normalized)
+    rlEnableVertexAttribute(13);
+    rlSetVertexAttribute(13, 2, RL_UNSIGNED_BYTE, true, sizeof(StreamInstance), (void*)(base + offsetof(StreamInstance, scale)));
+    rlSetVertexAttributeDivisor(13, 1);
+}
+
+// Load instance stream and start the loader thread
+// NOTE: Chunks are drawn with model meshes, instance attributes use locations 12 and 13
+InstanceStream* LoadInstanceStream(StreamField field, Model model, int slotCount, int uploadBudget, float loadRadius)
+{
+    InstanceStream* stream = (InstanceStream*)RL_CALLOC(1, sizeof(InstanceStream));
+    stream->field = field;
+    stream->model = model;
+    stream->slotCount = slotCount;
+    stream->uploadBudget = uploadBudget;
+
+    stream->shader = LoadShader("resources/shaders/asteroids_streamed.vs", "resources/shaders/asteroids_instanced.fs");
+    stream->shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(stream->shader, "mvp");
+    stream->originLoc = GetShaderLocation(stream->shader, "chunkOrigin");
+    stream->chunkSizeLoc = GetShaderLocation(stream->shader, "chunkSize");
+
+    mkdir(field.directory, 0755);
+
+    stream->slots = (StreamSlot*)RL_CALLOC(slotCount, sizeof(StreamSlot));
+    stream->vboId = rlLoadVertexBuffer(NULL, slotCount * field.instancesPerChunk * sizeof(StreamInstance), true);
+    rlDisableVertexBuffer();
+
+    stream->vaoIds = (unsigned int*)RL_CALLOC(model.meshCount, sizeof(unsigned int));
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        Mesh mesh = model.meshes[i];
+
+        stream->vaoIds[i] = rlLoadVertexArray();
+        rlEnableVertexArray(stream->vaoIds[i]);
+
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_POSITIONS, 0, 3, RL_FLOAT, false);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_TEXCOORDS, 1, 2, RL_FLOAT, false);
+
+        if (mesh.vboId[MESH_BUFFER_INDICES] != 0)
+            rlEnableVertexBufferElement(mesh.vboId[MESH_BUFFER_INDICES]);
+
+        SetStreamSlotBase(stream, 0);
+
+        rlDisableVertexArray();
+    }
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+
+    // Wanted chunks are gathered around two points (position and prefetch position)
+    int side = 2 * (int)ceilf(loadRadius / field.chunkSize) + 1;
+    stream->maxWanted = 2 * side * side * side;
+    stream->wanted = (StreamChunkKey*)RL_CALLOC(stream->maxWanted, sizeof(StreamChunkKey));
+    stream->wantedDistances = (float*)RL_CALLOC(stream->maxWanted, sizeof(float));
+
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    stream->running = true;
+
+    if (pthread_create(&stream->thread, NULL, StreamLoaderThread, stream) != 0)
+    {
+        TraceLog(LOG_WARNING, "STREAM: Failed to start loader thread");
+        stream->running = false;
+    }
+    else
+        TraceLog(LOG_INFO, "STREAM: Pool loaded (%i chunks, %i KB)", slotCount, slotCount * field.instancesPerChunk * (int)sizeof(StreamInstance) / 1024);
+
+    return stream;
+}
+
+// Stop the loader thread and unload instance stream
+void UnloadInstanceStream(InstanceStream* stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    bool started = stream->running;
+    stream->running = false;
+    pthread_cond_signal(&stream->cond);
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (started)
+        pthread_join(stream->thread, NULL);
+
+    for (int i = 0; i < stream->completedCount; i++)
+        RL_FREE(stream->completed[i].data);
+    for (int i = 0; i < stream->slotCount; i++)
+        RL_FREE(stream->slots[i].data);
+
+    pthread_mutex_destroy(&stream->mutex);
+    pthread_cond_destroy(&stream->cond);
+
+    for (int i = 0; i < stream->model.meshCount; i++)
+        rlUnloadVertexArray(stream->vaoIds[i]);
+    rlUnloadVertexBuffer(stream->vboId);
+    UnloadShader(stream->shader);
+
+    RL_FREE(stream->vaoIds);
+    RL_FREE(stream->slots);
+    RL_FREE(stream->wanted);
+    RL_FREE(stream->wantedDistances);
+    RL_FREE(stream);
+}
+
+// Find pool slot holding a chunk, returns -1 if not found
+int FindStreamSlot(InstanceStream* stream, StreamChunkKey key)
+{
+    for (int i = 0; i < stream->slotCount; i++)
+    {
+        StreamSlot* slot = &stream->slots[i];
+        if ((slot->state != STREAM_SLOT_FREE) && (slot->key.x == key.x) && (slot->key.y == key.y) && (slot->key.z == key.z))
+            return i;
+    }
+
+    return -1;
+}
+
+// Add chunks with instances inside a sphere to the wanted list (no duplicates)
+void GatherStreamChunks(InstanceStream* stream, Vector3 center, float radius, Vector3 position)
+{
+    float size = stream->field.chunkSize;
+    int minX = (int)floorf((center.x - radius) / size), maxX = (int)floorf((center.x + radius) / size);
+    int minY = (int)floorf((center.y - radius) / size), maxY = (int)floorf((center.y + radius) / size);
+    int minZ = (int)floorf((center.z - radius) / size), maxZ = (int)floorf((center.z + radius) / size);
+
+    for (int z = minZ; z <= maxZ; z++)
+    {
+        for (int y = minY; y <= maxY; y++)
+        {
+            for (int x = minX; x <= maxX; x++)
+            {
+                StreamChunkKey key = { x, y, z };
+                Vector3 chunkCenter = { (x + 0.5f) * size, (y + 0.5f) * size, (z + 0.5f) * size };
+
+                if ((Vector3Distance(chunkCenter, center) > radius + size * 0.87f) || (GetStreamChunkCount(stream->field, key) <= 0))
+                    continue;
+
+                bool found = false;
+                for (int i = 0; (i < stream->stats.wanted) && !found; i++)
+                    found = (stream->wanted[i].x == x) && (stream->wanted[i].y == y) && (stream->wanted[i].z == z);
+
+                if (!found && (stream->stats.wanted < stream->maxWanted))
+                {
+                    stream->wanted[stream->stats.wanted] = key;
+                    stream->wantedDistances[stream->stats.wanted] = Vector3Distance(chunkCenter, position);
+                    stream->stats.wanted++;
+                }
+            }
+        }
+    }
+}
+
+// Get least recently used slot that is not wanted this frame, returns -1 if none
+int GetStreamEvictionSlot(InstanceStream* stream)
+{
+    int result = -1;
+    for (int i = 0; i < stream->slotCount; i++)
+    {
+        StreamSlot* slot = &stream->slots[i];
+        if (slot->state == STREAM_SLOT_FREE)
+            return i;
+        if ((slot->state == STREAM_SLOT_PENDING) || (slot->lastUsedFrame == stream->frame))
+            continue;
+        if ((result == -1) || (slot->lastUsedFrame < stream->slots[result].lastUsedFrame))
+            result = i;
+    }
+
+    return result;
+}
+
+// Update streaming around the camera, call once per frame before DrawInstanceStream()
+// NOTE: Chunks ahead of the camera (velocity * prefetchTime) are requested too
+void UpdateInstanceStream(InstanceStream* stream, Vector3 position, Vector3 velocity, float loadRadius, float prefetchTime)
+{
+    stream->frame++;
+    stream->stats.wanted = 0;
+    stream->stats.uploadedBytes = 0;
+
+    // Wanted chunks, nearest first
+    GatherStreamChunks(stream, position, loadRadius, position);
+    Vector3 ahead = Vector3Add(position, Vector3Scale(velocity, prefetchTime));
+    if (Vector3Distance(ahead, position) > stream->field.chunkSize * 0.5f)
+        GatherStreamChunks(stream, ahead, loadRadius, position);
+
+    for (int i = 1; i < stream->stats.wanted; i++)
+    {
+        StreamChunkKey key = stream->wanted[i];
+        float distance = stream->wantedDistances[i];
+        int j = i - 1;
+        for (; (j >= 0) && (stream->wantedDistances[j] > distance); j--)
+        {
+            stream->wanted[j + 1] = stream->wanted[j];
+            stream->wantedDistances[j + 1] = stream->wantedDistances[j];
+        }
+        stream->wanted[j + 1] = key;
+        stream->wantedDistances[j + 1] = distance;
+    }
+
+    // Collect loaded chunks
+    pthread_mutex_lock(&stream->mutex);
+    for (int i = 0; i < stream->completedCount; i++)
+    {
+        StreamChunkJob job = stream->completed[i];
+        StreamSlot* slot = &stream->slots[job.slot];
+        slot->data = job.data;
+        slot->count = job.count;
+        slot->uploadedCount = 0;
+        slot->state = STREAM_SLOT_UPLOADING;
+        stream->pendingCount--;
+        stream->stats.loaded++;
+        if (job.generated)
+            stream->stats.generated++;
+    }
+    stream->completedCount = 0;
+
+    // Mark wanted chunks used first, so they are never evicted for another wanted chunk
+    for (int i = 0; i < stream->stats.wanted; i++)
+    {
+        int index = FindStreamSlot(stream, stream->wanted[i]);
+        if (index >= 0)
+            stream->slots[index].lastUsedFrame = stream->frame;
+    }
+
+    // Request missing chunks, nearest first, while the loader has room
+    for (int i = 0; (i < stream->stats.wanted) && (stream->pendingCount < STREAM_MAX_PENDING); i++)
+    {
+        if (FindStreamSlot(stream, stream->wanted[i]) >= 0)
+            continue;
+
+        int index = GetStreamEvictionSlot(stream);
+        if (index < 0)
+            continue;
+
+        StreamSlot* slot = &stream->slots[index];
+        if (slot->state != STREAM_SLOT_FREE)
+            stream->stats.evicted++;
+
+        RL_FREE(slot->data);
+        *slot = (StreamSlot) { .key = stream->wanted[i], .state = STREAM_SLOT_PENDING, .lastUsedFrame = stream->frame };
+
+        stream->requests[stream->requestCount++] = (StreamChunkJob) { .key = stream->wanted[i], .slot = index };
+        stream->pendingCount++;
+    }
+
+    if (stream->requestCount > 0)
+        pthread_cond_signal(&stream->cond);
+    pthread_mutex_unlock(&stream->mutex);
+
+    // Upload loaded chunks within the byte budget, large chunks are spread over several frames
+    for (int i = 0; (i < stream->slotCount) && (stream->stats.uploadedBytes < stream->uploadBudget); i++)
+    {
+        StreamSlot* slot = &stream->slots[i];
+        if ((slot->state != STREAM_SLOT_UPLOADING) || (slot->lastUsedFrame != stream->frame))
+            continue;
+
+        int count = slot->count - slot->uploadedCount;
+        int budget = (stream->uploadBudget - stream->stats.uploadedBytes) / (int)sizeof(StreamInstance);
+        if (count > budget)
+            count = budget;
+
+        if (count > 0)
+        {
+            int offset = i * stream->field.instancesPerChunk + slot->uploadedCount;
+            rlUpdateVertexBuffer(stream->vboId, &slot->data[slot->uploadedCount], count * sizeof(StreamInstance), offset * sizeof(StreamInstance));
+            slot->uploadedCount += count;
+            stream->stats.uploadedBytes += count * sizeof(StreamInstance);
+        }
+
+        if (slot->uploadedCount >= slot->count)
+        {
+            RL_FREE(slot->data);
+            slot->data = NULL;
+            slot->state = STREAM_SLOT_RESIDENT;
+        }
+    }
+}
+
+// Draw wanted chunks, one instanced draw per chunk and mesh, viewPosition is the camera position of the current 3d mode
+// NOTE: Chunks still uploading draw the instances uploaded so far. Chunks are drawn relative to the
+// camera: chunk origins are offset by the camera position in double precision and the view has no
+// translation, so rocks far from the world origin keep their precision. rlgl transform is not applied
+void DrawInstanceStream(InstanceStream* stream, Vector3 viewPosition)
+{
+    // Flush pending batched draws, instances are drawn directly
+    rlDrawRenderBatchActive();
+
+    Shader shader = stream->shader;
+    rlEnableShader(shader.id);
+
+    // View rotation only, camera translation is applied to the chunk origins
+    Matrix view = rlGetMatrixModelview();
+    view.m12 = 0.0f;
+    view.m13 = 0.0f;
+    view.m14 = 0.0f;
+
+    Matrix matMVP = MatrixMultiply(view, rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+    rlSetUniform(stream->chunkSizeLoc, &stream->field.chunkSize, SHADER_UNIFORM_FLOAT, 1);
+
+    stream->stats.resident = 0;
+    stream->stats.pending = stream->pendingCount;
+    stream->stats.drawnInstances = 0;
+
+    for (int i = 0; i < stream->slotCount; i++)
+    {
+        StreamSlot* slot = &stream->slots[i];
+        if ((slot->lastUsedFrame == stream->frame) && (slot->uploadedCount > 0))
+        {
+            stream->stats.resident++;
+            stream->stats.drawnInstances += slot->uploadedCount;
+        }
+    }
+
+    for (int m = 0; m < stream->model.meshCount; m++)
+    {
+        Mesh mesh = stream->model.meshes[m];
+        Material material = stream->model.materials[stream->model.meshMaterial[m]];
+
+        Color color = material.maps[MATERIAL_MAP_DIFFUSE].color;
+        float values[4] = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+        rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], values, SHADER_UNIFORM_VEC4, 1);
+
+        rlActiveTextureSlot(0);
+        rlEnableTexture(material.maps[MATERIAL_MAP_DIFFUSE].texture.id);
+
+        rlEnableVertexArray(stream->vaoIds[m]);
+
+        for (int i = 0; i < stream->slotCount; i++)
+        {
+            StreamSlot* slot = &stream->slots[i];
+            if ((slot->lastUsedFrame != stream->frame) || (slot->uploadedCount == 0))
+                continue;
+
+            double size = stream->field.chunkSize;
+            Vector3 origin = {
+                (float)(slot->key.x * size - viewPosition.x),
+                (float)(slot->key.y * size - viewPosition.y),
+                (float)(slot->key.z * size - viewPosition.z)
+            };
+            rlSetUniform(stream->originLoc, &origin, SHADER_UNIFORM_VEC3, 1);
+
+            SetStreamSlotBase(stream, i);
+            if (mesh.indices != NULL)
+                rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, 0, slot->uploadedCount);
+            else
+                rlDrawVertexArrayInstanced(0, mesh.vertexCount, slot->uploadedCount);
+        }
+
+        rlDisableTexture();
+    }
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableShader();
+}
+
+#endif // INSTANCE_STREAMING_H
@@ -11,12 +11,191 @@
 #include "raymath.h"
 #include "rlgl.h"
 #include "camera_first_person.h"
+#include "draw_queue.h"
+#include "dynamic_resolution.h"
+#include "frame_memory.h"
+#include "impostor.h"
+#include "instance_passes.h"
+#include "instance_sort.h"
+#include "mesh_quantize.h"
+#include "model_instanced.h"
+#include "multi_view.h"
+#include "occlusion_culling.h"
+#include "orbital_motion.h"
+#include "shader_variants.h"
+#include "vertex_pulling.h"
+#include "visibility_cache.h"
 
 // Required for: calloc(), free()
 #include <stdlib.h>
 
-int main(void)
+// Required for: memcpy(), strcmp()
+#include <string.h>
+
+// Required for: FLT_MAX
+#include <float.h>
+
+// Asteroid count, build with -DASTEROID_COUNT=1000000 to compare draw paths at 1M rocks
+#ifndef ASTEROID_COUNT
+#define ASTEROID_COUNT 50000
+#endif
+
+// Rocks further than this distance are drawn as impostors,
+// inside the fade band both are drawn and dithered against each other
+#define IMPOSTOR_DISTANCE 80.0f
+#define IMPOSTOR_FADE_BAND 10.0f
+
+// Draw paths, selected with number keys
+typedef enum DrawPath {
+    DRAW_BATCHED,
+    DRAW_INSTANCED,
+    DRAW_VERTEX_PULLING,
+    DRAW_QUEUED,
+    DRAW_IMPOSTORS,
+    DRAW_ORBITAL,
+    DRAW_MULTIPASS,
+    DRAW_SORTED,
+    DRAW_MULTIVIEW,
+    MAX_DRAW_PATHS
+} DrawPath;
+
+static const char* drawPathText[] = {
+    "DRAW_BATCHED",
+    "DRAW_INSTANCED",
+    "DRAW_VERTEX_PULLING",
+    "DRAW_QUEUED",
+    "DRAW_IMPOSTORS",
+    "DRAW_ORBITAL",
+    "DRAW_MULTIPASS",
+    "DRAW_SORTED",
+    "DRAW_MULTIVIEW",
+};
+
+// Rock vertex formats of the instanced path, selected with Q
+static const char* meshFormatText[] = {
+    "float",
+    "quantized, 16-bit normals",
+    "quantized, 8-bit normals",
+};
+
+// Shadow map texture slot of the shadowed color pass, after the material map slots
+#define SHADOW_MAP_SLOT 7
+
+// Frame arena reserve above the largest frame lists (alignment, small allocations)
+#define FRAME_ARENA_MARGIN (1 << 20)
+
+// View counts of the multi-view layouts: full screen, split screen, minimap, cube capture faces
+static const int viewLayoutCounts[] = { 1, 2, 3, 9 };
+
+// Set views of a layout, players split the screen above a strip with the minimap and cube faces
+void LayoutAsteroidViews(MultiView* views, int viewCount, Camera3D camera, int width, int height)
+{
+    ClearMultiView(views);
+
+    float strip = (viewCount > 2) ? fminf(height / 4.0f, width / 7.0f) : 0.0f;
+    float playerHeight = height - strip;
+
+    if (viewCount == 1)
+        AddMultiView(views, camera, (Rectangle) { 0, 0, width, height });
+    else
+    {
+        // Second player mirrors the first one across the ring
+        Camera3D second = camera;
+        second.position = (Vector3) { -camera.position.x, camera.position.y, -camera.position.z };
+        second.target = (Vector3) { -camera.target.x, camera.target.y, -camera.target.z };
+
+        AddMultiView(views, camera, (Rectangle) { 0, 0, width / 2.0f, playerHeight });
+        AddMultiView(views, second, (Rectangle) { width / 2.0f, 0, width / 2.0f, playerHeight });
+    }
+
+    if (viewCount > 2)
+    {
+        Camera3D minimap = { { 0.0f, 400.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, 400.0f, CAMERA_ORTHOGRAPHIC };
+        AddMultiView(views, minimap, (Rectangle) { 0, playerHeight, strip, strip });
+    }
+
+    if (viewCount > 3)
+    {
+        // Cube capture faces of a reflection probe inside the belt
+        const Vector3 directions[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        const Vector3 ups[6] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+        Vector3 probe = { 0.0f, 0.0f, 150.0f };
+
+        for (int i = 0; i < 6; i++)
+        {
+            Camera3D face = { probe, Vector3Add(probe, directions[i]), ups[i], 90.0f, CAMERA_PERSPECTIVE };
+            AddMultiView(views, face, (Rectangle) { strip * (i + 1), playerHeight, strip, strip });
+        }
+    }
+}
+
+// Sort every rock count from 100K to 10M instances with 1 to maxThreads threads and log the average times
+// NOTE: Needs about 1.4 GB and minutes of CPU time, run with "--benchmark-sort" before any window opens
+void BenchmarkInstanceSorter(int maxThreads)
+{
+    const int counts[] = { 100000, 1000000, 10000000 };
+    const int maxCount = 10000000;
+
+    Vector4* positions = (Vector4*)RL_MALLOC(maxCount * sizeof(Vector4));
+    float16* records = (float16*)RL_CALLOC(maxCount, sizeof(float16));
+    float16* sorted = (float16*)RL_MALLOC(maxCount * sizeof(float16));
+    if ((positions == NULL) || (records == NULL) || (sorted == NULL))
+    {
+        TraceLog(LOG_WARNING, "SORT: Failed to allocate benchmark instances");
+        RL_FREE(positions);
+        RL_FREE(records);
+        RL_FREE(sorted);
+        return;
+    }
+
+    for (int i = 0; i < maxCount; i++)
+    {
+        float angle = (float)GetRandomValue(0, 36000) / 100.0f * DEG2RAD;
+        positions[i] = (Vector4) { sinf(angle) * 150.0f + GetRandomValue(-300, 300) / 10.0f, GetRandomValue(-150, 150) / 10.0f, cosf(angle) * 150.0f + GetRandomValue(-300, 300) / 10.0f, 1.0f };
+    }
+
+    Vector3 viewPosition = { 0.0f, 14.0f, 240.0f };
+    Vector3 viewDirection = Vector3Normalize(Vector3Negate(viewPosition));
+
+    for (int c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        for (int threads = 1; threads <= maxThreads; threads++)
+        {
+            InstanceSorter* sorter = LoadInstanceSorter(threads);
+
+            InstanceSortStats total = { 0 };
+            for (int i = 0; i < 5; i++)
+            {
+                SortInstances(sorter, positions, sizeof(Vector4), 3, NULL, counts[c], viewPosition, viewDirection, SORT_FRONT_TO_BACK);
+                PermuteSortedInstances(sorter, records, sizeof(float16), sorted);
+                total.keyTime += sorter->stats.keyTime;
+                total.sortTime += sorter->stats.sortTime;
+                total.permuteTime += sorter->stats.permuteTime;
+            }
+
+            TraceLog(LOG_INFO, "SORT: %i instances, %i threads: keys %.2f ms, sort %.2f ms, permute %.2f ms", counts[c], threads,
+                total.keyTime / 5.0 * 1000.0, total.sortTime / 5.0 * 1000.0, total.permuteTime / 5.0 * 1000.0);
+            UnloadInstanceSorter(sorter);
+        }
+    }
+
+    RL_FREE(positions);
+    RL_FREE(records);
+    RL_FREE(sorted);
+}
+
+int main(int argc, char** argv)
 {
+    // Sort benchmark runs alone, it blocks for minutes and needs no window
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark-sort") == 0)
+        {
+            BenchmarkInstanceSorter(GetWorkerCoreCount());
+            return 0;
+        }
+    }
+
     // Initialization
     //--------------------------------------------------------------------------------------
     const int screenWidth = 800;
@@ -25,11 +204,17 @@ int main(void)
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(screenWidth, screenHeight, "raylib [models] example - asteroids instanced");
 
-    Shader rockShader = LoadShader("resources/shaders/asteroids_instanced.vs", "resources/shaders/asteroids_instanced.fs");
-    rockShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(rockShader, "mvp");
+    // Input is recorded or replayed with "--record <file>" / "--replay <file>" (see input_replay.h)
+    InputReplay* input = LoadInputReplay(argc, argv, 1.0f / 60.0f);
+
+    // Instanced shaders are variants of one base shader, linked programs are cached between runs
+    ShaderVariantSet shaderVariants = LoadShaderVariantSet("resources/shaders/instanced.vs", "resources/shaders/instanced.fs", "instanced");
+
+    Shader rockShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_MATRIX);
     rockShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(rockShader, "instance");
-    rockShader.locs[SHADER_LOC_MATRIX_VIEW] = GetShaderLocation(rockShader, "view");
-    rockShader.locs[SHADER_LOC_MATRIX_PROJECTION] = GetShaderLocation(rockShader, "projection");
+
+    Shader pulledShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_VERTEX_PULLING | SHADER_FEATURE_INSTANCE_MATRIX);
+    SetShaderPulledLocations(pulledShader);
 
     // Load models
     Model planet = LoadModel("resources/objects/planet/planet.obj");
@@ -37,7 +222,7 @@ int main(void)
 
     // Generate a large list of semi-random model transformation matrices
     //--------------------------------------------------------------------------------------
-    unsigned int asteroidCount = 50000;
+    unsigned int asteroidCount = ASTEROID_COUNT;
     Matrix* modelMatrices = (Matrix*)RL_CALLOC(asteroidCount, sizeof(Matrix));
 
     // Initialize random seed
@@ -81,48 +266,251 @@ int main(void)
         modelMatrices[i] = model;
     }
 
-    bool drawInstanced = true;
+    // Static transforms are uploaded once, all rock meshes share the instance buffer
+    InstanceBuffer instanceBuffer = LoadInstanceBuffer(modelMatrices, asteroidCount);
+    InstancedModel rockInstanced = LoadInstancedModel(rock, rockShader, instanceBuffer);
+    long long lastUploadedBytes = instanceBuffer.uploadedBytes;
+
+    // Quantized rock meshes share the instance buffer, positions, normals and texcoords are
+    // decoded by the shader from one interleaved, vertex cache ordered stream
+    Shader quantizedShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_MATRIX | SHADER_FEATURE_QUANTIZED_VERTICES);
+    quantizedShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(quantizedShader, "instance");
+    SetShaderQuantizedLocations(quantizedShader);
+    QuantizedModel rockQuantized[2] = { LoadQuantizedModel(rock, 16), LoadQuantizedModel(rock, 8) };
+    InstancedModel rockQuantizedInstanced[2] = {
+        LoadQuantizedInstancedModel(rockQuantized[0], quantizedShader, instanceBuffer),
+        LoadQuantizedInstancedModel(rockQuantized[1], quantizedShader, instanceBuffer)
+    };
+    int meshFormat = 0;
+
+    // Software occlusion culling, the planet hides part of the ring
+    OcclusionBuffer occlusionBuffer = LoadOcclusionBuffer(256, 128);
+    if (CheckOcclusionCulling())
+        TraceLog(LOG_INFO, "OCCLUSION: Self-check passed");
+    BoundingBox rockBounds = GetModelBoundingBox(rock);
+    bool occlusionCulling = false;
+
+    // Frustum culling, results are kept between frames and only rocks
+    // close to the frustum boundary are tested again when the view moves
+    Vector4* rockSpheres = (Vector4*)RL_CALLOC(asteroidCount, sizeof(Vector4));
+    Vector3 rockCenter = Vector3Scale(Vector3Add(rockBounds.min, rockBounds.max), 0.5f);
+    float rockRadius = Vector3Distance(rockBounds.max, rockCenter);
+    for (int i = 0; i < asteroidCount; i++)
+    {
+        Matrix mat = modelMatrices[i];
+        float scale = fmaxf(Vector3Length((Vector3) { mat.m0, mat.m1, mat.m2 }), fmaxf(Vector3Length((Vector3) { mat.m4, mat.m5, mat.m6 }), Vector3Length((Vector3) { mat.m8, mat.m9, mat.m10 })));
+        Vector3 center = Vector3Transform(rockCenter, mat);
+        rockSpheres[i] = (Vector4) { center.x, center.y, center.z, rockRadius * scale };
+    }
+
+    VisibilityCache visibilityCache = LoadVisibilityCache(asteroidCount);
+
+    // Multi-pass rendering, rocks are sorted into spatial chunks and uploaded once to their own buffer.
+    // Depth prepass, shadow cascades and color pass draw culled chunk ranges of it, each pass
+    // with its own shader variant, so extra passes upload nothing
+    //--------------------------------------------------------------------------------------
+    Shader depthShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_MATRIX | SHADER_FEATURE_DEPTH_ONLY);
+    depthShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(depthShader, "instance");
+    Shader shadowedShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_MATRIX | SHADER_FEATURE_SHADOW_CASCADES);
+    shadowedShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shadowedShader, "instance");
+
+    Matrix* passMatrices = (Matrix*)RL_MALLOC(asteroidCount * sizeof(Matrix));
+    memcpy(passMatrices, modelMatrices, asteroidCount * sizeof(Matrix));
+    InstanceChunks passChunks = LoadInstanceChunks(passMatrices, asteroidCount, rockBounds);
+    InstanceBuffer passBuffer = LoadInstanceBuffer(passMatrices, asteroidCount);
+    InstancedModel rockPasses = LoadInstancedModel(rock, shadowedShader, passBuffer);
+    long long lastPassUploadedBytes = passBuffer.uploadedBytes;
+    RL_FREE(passMatrices);
+
+    Vector4 rockCasters = GetInstanceChunksSphere(passChunks);
+    ShadowCascades shadows = LoadShadowCascades(3, 1024, (Vector3) { -0.6f, -0.5f, -0.6f });
+    SetShadowCascadesShader(&shadows, shadowedShader);
+    InstanceRanges viewRanges = LoadInstanceRanges(passChunks);
+    InstanceRanges cascadeRanges[SHADOW_MAX_CASCADES] = { 0 };
+    for (int i = 0; i < shadows.cascadeCount; i++)
+        cascadeRanges[i] = LoadInstanceRanges(passChunks);
+
+    PassSamples shadedSamples = LoadPassSamples();
+    bool depthPrepass = true;
+
+    // Depth sorted rocks, visible rocks are sorted front to back so nearer rocks hide the ones behind
+    // before they are shaded. Sorted transforms are permuted straight into the mapped instance buffer
+    //--------------------------------------------------------------------------------------
+    InstanceSorter* sorter = LoadInstanceSorter(0);
+    float16* rockRecords = (float16*)RL_MALLOC(asteroidCount * sizeof(float16));
+    for (int i = 0; i < asteroidCount; i++)
+        rockRecords[i] = MatrixToFloatV(modelMatrices[i]);
+
+    InstanceBuffer sortedBuffer = LoadInstanceBuffer(NULL, asteroidCount);
+    InstancedModel rockSorted = LoadInstancedModel(rock, rockShader, sortedBuffer);
+    long long lastSortedUploadedBytes = sortedBuffer.uploadedBytes;
+    unsigned int* sortIndices = (unsigned int*)RL_CALLOC(asteroidCount, sizeof(unsigned int));
+    int sortCount = 0;                          // Visible rocks listed in sortIndices
+    InstanceSortOrder sortOrder = SORT_FRONT_TO_BACK;
+    int sortInterval = 1;                       // Frames between sorts, the last order is kept in between
+    int sortFrame = 0;
+    PassSamples sortedSamples = LoadPassSamples();
+
+    // Multi-view rendering, rock chunks and the planet are drawn once for every view,
+    // views only change uniforms so submission does not grow with the view count
+    //--------------------------------------------------------------------------------------
+    Shader multiViewShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_MATRIX | SHADER_FEATURE_MULTI_VIEW);
+    multiViewShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(multiViewShader, "instance");
+    MultiView views = LoadMultiView(multiViewShader);
+    InstancedModel rockViews = LoadInstancedModel(rock, multiViewShader, passBuffer);
+    InstanceRanges multiViewRanges = LoadInstanceRanges(passChunks);
+
+    InstanceBuffer planetBuffer = LoadInstanceBuffer(NULL, 1);
+    InstancedModel planetViews = LoadInstancedModel(planet, multiViewShader, planetBuffer);
+    int planetOffset = 0;
+    int planetCount = 1;
+    InstanceRanges planetRange = { &planetOffset, &planetCount, 1, 1, 1 };
+
+    int viewLayout = 2;
+    bool separateViews = false;                 // One submission per view, to compare submission cost
+
+    // Dynamic resolution holds 14 ms of GPU time, HUD stays at native resolution
+    DynamicResolution resolution = LoadDynamicResolution(0.014f, 0.5f, 1.0f);
+    Matrix* frustumMatrices = (Matrix*)RL_CALLOC(asteroidCount, sizeof(Matrix));
+    int frustumCount = 0;
+    float visibilityAngle = 0.0f;
+    bool frustumCulling = false;
+
+    // Orbital motion, each rock stores its orbit and the transform is built
+    // in the vertex shader from the time uniform
+    //--------------------------------------------------------------------------------------
+    Shader orbitalShader = LoadShader("resources/shaders/asteroids_orbital.vs", "resources/shaders/asteroids_instanced.fs");
+    orbitalShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(orbitalShader, "mvp");
+    orbitalShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(orbitalShader, "orbit");
+    int orbitalTimeLoc = GetShaderLocation(orbitalShader, "time");
+
+    OrbitalParams* orbits = (OrbitalParams*)RL_CALLOC(asteroidCount, sizeof(OrbitalParams));
+    for (int i = 0; i < asteroidCount; i++)
+    {
+        OrbitalParams orbit = { 0 };
+        orbit.radius = radius + (rand() % (int)(2 * offset * 100)) / 100.0f - offset;
+        orbit.phase = (float)i / (float)asteroidCount * 2.0f * PI;
+        orbit.angularVelocity = GetOrbitalVelocity(orbit.radius, radius, 0.05f);
+        orbit.inclination = ((rand() % 400) / 100.0f - 2.0f) * DEG2RAD;
+        orbit.node = (rand() % 360) * DEG2RAD;
+        orbit.height = ((rand() % (int)(2 * offset * 100)) / 100.0f - offset) * 0.5f;
+        orbit.scale = (rand() % 20) / 100.0f + 0.05f;
+
+        Vector3 spinAxis = { (rand() % 200) / 100.0f - 1.0f, (rand() % 200) / 100.0f - 1.0f, (rand() % 200) / 100.0f - 1.0f };
+        orbit.spinAxis = (Vector3Length(spinAxis) > 0.0f) ? Vector3Normalize(spinAxis) : (Vector3) { 0.0f, 1.0f, 0.0f };
+        orbit.spinPhase = (rand() % 360) * DEG2RAD;
+        orbit.spinRate = (rand() % 200) / 100.0f - 1.0f;
+
+        orbits[i] = orbit;
+    }
+
+    // Orbits are uploaded once, nothing is uploaded per frame unless culling is enabled
+    InstanceBuffer orbitalBuffer = LoadInstanceBuffer(NULL, asteroidCount);
+    UpdateInstanceBufferData(&orbitalBuffer, orbits, 0, asteroidCount);
+    InstancedModel rockOrbital = LoadInstancedModel(rock, orbitalShader, orbitalBuffer);
+    long long lastOrbitalUploadedBytes = orbitalBuffer.uploadedBytes;
+    float orbitalTime = 0.0f;
+
+    // Impostors, rock views are rendered into an atlas once (cached on disk)
+    // and far rocks only upload their index each frame
+    Shader lodShader = LoadShader("resources/shaders/asteroids_lod.vs", "resources/shaders/asteroids_lod.fs");
+    lodShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(lodShader, "mvp");
+    lodShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(lodShader, "instance");
+    int lodViewPositionLoc = GetShaderLocation(lodShader, "viewPosition");
+    int lodFadeRangeLoc = GetShaderLocation(lodShader, "fadeRange");
+
+    ImpostorAtlas rockImpostor = LoadImpostorAtlas(rock, "resources/objects/rock/rock.obj", 8, 64, "asteroids_impostor.cache");
+    ImpostorRenderer impostorRenderer = LoadImpostorRenderer(modelMatrices, asteroidCount);
+
+    InstanceBuffer lodBuffer = LoadInstanceBuffer(NULL, asteroidCount);
+    InstancedModel rockLod = LoadInstancedModel(rock, lodShader, lodBuffer);
+    int nearCount = 0;
+    int farCount = 0;
+
+    // Configure vertex pulling, planet and rock meshes share one geometry pool
+    // and the planet transform is stored after the asteroid transforms
+    //--------------------------------------------------------------------------------------
+    int poolVertices = 0;
+    for (int i = 0; i < rock.meshCount; i++)
+        poolVertices += rock.meshes[i].vertexCount;
+    for (int i = 0; i < planet.meshCount; i++)
+        poolVertices += planet.meshes[i].vertexCount;
+
+    // NOTE: OBJ meshes are not indexed, one index is stored per vertex
+    rlGeometryPool geometryPool = rlLoadGeometryPool(poolVertices, poolVertices);
+
+    rlGeometryRange* rockRanges = (rlGeometryRange*)RL_CALLOC(rock.meshCount, sizeof(rlGeometryRange));
+    for (int i = 0; i < rock.meshCount; i++)
+        rockRanges[i] = LoadMeshGeometry(&geometryPool, rock.meshes[i]);
+
+    rlGeometryRange* planetRanges = (rlGeometryRange*)RL_CALLOC(planet.meshCount, sizeof(rlGeometryRange));
+    for (int i = 0; i < planet.meshCount; i++)
+        planetRanges[i] = LoadMeshGeometry(&geometryPool, planet.meshes[i]);
+
+    // Column-major transforms, static asteroid transforms are uploaded once
+    float16* instanceTransforms = (float16*)RL_CALLOC(asteroidCount + 1, sizeof(float16));
+    for (int i = 0; i < asteroidCount; i++)
+        instanceTransforms[i] = MatrixToFloatV(modelMatrices[i]);
+
+    rlInstancePool instancePool = rlLoadInstancePool((asteroidCount + 1) * sizeof(float16));
+    rlUpdateInstancePool(instancePool, instanceTransforms, asteroidCount * sizeof(float16), 0);
+
+    // Deferred draw queue, rock draws sharing mesh and material are merged
+    // into DrawMeshInstanced() calls with the instancing shader
+    DrawQueue drawQueue = LoadDrawQueue(asteroidCount, rockShader);
+
+    // Per frame lists (culling output, LOD buckets) are allocated from an arena reset every frame,
+    // the largest frame holds a transform, an index and an orbit of every rock
+    size_t frameArenaSize = (size_t)asteroidCount * (sizeof(Matrix) + sizeof(unsigned int) + sizeof(OrbitalParams)) + FRAME_ARENA_MARGIN;
+    FrameArena frameArena = LoadFrameArena(frameArenaSize);
+
+    int drawPath = DRAW_INSTANCED;
     bool paused = false;
 
     // Define the camera to look into our 3d world
     CameraFP camera = LoadCameraFP();
     camera.view.position = (Vector3) { 0.0f, 14.0f, 240.0f };
 
-    Vector2 mousePosition = GetMousePosition();
+    Vector2 mousePosition = GetInputMousePosition();
     Vector2 mouseLastPosition = mousePosition;
 
     DisableCursor();
 
     float angle = 0.0f;
 
-    SetTargetFPS(60); // Set our game to run at 60 frames-per-second
+    SetTargetFPS((input->mode == INPUT_REPLAY) ? 0 : 60); // Set our game to run at 60 frames-per-second, replays run uncapped
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose()) // Detect window close button or ESC key
+    while (!WindowShouldClose() && !IsInputReplayFinished()) // Detect window close button or ESC key
     {
         // Update
         //----------------------------------------------------------------------------------
-        float dt = GetFrameTime();
+        UpdateInputReplay(input);
+        ResetFrameArena(&frameArena);
+
+        float dt = GetInputFrameTime();
         if (!paused)
         {
             // Track mouse movement
-            mousePosition = GetMousePosition();
+            mousePosition = GetInputMousePosition();
             Vector2 mouseDelta = Vector2Subtract(mousePosition, mouseLastPosition);
             mouseLastPosition = mousePosition;
 
             UpdateCameraCustom(&camera, mouseDelta, dt);
             angle += 0.3f * dt;
+            orbitalTime += dt;
         }
 
-        if (IsKeyPressed(KEY_R))
+        if (IsInputKeyPressed(KEY_R))
         {
             camera.view.position = (Vector3) { 0.0f, 14.0f, 240.0f };
             camera.view.target = (Vector3) { 0.0f, 0.0f, 0.0f };
             camera.up = (Vector3) { 0.0f, 1.0f, 0.0f };
+            MarkCameraFPDirty(&camera);
         }
 
-        if (IsKeyPressed(KEY_F3))
+        if (IsInputKeyPressed(KEY_F3))
         {
             if (paused)
             {
@@ -136,16 +524,111 @@ int main(void)
             }
         }
 
-        // Turn instancing on/off
-        if (IsKeyPressed(KEY_ONE))
-            drawInstanced = false;
-        if (IsKeyPressed(KEY_TWO))
-            drawInstanced = true;
+        // Switch draw path
+        int previousPath = drawPath;
+        if (IsInputKeyPressed(KEY_ONE))
+            drawPath = DRAW_BATCHED;
+        if (IsInputKeyPressed(KEY_TWO))
+            drawPath = DRAW_INSTANCED;
+        if (IsInputKeyPressed(KEY_THREE))
+            drawPath = DRAW_VERTEX_PULLING;
+        if (IsInputKeyPressed(KEY_FOUR))
+            drawPath = DRAW_QUEUED;
+        if (IsInputKeyPressed(KEY_FIVE))
+            drawPath = DRAW_IMPOSTORS;
+        if (IsInputKeyPressed(KEY_SIX))
+            drawPath = DRAW_ORBITAL;
+        if (IsInputKeyPressed(KEY_SEVEN))
+            drawPath = DRAW_MULTIPASS;
+        if (IsInputKeyPressed(KEY_EIGHT))
+            drawPath = DRAW_SORTED;
+        if (IsInputKeyPressed(KEY_NINE))
+            drawPath = DRAW_MULTIVIEW;
+
+        // Instanced and sorted paths both keep visible rocks from the cache, they are listed again on switch
+        if (drawPath != previousPath)
+        {
+            InvalidateVisibilityCache(&visibilityCache);
+            sortCount = 0;
+        }
+
+        // Change sort order and interval
+        if (IsInputKeyPressed(KEY_O))
+        {
+            sortOrder = (sortOrder + 1) % SORT_ORDER_COUNT;
+            sortFrame = 0;
+        }
+        if (IsInputKeyPressed(KEY_N))
+        {
+            sortInterval = (sortInterval < 16) ? sortInterval * 2 : 1;
+            sortFrame = 0;
+        }
+
+        // Change rock vertex format
+        if (IsInputKeyPressed(KEY_Q))
+            meshFormat = (meshFormat + 1) % (sizeof(meshFormatText) / sizeof(meshFormatText[0]));
+
+        // Change multi-view layout, or submit every view on its own
+        if (IsInputKeyPressed(KEY_M))
+            viewLayout = (viewLayout + 1) % (sizeof(viewLayoutCounts) / sizeof(viewLayoutCounts[0]));
+        if (IsInputKeyPressed(KEY_U))
+            separateViews = !separateViews;
+
+        // Toggle depth prepass of the multi-pass path
+        if (IsInputKeyPressed(KEY_P))
+            depthPrepass = !depthPrepass;
+
+        // Toggle occlusion culling, all static transforms are restored when disabled
+        if (IsInputKeyPressed(KEY_C))
+        {
+            occlusionCulling = !occlusionCulling;
+            if (!occlusionCulling)
+            {
+                UpdateInstanceBuffer(&instanceBuffer, modelMatrices, 0, asteroidCount);
+                UpdateInstanceBufferData(&orbitalBuffer, orbits, 0, asteroidCount);
+            }
+            InvalidateVisibilityCache(&visibilityCache);
+        }
+
+        // Toggle frustum culling with the visibility cache
+        if (IsInputKeyPressed(KEY_V))
+        {
+            frustumCulling = !frustumCulling;
+            InvalidateVisibilityCache(&visibilityCache);
+            if (!frustumCulling)
+                UpdateInstanceBuffer(&instanceBuffer, modelMatrices, 0, asteroidCount);
+        }
+
+        // Toggle dynamic resolution
+        UpdateDynamicResolutionToggle(&resolution);
         //----------------------------------------------------------------------------------
 
         // Draw
         //----------------------------------------------------------------------------------
         BeginDrawing();
+
+        // Shadow cascades are drawn first, each cascade culls the rock chunks with its light frustum
+        if (drawPath == DRAW_MULTIPASS)
+        {
+            Matrix ringTransform = MatrixRotate((Vector3) { 0.0f, 1.0f, 0.0f }, angle * DEG2RAD);
+            Vector3 casterCenter = Vector3Transform((Vector3) { rockCasters.x, rockCasters.y, rockCasters.z }, ringTransform);
+            float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+            UpdateShadowCascades(&shadows, camera.view, aspect, 250.0f, (Vector4) { casterCenter.x, casterCenter.y, casterCenter.z, rockCasters.w });
+
+            for (int i = 0; i < shadows.cascadeCount; i++)
+            {
+                CullInstanceChunks(passChunks, GetShadowCascadeMatrix(shadows, i, ringTransform), &cascadeRanges[i]);
+
+                BeginShadowCascade(&shadows, i);
+                rlPushMatrix();
+                rlRotatef(angle, 0, 1, 0);
+                DrawInstancedModelRanges(rockPasses, depthShader, cascadeRanges[i]);
+                rlPopMatrix();
+                EndShadowCascade(&shadows);
+            }
+        }
+
+        BeginDynamicResolution(&resolution);
         ClearBackground((Color) { 26, 26, 26, 255 });
 
         BeginMode3D(camera.view);
@@ -155,15 +638,295 @@ int main(void)
 
         Vector3 axis = { 0.0f, 0.0f, 1.0f };
         Vector3 scale = { 5.0f, 5.0f, 5.0f };
-        DrawModelEx(planet, Vector3Zero(), axis, angle, scale, WHITE);
+        if ((drawPath != DRAW_VERTEX_PULLING) && (drawPath != DRAW_MULTIVIEW))
+            DrawModelEx(planet, Vector3Zero(), axis, angle, scale, WHITE);
+
+        // Draw all asteroids and the planet from the shared pools
+        // Only base offsets and textures change between draws
+        if (drawPath == DRAW_VERTEX_PULLING)
+        {
+            Matrix planetTransform = MatrixMultiply(MatrixScale(scale.x, scale.y, scale.z), MatrixRotate(axis, angle * DEG2RAD));
+            instanceTransforms[asteroidCount] = MatrixToFloatV(planetTransform);
+            rlUpdateInstancePool(instancePool, &instanceTransforms[asteroidCount], sizeof(float16), asteroidCount * sizeof(float16));
+
+            for (int i = 0; i < planet.meshCount; i++)
+            {
+                Texture2D texture = planet.materials[planet.meshMaterial[i]].maps[MATERIAL_MAP_DIFFUSE].texture;
+                DrawGeometryInstanced(geometryPool, planetRanges[i], instancePool, asteroidCount, 1, pulledShader, texture);
+            }
+
+            for (int i = 0; i < rock.meshCount; i++)
+            {
+                Texture2D texture = rock.materials[rock.meshMaterial[i]].maps[MATERIAL_MAP_DIFFUSE].texture;
+                DrawGeometryInstanced(geometryPool, rockRanges[i], instancePool, 0, asteroidCount, pulledShader, texture);
+            }
+        }
+        // Near rocks as meshes, far rocks as impostors
+        else if (drawPath == DRAW_IMPOSTORS)
+        {
+            // Camera position in the rotated space of the rock transforms
+            Vector3 viewPosition = Vector3Transform(camera.view.position, MatrixInvert(rlGetMatrixTransform()));
+            float fadeRange[2] = { IMPOSTOR_DISTANCE - IMPOSTOR_FADE_BAND * 0.5f, IMPOSTOR_DISTANCE + IMPOSTOR_FADE_BAND * 0.5f };
+
+            Matrix* nearMatrices = (Matrix*)AllocFrameArena(&frameArena, asteroidCount * sizeof(Matrix));
+            unsigned int* farIndices = (unsigned int*)AllocFrameArena(&frameArena, asteroidCount * sizeof(unsigned int));
+
+            nearCount = 0;
+            farCount = 0;
+            if ((nearMatrices == NULL) || (farIndices == NULL))
+            {
+                // Arena exhausted, every rock is drawn as a mesh without fading
+                nearMatrices = modelMatrices;
+                nearCount = asteroidCount;
+                fadeRange[0] = FLT_MAX;
+                fadeRange[1] = FLT_MAX;
+            }
+            else
+            {
+                for (int i = 0; i < asteroidCount; i++)
+                {
+                    Vector3 position = { modelMatrices[i].m12, modelMatrices[i].m13, modelMatrices[i].m14 };
+                    float distance = Vector3Distance(position, viewPosition);
+
+                    if (distance < fadeRange[1])
+                        nearMatrices[nearCount++] = modelMatrices[i];
+                    if (distance > fadeRange[0])
+                        farIndices[farCount++] = i;
+                }
+            }
+
+            UpdateInstanceBuffer(&lodBuffer, nearMatrices, 0, nearCount);
+            SetShaderValue(lodShader, lodViewPositionLoc, &viewPosition, SHADER_UNIFORM_VEC3);
+            SetShaderValue(lodShader, lodFadeRangeLoc, fadeRange, SHADER_UNIFORM_VEC2);
+            DrawInstancedModel(rockLod, 0, nearCount);
+
+            DrawImpostors(&impostorRenderer, rockImpostor, farIndices, farCount, viewPosition, fadeRange[0], fadeRange[1]);
+        }
+        // Rocks move on their own orbits, the ring rotation is undone
+        else if (drawPath == DRAW_ORBITAL)
+        {
+            rlPushMatrix();
+            rlRotatef(-angle, 0, 1, 0);
+
+            int visibleCount = asteroidCount;
+
+            // Culling tests the CPU reference transforms, visible orbits are uploaded
+            if (occlusionCulling)
+            {
+                Matrix viewProjection = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+                Matrix planetTransform = MatrixMultiply(MatrixMultiply(MatrixScale(scale.x, scale.y, scale.z), MatrixRotate(axis, angle * DEG2RAD)), MatrixRotateY(angle * DEG2RAD));
+
+                BeginOcclusionFrame(&occlusionBuffer, viewProjection);
+                for (int i = 0; i < planet.meshCount; i++)
+                    RasterizeOccluder(&occlusionBuffer, planet.meshes[i], planetTransform);
+                BuildOcclusionPyramid(&occlusionBuffer);
+
+                Matrix* orbitalMatrices = (Matrix*)AllocFrameArena(&frameArena, asteroidCount * sizeof(Matrix));
+                unsigned int* visibleIndices = (unsigned int*)AllocFrameArena(&frameArena, asteroidCount * sizeof(unsigned int));
+                OrbitalParams* visibleOrbits = (OrbitalParams*)AllocFrameArena(&frameArena, asteroidCount * sizeof(OrbitalParams));
+
+                // Arena exhausted, every orbit is drawn unculled
+                if ((orbitalMatrices == NULL) || (visibleIndices == NULL) || (visibleOrbits == NULL))
+                    UpdateInstanceBufferData(&orbitalBuffer, orbits, 0, asteroidCount);
+                else
+                {
+                    GetOrbitalTransforms(orbits, asteroidCount, orbitalTime, orbitalMatrices);
+
+                    visibleCount = CullOccludedIndices(&occlusionBuffer, orbitalMatrices, asteroidCount, rockBounds, visibleIndices);
+                    for (int i = 0; i < visibleCount; i++)
+                        visibleOrbits[i] = orbits[visibleIndices[i]];
+                    UpdateInstanceBufferData(&orbitalBuffer, visibleOrbits, 0, visibleCount);
+                }
+            }
+
+            SetShaderValue(orbitalShader, orbitalTimeLoc, &orbitalTime, SHADER_UNIFORM_FLOAT);
+            DrawInstancedModel(rockOrbital, 0, visibleCount);
+
+            rlPopMatrix();
+        }
+        // Rock chunks visible from the camera are drawn twice from the same buffer, depth only
+        // first then shaded with depth test EQUAL, so every pixel of the belt is shaded once
+        else if (drawPath == DRAW_MULTIPASS)
+        {
+            Matrix viewProjection = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+            CullInstanceChunks(passChunks, viewProjection, &viewRanges);
+
+            if (depthPrepass)
+            {
+                BeginDepthPrepass();
+                DrawInstancedModelRanges(rockPasses, depthShader, viewRanges);
+                EndDepthPrepass();
 
-        // Draw all asteroids at once
+                BeginEqualDepthPass();
+            }
+
+            EnableShadowCascades(shadows, shadowedShader, rlGetMatrixTransform(), SHADOW_MAP_SLOT);
+            BeginPassSamples(&shadedSamples);
+            DrawInstancedModelRanges(rockPasses, shadowedShader, viewRanges);
+            EndPassSamples(&shadedSamples);
+            DisableShadowCascades(SHADOW_MAP_SLOT);
+
+            if (depthPrepass)
+                EndEqualDepthPass();
+        }
+        // Visible rocks in depth order, sorting every few frames draws with the last order in between
+        else if (drawPath == DRAW_SORTED)
+        {
+            // Camera in the rotated space of the rock transforms
+            Matrix transform = rlGetMatrixTransform();
+            Matrix invTransform = MatrixInvert(transform);
+            Camera3D view = camera.view;
+            view.position = Vector3Transform(camera.view.position, invTransform);
+            view.target = Vector3Transform(camera.view.target, invTransform);
+            view.up = Vector3Subtract(Vector3Transform(Vector3Add(camera.view.position, camera.view.up), invTransform), view.position);
+
+            bool visibleChanged = false;
+            if (frustumCulling)
+            {
+                Matrix viewProjection = MatrixMultiply(MatrixMultiply(transform, rlGetMatrixModelview()), rlGetMatrixProjection());
+                float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+
+                bool dirty = camera.dirty || (angle != visibilityAngle);
+                if (UpdateVisibilityCache(&visibilityCache, rockSpheres, viewProjection, view, aspect, dirty))
+                {
+                    sortCount = 0;
+                    for (int i = 0; i < asteroidCount; i++)
+                    {
+                        if (visibilityCache.visible[i])
+                            sortIndices[sortCount++] = i;
+                    }
+                    visibleChanged = true;
+                }
+
+                camera.dirty = false;
+                visibilityAngle = angle;
+            }
+            else if (sortCount != asteroidCount)
+            {
+                for (int i = 0; i < asteroidCount; i++)
+                    sortIndices[i] = i;
+                sortCount = asteroidCount;
+                visibleChanged = true;
+            }
+
+            // Sorted transforms are only uploaded when the order changed
+            if (visibleChanged || (sortFrame % sortInterval == 0))
+            {
+                Vector3 viewDirection = Vector3Normalize(Vector3Subtract(view.target, view.position));
+                SortInstances(sorter, rockSpheres, sizeof(Vector4), 3, sortIndices, sortCount, view.position, viewDirection, sortOrder);
+                sortedBuffer.uploadedBytes += UploadSortedInstances(sorter, rockRecords, sizeof(float16), sortedBuffer.vboId);
+            }
+            sortFrame++;
+
+            BeginPassSamples(&sortedSamples);
+            DrawInstancedModel(rockSorted, 0, sortCount);
+            EndPassSamples(&sortedSamples);
+        }
+        // Chunks visible from any view are drawn once for all views, the planet too
+        else if (drawPath == DRAW_MULTIVIEW)
+        {
+            LayoutAsteroidViews(&views, viewLayoutCounts[viewLayout], camera.view, GetScreenWidth(), GetScreenHeight());
+            UpdateMultiView(&views, rlGetMatrixTransform(), GetScreenWidth(), GetScreenHeight());
+
+            Matrix planetTransform = MatrixMultiply(MatrixScale(scale.x, scale.y, scale.z), MatrixRotate(axis, angle * DEG2RAD));
+            UpdateInstanceBuffer(&planetBuffer, &planetTransform, 0, 1);
+
+            int first = 0;
+            int count = views.count;
+            while (first < views.count)
+            {
+                if (separateViews)
+                    count = 1;
+
+                CullMultiViewChunks(&views, first, count, passChunks, &multiViewRanges);
+                DrawMultiViewRanges(&views, first, count, planetViews, planetRange);
+                DrawMultiViewRanges(&views, first, count, rockViews, multiViewRanges);
+                first += count;
+            }
+        }
+        // Same loop as the batched path, queued draws are sorted and merged
+        else if (drawPath == DRAW_QUEUED)
+        {
+            rock.materials[0].shader.id = rlGetShaderIdDefault();
+            BeginDrawQueue(&drawQueue, Vector3Transform(camera.view.position, MatrixInvert(rlGetMatrixTransform())));
+            for (int i = 0; i < asteroidCount; i++)
+            {
+                rock.transform = modelMatrices[i];
+                QueueModel(&drawQueue, rock, Vector3Zero(), 1.0f, WHITE);
+            }
+            EndDrawQueue(&drawQueue);
+        }
+        // Draw all asteroids at once from the retained instance buffer
         // 1 draw call is made per mesh in the model
-        if (drawInstanced)
+        else if (drawPath == DRAW_INSTANCED)
         {
-            rock.transform = MatrixIdentity();
-            rock.materials[0].shader = rockShader;
-            DrawMeshInstanced(rock.meshes[0], rock.materials[0], modelMatrices, asteroidCount);
+            int visibleCount = asteroidCount;
+            const Matrix* candidates = modelMatrices;
+
+            // Visible transforms are only rebuilt and uploaded when a rock entered or left the frustum
+            if (frustumCulling)
+            {
+                Matrix transform = rlGetMatrixTransform();
+                Matrix viewProjection = MatrixMultiply(MatrixMultiply(transform, rlGetMatrixModelview()), rlGetMatrixProjection());
+
+                // Camera in the rotated space of the rock transforms, the ring rotation moves it too
+                Matrix invTransform = MatrixInvert(transform);
+                Camera3D view = camera.view;
+                view.position = Vector3Transform(camera.view.position, invTransform);
+                view.target = Vector3Transform(camera.view.target, invTransform);
+                view.up = Vector3Subtract(Vector3Transform(Vector3Add(camera.view.position, camera.view.up), invTransform), view.position);
+                float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+
+                bool dirty = camera.dirty || (angle != visibilityAngle);
+                if (UpdateVisibilityCache(&visibilityCache, rockSpheres, viewProjection, view, aspect, dirty))
+                {
+                    frustumCount = 0;
+                    for (int i = 0; i < asteroidCount; i++)
+                    {
+                        if (visibilityCache.visible[i])
+                            frustumMatrices[frustumCount++] = modelMatrices[i];
+                    }
+
+                    if (!occlusionCulling)
+                        UpdateInstanceBuffer(&instanceBuffer, frustumMatrices, 0, frustumCount);
+                }
+
+                camera.dirty = false;
+                visibilityAngle = angle;
+
+                visibleCount = frustumCount;
+                candidates = frustumMatrices;
+            }
+
+            // Rasterize the planet and upload only rocks not hidden behind it
+            if (occlusionCulling)
+            {
+                Matrix viewProjection = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+                Matrix planetTransform = MatrixMultiply(MatrixScale(scale.x, scale.y, scale.z), MatrixRotate(axis, angle * DEG2RAD));
+
+                BeginOcclusionFrame(&occlusionBuffer, viewProjection);
+                for (int i = 0; i < planet.meshCount; i++)
+                    RasterizeOccluder(&occlusionBuffer, planet.meshes[i], planetTransform);
+                BuildOcclusionPyramid(&occlusionBuffer);
+
+                // Arena exhausted, frustum visible rocks are drawn without occlusion culling
+                Matrix* visibleMatrices = (Matrix*)AllocFrameArena(&frameArena, visibleCount * sizeof(Matrix));
+                if (visibleMatrices == NULL)
+                    UpdateInstanceBuffer(&instanceBuffer, candidates, 0, visibleCount);
+                else
+                {
+                    visibleCount = CullOccludedInstances(&occlusionBuffer, candidates, visibleCount, rockBounds, visibleMatrices);
+                    UpdateInstanceBuffer(&instanceBuffer, visibleMatrices, 0, visibleCount);
+                }
+            }
+
+            if (meshFormat == 0)
+                DrawInstancedModel(rockInstanced, 0, visibleCount);
+            else
+            {
+                SetQuantizedModelShader(rockQuantized[meshFormat - 1], quantizedShader);
+                DrawInstancedModel(rockQuantizedInstanced[meshFormat - 1], 0, visibleCount);
+            }
         }
         // Draw each asteroid one at a time
         else
@@ -180,23 +943,137 @@ int main(void)
 
         EndMode3D();
 
+        EndDynamicResolution(&resolution);
+
+        if (drawPath == DRAW_MULTIVIEW)
+        {
+            for (int i = 0; i < views.count; i++)
+                DrawRectangleLinesEx(views.regions[i], 1, DARKGRAY);
+        }
+
         DrawRectangle(0, 0, screenWidth, 40, BLACK);
         DrawText(TextFormat("asteroids: %i", asteroidCount), 120, 10, 20, GREEN);
-        DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
+        DrawText(TextFormat("instanced: %i", drawPath != DRAW_BATCHED), 550, 10, 20, MAROON);
+
+        DrawText(TextFormat("%s", drawPathText[drawPath]), 10, GetScreenHeight() - 20, 14, MAROON);
+        if (drawPath == DRAW_INSTANCED)
+            DrawText(TextFormat("upload: %lli bytes", instanceBuffer.uploadedBytes - lastUploadedBytes), 200, GetScreenHeight() - 20, 14, MAROON);
+        if (drawPath == DRAW_INSTANCED)
+        {
+            int stride = (meshFormat == 0) ? 32 : rockQuantized[meshFormat - 1].stride;
+            QuantizeStats stats = (meshFormat == 0) ? (QuantizeStats) { 0 } : rockQuantized[meshFormat - 1].stats;
+            DrawText(TextFormat("mesh: %s, %i bytes per vertex, max error position: %.5f, normal: %.2f deg, gpu: %.2f ms", meshFormatText[meshFormat], stride,
+                         stats.maxPositionError, stats.maxNormalError, resolution.stats.gpuTime * 1000.0), 10, GetScreenHeight() - 80, 14, MAROON);
+        }
+        if (drawPath == DRAW_ORBITAL)
+            DrawText(TextFormat("upload: %lli bytes, time: %.2f s", orbitalBuffer.uploadedBytes - lastOrbitalUploadedBytes, orbitalTime), 200, GetScreenHeight() - 20, 14, MAROON);
+        if (((drawPath == DRAW_INSTANCED) || (drawPath == DRAW_ORBITAL)) && occlusionCulling)
+        {
+            OcclusionStats stats = occlusionBuffer.stats;
+            DrawText(TextFormat("culled: %i / %i, raster: %.2f ms, test: %.2f ms", stats.culled, stats.tested, stats.rasterTime * 1000.0, stats.testTime * 1000.0), 10, 50, 14, MAROON);
+        }
+        if ((drawPath == DRAW_INSTANCED) && frustumCulling)
+        {
+            VisibilityStats stats = visibilityCache.stats;
+            DrawText(TextFormat("frustum: %i visible, reused: %.1f%%, hits: %i, partial: %i, misses: %i", frustumCount, GetVisibilityCacheHitRate(visibilityCache) * 100.0f, stats.hits, stats.partials, stats.misses), 10, 70, 14, MAROON);
+        }
+        if (drawPath == DRAW_IMPOSTORS)
+            DrawText(TextFormat("meshes: %i, impostors: %i, frame: %.2f ms", nearCount, farCount, GetFrameTime() * 1000.0f), 200, GetScreenHeight() - 20, 14, MAROON);
+        if (drawPath == DRAW_MULTIPASS)
+        {
+            DrawText(TextFormat("upload: %lli bytes, prepass: %i, shaded: %.2fM samples", passBuffer.uploadedBytes - lastPassUploadedBytes, depthPrepass, shadedSamples.samples / 1000000.0f), 200, GetScreenHeight() - 20, 14, MAROON);
+            DrawText(TextFormat("instances: view %i (%i ranges), cascades %i / %i / %i", viewRanges.instances, viewRanges.count,
+                         cascadeRanges[0].instances, cascadeRanges[1].instances, cascadeRanges[2].instances), 10, 50, 14, MAROON);
+        }
+        if (drawPath == DRAW_SORTED)
+        {
+            InstanceSortStats stats = sorter->stats;
+            DrawText(TextFormat("upload: %lli bytes, shaded: %.2fM samples", sortedBuffer.uploadedBytes - lastSortedUploadedBytes, sortedSamples.samples / 1000000.0f), 200, GetScreenHeight() - 20, 14, MAROON);
+            DrawText(TextFormat("order: %s every %i frames, %i threads, keys: %.2f ms, sort: %.2f ms (%i passes), permute: %.2f ms", instanceSortOrderText[sortOrder], sortInterval,
+                         sorter->pool->threadCount, stats.keyTime * 1000.0, stats.sortTime * 1000.0, stats.passes, stats.permuteTime * 1000.0), 10, 50, 14, MAROON);
+        }
+        if (drawPath == DRAW_MULTIVIEW)
+        {
+            MultiViewStats stats = views.stats;
+            DrawText(TextFormat("views: %i, %s, draw calls: %i, cull: %.2f ms, submit: %.2f ms", views.count, separateViews ? "separate" : "merged",
+                         stats.drawCalls, stats.cullTime * 1000.0, stats.submitTime * 1000.0), 200, GetScreenHeight() - 20, 14, MAROON);
+            DrawText(TextFormat("instances: %i drawn, visible from players %i / %i", stats.instances, stats.visible[0], stats.visible[1]), 10, 50, 14, MAROON);
+        }
+        if (drawPath == DRAW_QUEUED)
+            DrawText(TextFormat("draw calls: %i, sort: %.2f ms", drawQueue.stats.drawCalls, drawQueue.stats.sortTime * 1000.0), 200, GetScreenHeight() - 20, 14, MAROON);
+
+        DrawDynamicResolutionStats(&resolution, 10, GetScreenHeight() - 40);
+        DrawText(TextFormat("frame arena: %.2f MB used, %.2f MB peak, %.2f MB committed", frameArena.used / 1048576.0f,
+                     frameArena.lastPeak / 1048576.0f, frameArena.committed / 1048576.0f),
+            10, GetScreenHeight() - 60, 14, MAROON);
 
         DrawFPS(10, 10);
 
         EndDrawing();
+
+        lastUploadedBytes = instanceBuffer.uploadedBytes;
+        lastOrbitalUploadedBytes = orbitalBuffer.uploadedBytes;
+        lastPassUploadedBytes = passBuffer.uploadedBytes;
+        lastSortedUploadedBytes = sortedBuffer.uploadedBytes;
         //----------------------------------------------------------------------------------
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
     RL_FREE(modelMatrices); // Unload modelMatrices data array
+    RL_FREE(instanceTransforms);
+    RL_FREE(rockRanges);
+    RL_FREE(planetRanges);
+
+    UnloadInstancedModel(rockInstanced);
+    for (int i = 0; i < 2; i++)
+    {
+        UnloadInstancedModel(rockQuantizedInstanced[i]);
+        UnloadQuantizedModel(&rockQuantized[i]);
+    }
+    UnloadInstanceBuffer(instanceBuffer);
+    UnloadOcclusionBuffer(&occlusionBuffer);
+    UnloadInstancedModel(rockOrbital);
+    UnloadInstanceBuffer(orbitalBuffer);
+    RL_FREE(orbits);
+    UnloadInstancedModel(rockLod);
+    UnloadInstanceBuffer(lodBuffer);
+    UnloadImpostorRenderer(&impostorRenderer);
+    UnloadImpostorAtlas(rockImpostor);
+    RL_FREE(rockSpheres);
+    RL_FREE(frustumMatrices);
+    UnloadVisibilityCache(&visibilityCache);
+    UnloadInstancedModel(rockPasses);
+    UnloadInstanceBuffer(passBuffer);
+    UnloadInstanceChunks(&passChunks);
+    UnloadInstanceRanges(&viewRanges);
+    for (int i = 0; i < shadows.cascadeCount; i++)
+        UnloadInstanceRanges(&cascadeRanges[i]);
+    UnloadShadowCascades(&shadows);
+    UnloadPassSamples(&shadedSamples);
+    UnloadInstancedModel(rockViews);
+    UnloadInstancedModel(planetViews);
+    UnloadInstanceBuffer(planetBuffer);
+    UnloadInstanceRanges(&multiViewRanges);
+    UnloadInstancedModel(rockSorted);
+    UnloadInstanceBuffer(sortedBuffer);
+    UnloadInstanceSorter(sorter);
+    UnloadPassSamples(&sortedSamples);
+    RL_FREE(rockRecords);
+    RL_FREE(sortIndices);
+    UnloadDynamicResolution(&resolution);
+    rlUnloadInstancePool(instancePool);
+    UnloadDrawQueue(&drawQueue);
+    rlUnloadGeometryPool(&geometryPool);
 
     UnloadModel(planet); // Unload planet model
     UnloadModel(rock);   // Unload rock model
-    UnloadShader(rockShader);
+    UnloadShaderVariantSet(&shaderVariants);
+    UnloadShader(lodShader);
+    UnloadShader(orbitalShader);
+
+    UnloadFrameArena(&frameArena);
+    UnloadInputReplay(input);
 
     CloseWindow(); // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+/*******************************************************************************************
+ *
+ *   raylib [models] example - asteroids streamed
+ *
+ *   Fly through a belt of about 170 million rocks, only chunks around the camera
+ *   are loaded from disk (generated on first visit) and kept in a fixed GPU pool
+ *
+ ********************************************************************************************/
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "camera_first_person.h"
+#include "instance_streaming.h"
+
+// Chunks are loaded inside this distance from the camera
+#define LOAD_RADIUS 800.0f
+
+// Chunks where the camera will be in this many seconds are requested early
+#define PREFETCH_TIME 1.0f
+
+int main(int argc, char** argv)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(screenWidth, screenHeight, "raylib [models] example - asteroids streamed");
+
+    // Input is recorded or replayed with "--record <file>" / "--replay <file>" (see input_replay.h)
+    InputReplay* input = LoadInputReplay(argc, argv, 1.0f / 60.0f);
+
+    Model rock = LoadModel("resources/objects/rock/rock.obj");
+
+    // Belt of 2 chunk layers, about 31000 chunk columns
+    StreamField field = {
+        .directory = "stream_chunks",
+        .chunkSize = 200.0f,
+        .instancesPerChunk = 4096,
+        .beltRadius = 50000.0f,
+        .beltWidth = 4000.0f,
+        .beltHeight = 400.0f,
+        .seed = 1234
+    };
+
+    // 384 chunks resident (12 MB), up to 512 KB uploaded per frame
+    InstanceStream* stream = LoadInstanceStream(field, rock, 384, 512 * 1024, LOAD_RADIUS);
+
+    // Start inside the belt, looking along it
+    CameraFP camera = LoadCameraFP();
+    camera.view.position = (Vector3) { field.beltRadius, 50.0f, 0.0f };
+    camera.view.target = Vector3Add(camera.view.position, camera.front);
+
+    Vector2 mousePosition = GetInputMousePosition();
+    Vector2 mouseLastPosition = mousePosition;
+    Vector3 velocity = Vector3Zero();
+    float speedScale = 1.0f;
+    bool paused = false;
+
+    DisableCursor();
+
+    SetTargetFPS((input->mode == INPUT_REPLAY) ? 0 : 60); // Set our game to run at 60 frames-per-second, replays run uncapped
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose() && !IsInputReplayFinished()) // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        UpdateInputReplay(input);
+
+        float dt = GetInputFrameTime();
+        if (!paused)
+        {
+            // Track mouse movement
+            mousePosition = GetInputMousePosition();
+            Vector2 mouseDelta = Vector2Subtract(mousePosition, mouseLastPosition);
+            mouseLastPosition = mousePosition;
+
+            Vector3 lastPosition = camera.view.position;
+            UpdateCameraCustom(&camera, mouseDelta, dt * speedScale);
+
+            if (dt > 0.0f)
+                velocity = Vector3Scale(Vector3Subtract(camera.view.position, lastPosition), 1.0f / dt);
+        }
+
+        if (IsInputKeyPressed(KEY_F3))
+        {
+            if (paused)
+            {
+                paused = false;
+                DisableCursor();
+            }
+            else
+            {
+                paused = true;
+                EnableCursor();
+            }
+        }
+
+        // Fly faster to stress the loader
+        if (IsInputKeyPressed(KEY_UP))
+            speedScale *= 2.0f;
+        if (IsInputKeyPressed(KEY_DOWN))
+            speedScale = fmaxf(speedScale * 0.5f, 1.0f);
+
+        UpdateInstanceStream(stream, camera.view.position, velocity, LOAD_RADIUS, PREFETCH_TIME);
+        //----------------------------------------------------------------------------------
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+        ClearBackground((Color) { 26, 26, 26, 255 });
+
+        BeginMode3D(camera.view);
+        DrawInstanceStream(stream, camera.view.position);
+        EndMode3D();
+
+        StreamStats stats = stream->stats;
+        DrawRectangle(0, 0, GetScreenWidth(), 40, BLACK);
+        DrawText(TextFormat("rocks: %i", stats.drawnInstances), 120, 10, 20, GREEN);
+        DrawText(TextFormat("speed: x%.0f", speedScale), 550, 10, 20, MAROON);
+
+        DrawText(TextFormat("chunks: %i / %i wanted, pending: %i, loaded: %i, generated: %i, evicted: %i",
+                     stats.resident, stats.wanted, stats.pending, stats.loaded, stats.generated, stats.evicted),
+            10, GetScreenHeight() - 40, 14, MAROON);
+        DrawText(TextFormat("upload: %i KB, frame: %.2f ms", stats.uploadedBytes / 1024, GetFrameTime() * 1000.0f), 10, GetScreenHeight() - 20, 14, MAROON);
+
+        DrawFPS(10, 10);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadInstanceStream(stream);
+    UnloadModel(rock);
+
+    UnloadInputReplay(input);
+
+    CloseWindow(); // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -6,6 +6,10 @@
 
 #include "raylib.h"
 #include "rlgl.h"
+#include "frame_memory.h"
+#include "input_replay.h"
+#include "render_batch_ring.h"
+#include "spatial_grid.h"
 
 // Required for: malloc(), free()
 #include <stdlib.h>
@@ -13,7 +17,11 @@
 // Required for: offsetof()
 #include <stddef.h>
 
-#define MAX_PARTICLES 100000
+// Particles limit, only address space is reserved up front
+#define MAX_PARTICLES 4000000
+
+// Particle collision circle
+#define PARTICLE_RADIUS 8.0f
 
 typedef struct Particle {
     Vector2 position;
@@ -22,7 +30,32 @@ typedef struct Particle {
     float lifetime;
 } Particle;
 
-int main(void)
+// Load particles buffer of capacity particles, set as instance attributes of the batch vertex array
+unsigned int LoadParticleBuffer(rlRenderBatch batch, Shader shader, int capacity)
+{
+    rlEnableVertexArray(batch.vertexBuffer[0].vaoId);
+    unsigned int buffer = rlLoadVertexBuffer(NULL, capacity * sizeof(Particle), true);
+
+    // Shader attribute locations
+    int positionAttrib = rlGetLocationAttrib(shader.id, "particlePosition");
+    int colorAttrib = rlGetLocationAttrib(shader.id, "particleColor");
+
+    // instanced particle positions(2 x float = 2 x GL_FLOAT)
+    rlEnableVertexAttribute(positionAttrib);
+    rlSetVertexAttribute(positionAttrib, 2, RL_FLOAT, false, sizeof(Particle), (void*)0);
+    rlSetVertexAttributeDivisor(positionAttrib, 1);
+
+    // instanced bunny colors(4 x unsigned char = 4 x GL_UNSIGNED_BYTE)
+    rlEnableVertexAttribute(colorAttrib);
+    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(Particle), (void*)offsetof(Particle, color));
+    rlSetVertexAttributeDivisor(colorAttrib, 1);
+
+    rlDisableVertexArray();
+
+    return buffer;
+}
+
+int main(int argc, char** argv)
 {
     // Initialization
     //--------------------------------------------------------------------------------------
@@ -31,66 +64,66 @@ int main(void)
 
     InitWindow(screenWidth, screenHeight, "raylib [others] example - particles instanced");
 
+    // Input is recorded or replayed with "--record <file>" / "--replay <file>" (see input_replay.h)
+    InputReplay* input = LoadInputReplay(argc, argv, 1.0f / 60.0f);
+
     Texture2D texParticle = LoadTexture("resources/wabbit_alpha.png");
     Shader shader = LoadShader("resources/shaders/asteroids_instanced.vs", "resources/shaders/asteroids_instanced.fs");
 
-    // Particles array
-    Particle* particles = (Particle*)RL_CALLOC(MAX_PARTICLES, sizeof(Particle));
+    // Particles array, pages are committed as particles spawn and the array never moves
+    InstanceStore particleStore = LoadInstanceStore(sizeof(Particle), MAX_PARTICLES, 8192);
+    Particle* particles = (Particle*)particleStore.data;
 
     // Particles counter
     int particleCount = 0;
 
-    // Configure instanced array
+    // Configure instanced array, the particles buffer grows with the store
     //--------------------------------------------------------------------------------------
     rlRenderBatch batch = rlLoadRenderBatch(1, 8192);
     batch.instances = 100;
 
-    rlEnableVertexArray(batch.vertexBuffer[0].vaoId);
-    int buffer = rlLoadVertexBuffer(&particles, particleCount * sizeof(Particle), true);
-
-    // Shader attribute locations
-    int positionAttrib = rlGetLocationAttrib(shader.id, "particlePosition");
-    int colorAttrib = rlGetLocationAttrib(shader.id, "particleColor");
-
-    // instanced particle positions(2 x float = 2 x GL_FLOAT)
-    rlEnableVertexAttribute(positionAttrib);
-    rlSetVertexAttribute(positionAttrib, 2, RL_FLOAT, false, sizeof(Particle), (void*)0);
-    rlSetVertexAttributeDivisor(positionAttrib, 1);
-
-    // instanced bunny colors(4 x unsigned char = 4 x GL_UNSIGNED_BYTE)
-    rlEnableVertexAttribute(colorAttrib);
-    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(Particle), (void*)offsetof(Particle, color));
-    rlSetVertexAttributeDivisor(colorAttrib, 1);
+    unsigned int buffer = LoadParticleBuffer(batch, shader, particleStore.gpuCapacity);
 
-    rlDisableVertexArray();
+    // Non-instanced particles are drawn through a fenced ring of batches
+    RenderBatchRing batchRing = LoadRenderBatchRing(2, 4, RL_DEFAULT_BATCH_BUFFER_ELEMENTS, particleStore.gpuCapacity);
 
     bool drawInstanced = true;
 
-    SetTargetFPS(60); // Set our game to run at 60 frames-per-second.
+    // Falling particles push each other aside, grid cells are a particle collision diameter wide
+    SpatialGrid* grid = LoadSpatialGrid(PARTICLE_RADIUS * 2.0f, 0);
+    bool collisions = false;
+
+    SetTargetFPS((input->mode == INPUT_REPLAY) ? 0 : 60); // Set our game to run at 60 frames-per-second, replays run uncapped.
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose()) // Detect window close button or ESC key.
+    while (!WindowShouldClose() && !IsInputReplayFinished()) // Detect window close button or ESC key.
     {
         // Update
         //----------------------------------------------------------------------------------
-        if (IsKeyPressed(KEY_ONE))
+        UpdateInputReplay(input);
+
+        if (IsInputKeyPressed(KEY_ONE))
         {
             drawInstanced = false;
         }
-        if (IsKeyPressed(KEY_TWO))
+        if (IsInputKeyPressed(KEY_TWO))
         {
             drawInstanced = true;
         }
 
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
+        // Toggle particle collisions
+        if (IsInputKeyPressed(KEY_C))
+            collisions = !collisions;
+
+        if (IsInputMouseButtonDown(MOUSE_LEFT_BUTTON))
         {
             // Create more particles.
             for (int i = 0; i < 100; i++)
             {
-                if (particleCount < MAX_PARTICLES)
+                if (PushInstanceStore(&particleStore, 1) != NULL)
                 {
-                    particles[particleCount].position = GetMousePosition();
+                    particles[particleCount].position = GetInputMousePosition();
                     particles[particleCount].speed.x = 0.0f;
                     particles[particleCount].speed.y = GetRandomValue(0, 250) / 60.0f;
                     particles[particleCount].color = (Color) { GetRandomValue(50, 240),
@@ -105,7 +138,7 @@ int main(void)
         }
 
         // Update particles
-        float dt = GetFrameTime();
+        float dt = GetInputFrameTime();
         for (int i = 0; i < particleCount; i++)
         {
             particles[i].position.x += particles[i].speed.x;
@@ -113,6 +146,20 @@ int main(void)
             particles[i].lifetime -= dt;
         }
 
+        if (collisions)
+        {
+            BuildSpatialGrid(grid, particles, particleCount, sizeof(Particle), (Rectangle) { 0, 0, GetScreenWidth(), GetScreenHeight() });
+            CollideSpatialGrid(grid, offsetof(Particle, speed), PARTICLE_RADIUS, 0.5f);
+        }
+
+        // GPU buffers grow with the particles store
+        if (UpdateInstanceStoreCapacity(&particleStore))
+        {
+            rlUnloadVertexBuffer(buffer);
+            buffer = LoadParticleBuffer(batch, shader, particleStore.gpuCapacity);
+            batchRing.maxElements = particleStore.gpuCapacity;
+        }
+
         // Re-upload particles array every frame to apply movement
         batch.instances = particleCount;
         rlUpdateVertexBuffer(buffer, particles, particleCount * sizeof(Particle), 0);
@@ -134,22 +181,37 @@ int main(void)
         }
         else
         {
+            // NOTE: When the batch buffer limit is reached a draw call is launched and buffer starts
+            // being filled again, the ring grows its capacity so following frames draw in one flush,
+            // and only refills a batch the GPU finished reading (no stall on in-use buffers)
+            BeginRenderBatchRing(&batchRing);
             for (int i = 0; i < particleCount; i++)
             {
-                // NOTE: When internal batch buffer limit is reached (MAX_BATCH_ELEMENTS),
-                // a draw call is launched and buffer starts being filled again;
-                // before issuing a draw call, updated vertex data from internal CPU buffer is send to GPU...
-                // Process of sending data is costly and it could happen that GPU data has not been completely
-                // processed for drawing while new data is tried to be sent (updating current in-use buffers)
-                // it could generates a stall and consequently a frame drop, limiting the number of drawn particles
                 DrawTexture(texParticle, particles[i].position.x, particles[i].position.y, particles[i].color);
             }
+            EndRenderBatchRing(&batchRing);
         }
 
         DrawRectangle(0, 0, screenWidth, 40, BLACK);
         DrawText(TextFormat("particles: %i", particleCount), 120, 10, 20, GREEN);
         DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
 
+        if (!drawInstanced)
+        {
+            RenderBatchStats stats = batchRing.stats;
+            DrawText(TextFormat("draw calls: %i, forced flushes: %i, padding: %i, waits: %i",
+                         stats.drawCalls, stats.forcedFlushes, stats.paddingVertices, stats.syncWaits),
+                10, GetScreenHeight() - 20, 14, MAROON);
+        }
+
+        if (collisions)
+        {
+            SpatialGridStats stats = grid->stats;
+            DrawText(TextFormat("grid: %i threads, rebuild: %.2f ms, collide: %.2f ms, contacts: %i, fullest cell: %i",
+                         grid->pool->threadCount, stats.buildTime * 1000.0, stats.collideTime * 1000.0, stats.contacts, stats.maxCellCount),
+                10, GetScreenHeight() - 40, 14, MAROON);
+        }
+
         DrawFPS(10, 10);
 
         EndDrawing();
@@ -158,12 +220,17 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
-    RL_FREE(particles); // Unload particles data array
+    UnloadInstanceStore(&particleStore); // Unload particles data array
+
+    UnloadSpatialGrid(grid);
 
     rlUnloadVertexBuffer(buffer);
     rlUnloadRenderBatch(batch);
+    UnloadRenderBatchRing(&batchRing);
     UnloadShader(shader);
 
+    UnloadInputReplay(input);
+
     CloseWindow(); // Close window and Openrl context
     //--------------------------------------------------------------------------------------
 
@@ -8,8 +8,17 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "rlgl.h"
+#include "rlgl_buffer_texture.h"
+#include "render_batch_ring.h"
 #include <stddef.h>
 
+// Grid size limits, the largest grid draws a million quads
+#define MIN_GRID_SIZE 10
+#define MAX_GRID_SIZE 1000
+
+// Largest batch used by the non-instanced path, bigger grids are drawn in several flushes
+#define MAX_BATCH_ELEMENTS 262144
+
 // Get the viewport rectangle from the current opengl context.
 Rectangle GetViewport()
 {
@@ -45,6 +54,34 @@ Vector2 NormalizedToScreen(Vector2 deviceCoords)
     return screen;
 }
 
+// Generate a grid of quad locations/translation-vectors in normalized device coordinates.
+void GenerateTranslations(Vector2* translations, int gridSize)
+{
+    float step = 2.0f / (float)gridSize;
+    int index = 0;
+    for (int y = 0; y < gridSize; y++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            Vector2 translation = { 0 };
+            translation.x = -1.0f + x * step + step / 2.0f;
+            translation.y = -1.0f + y * step + step / 2.0f;
+            translations[index] = translation;
+            index += 1;
+        }
+    }
+}
+
+// Get quad size in screen coordinates for a grid size.
+Vector2 GetQuadSize(int gridSize)
+{
+    float halfStep = 1.0f / (float)gridSize;
+    Vector2 size = NormalizedToScreen((Vector2) { halfStep, halfStep });
+    size.x -= GetScreenWidth() / 2;
+    size.y -= GetScreenHeight() / 2;
+    return size;
+}
+
 int main(void)
 {
     // Initialization
@@ -56,40 +93,36 @@ int main(void)
 
     Shader shader = LoadShader("resources/shaders/quads_instanced.vs", "resources/shaders/quads_instanced.fs");
 
-    // Generate a list of 100 quad locations/translation-vectors
+    // Generate a list of quad locations/translation-vectors
     // These are in normalized device coordinates.
     // You need to convert them if using raylib functions to draw.
     //--------------------------------------------------------------------------------------
-    Vector2 translations[100];
-    int index = 0;
-    float offset = 0.1f;
-    for (int y = -10; y < 10; y += 2)
-    {
-        for (int x = -10; x < 10; x += 2)
-        {
-            Vector2 translation = { 0 };
-            translation.x = (float)x / 10.0f + offset;
-            translation.y = (float)y / 10.0f + offset;
-            translations[index] = translation;
-            index += 1;
-        }
-    }
+    int gridSize = MIN_GRID_SIZE;
+    int instanceCount = gridSize * gridSize;
+    Vector2* translations = (Vector2*)RL_CALLOC(MAX_GRID_SIZE * MAX_GRID_SIZE, sizeof(Vector2));
+    GenerateTranslations(translations, gridSize);
 
     // Configure instanced buffer
+    // Offsets are read from a buffer texture so they are not capped by uniform storage
     // -------------------------
     rlRenderBatch batch = rlLoadRenderBatch(1, 1);
-    batch.instances = 100;
+    batch.instances = instanceCount;
 
-    int loc = GetShaderLocation(shader, "offsets");
-    SetShaderValueV(shader, loc, &translations, SHADER_UNIFORM_VEC2, 1);
+    // Non-instanced quads are drawn through a fenced ring of batches
+    RenderBatchRing batchRing = LoadRenderBatchRing(2, 4, RL_DEFAULT_BATCH_BUFFER_ELEMENTS, MAX_BATCH_ELEMENTS);
 
-    Vector2 size = NormalizedToScreen((Vector2) { 0.10f, 0.10f });
-    size.x -= GetScreenWidth() / 2;
-    size.y -= GetScreenHeight() / 2;
+    rlBufferTexture offsets = rlLoadBufferTexture(NULL, MAX_GRID_SIZE * MAX_GRID_SIZE * sizeof(Vector2), RL_BUFFER_TEXTURE_RG32F, true);
+    rlUpdateBufferTexture(offsets, translations, instanceCount * sizeof(Vector2), 0);
 
-    bool drawInstanced = false;
+    // Offsets buffer texture is bound to slot 1, slot 0 is used by texture0
+    int offsetsSlot = 1;
+    int instanceBase = 0;
+    SetShaderValue(shader, GetShaderLocation(shader, "offsets"), &offsetsSlot, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "instanceBase"), &instanceBase, SHADER_UNIFORM_INT);
+
+    Vector2 size = GetQuadSize(gridSize);
 
-    const int instanceCount = 100;
+    bool drawInstanced = false;
 
     SetTargetFPS(60); // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
@@ -103,6 +136,20 @@ int main(void)
             drawInstanced = false;
         if (IsKeyPressed(KEY_TWO))
             drawInstanced = true;
+
+        // Change grid size
+        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN))
+        {
+            gridSize = IsKeyPressed(KEY_UP) ? gridSize * 10 : gridSize / 10;
+            gridSize = Clamp(gridSize, MIN_GRID_SIZE, MAX_GRID_SIZE);
+            instanceCount = gridSize * gridSize;
+
+            GenerateTranslations(translations, gridSize);
+            rlUpdateBufferTexture(offsets, translations, instanceCount * sizeof(Vector2), 0);
+
+            batch.instances = instanceCount;
+            size = GetQuadSize(gridSize);
+        }
         //--------------------------------------------------------------------------------------
 
         // Draw
@@ -114,6 +161,7 @@ int main(void)
         {
             // Draw instanced quads
             BeginShaderMode(shader);
+            rlEnableBufferTexture(offsets, offsetsSlot);
             rlSetRenderBatchActive(&batch);
             // rlViewport(0, 0, 1, 1);
 
@@ -130,11 +178,13 @@ int main(void)
 
             // rlViewport(0, 0, GetScreenWidth(), GetScreenHeight());
             rlSetRenderBatchActive(NULL);
+            rlDisableBufferTexture(offsetsSlot);
             EndShaderMode();
         }
         else
         {
             // Draw each quad in a loop(convert normalized coords)
+            BeginRenderBatchRing(&batchRing);
             for (int i = 0; i < instanceCount; i += 1)
             {
                 Vector2 position = NormalizedToScreen((Vector2) { translations[i].x, translations[i].y });
@@ -146,11 +196,21 @@ int main(void)
                     (Color) { 0, 255, 255, 255 }
                 );
             }
+            EndRenderBatchRing(&batchRing);
         }
 
         DrawRectangle(0, 0, screenWidth, 40, BLACK);
+        DrawText(TextFormat("quads: %i", instanceCount), 120, 10, 20, GREEN);
         DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
 
+        if (!drawInstanced)
+        {
+            RenderBatchStats stats = batchRing.stats;
+            DrawText(TextFormat("draw calls: %i, forced flushes: %i, padding: %i, waits: %i",
+                         stats.drawCalls, stats.forcedFlushes, stats.paddingVertices, stats.syncWaits),
+                10, GetScreenHeight() - 20, 14, MAROON);
+        }
+
         DrawFPS(10, 10);
 
         EndDrawing();
@@ -159,6 +219,11 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    RL_FREE(translations); // Unload translations data array
+
+    rlUnloadBufferTexture(offsets);
+    rlUnloadRenderBatch(batch);
+    UnloadRenderBatchRing(&batchRing);
     UnloadShader(shader); // Unload shader
 
     CloseWindow(); // Close window and OpenGL context
@@ -7,10 +7,27 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "rlgl.h"
+#include "dynamic_resolution.h"
+#include "render_batch_ring.h"
+#include "shapes_sdf.h"
+#include "text_instanced.h"
 
 // Required for: malloc(), free()
 #include <stdlib.h>
 
+// Instance count limits, changed with UP/DOWN
+#define MIN_INSTANCES 30
+#define MAX_INSTANCES 1000000
+
+// Largest batch used by the non-instanced path, more shapes are drawn in several flushes
+#define MAX_BATCH_ELEMENTS 262144
+
+// Instanced text glyph capacity, label count of DRAW_TEXT is clamped to fit
+#define MAX_TEXT_GLYPHS 240000
+
+// Label drawn by DRAW_TEXT
+#define TEXT_LABEL "Text!"
+
 typedef enum DrawCommandType {
     DRAW_LINE,
     DRAW_TRIANGLE,
@@ -65,7 +82,7 @@ void DrawCommand(int command, Vector2 position, Texture2D texture, Color color)
             DrawCircleLines(x + 25, y + 25, 25, color);
             break;
         case DRAW_TEXT:
-            DrawText("Text!", x, y, 20, color);
+            DrawText(TEXT_LABEL, x, y, 20, color);
             break;
         case DRAW_TEXTURE:
             DrawTexture(texture, x, y, WHITE);
@@ -75,6 +92,39 @@ void DrawCommand(int command, Vector2 position, Texture2D texture, Color color)
     }
 }
 
+// Draw commands with an SDF equivalent, evaluated on a single quad
+bool IsSdfCommand(int command)
+{
+    return (command == DRAW_LINE) || (command == DRAW_RECTANGLE) || (command == DRAW_RECTANGLE_LINE) || (command == DRAW_CIRCLE) || (command == DRAW_CIRCLE_LINE);
+}
+
+void DrawCommandSdf(SdfShapeRenderer* renderer, int command, Vector2 position, Color color)
+{
+    float x = position.x;
+    float y = position.y;
+
+    switch (command)
+    {
+        case DRAW_LINE:
+            DrawLineSdf(renderer, (Vector2) { x, y }, (Vector2) { x + 50.0f, y }, 1.0f, SDF_CAP_BUTT, color);
+            break;
+        case DRAW_RECTANGLE:
+            DrawRectangleSdf(renderer, (Rectangle) { x, y, 50, 50 }, 0.0f, 0.0f, color);
+            break;
+        case DRAW_RECTANGLE_LINE:
+            DrawRectangleSdf(renderer, (Rectangle) { x, y, 50, 50 }, 0.0f, 3.0f, color);
+            break;
+        case DRAW_CIRCLE:
+            DrawCircleSdf(renderer, (Vector2) { x + 25.0f, y + 25.0f }, 25.0f, color);
+            break;
+        case DRAW_CIRCLE_LINE:
+            DrawRingSdf(renderer, (Vector2) { x + 25.0f, y + 25.0f }, 25.0f, 1.0f, color);
+            break;
+        default:
+            break;
+    }
+}
+
 int main(void)
 {
     // Initialization
@@ -85,8 +135,8 @@ int main(void)
     SetConfigFlags(FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);
     InitWindow(screenWidth, screenHeight, "raylib [others] example - 2d instancing testbed");
 
-    RenderTexture2D target = LoadRenderTexture(screenWidth, screenHeight);
-    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    // Scene is rendered offscreen at a scale holding 14 ms of GPU time, HUD stays at native resolution
+    DynamicResolution resolution = LoadDynamicResolution(0.014f, 0.5f, 1.0f);
 
     Texture2D texture = LoadTexture("resources/images/wabbit_alpha.png");
     Shader instanceShader = LoadShader("resources/shaders/shapes_instanced_2d.vs", NULL);
@@ -96,7 +146,20 @@ int main(void)
     rlRenderBatch batch = rlLoadRenderBatch(1, 36);
     batch.instances = 300;
 
+    // Instanced text, glyphs of all labels are drawn with one instanced draw
+    TextRenderer textRenderer = LoadTextRenderer(GetFontDefault(), MAX_TEXT_GLYPHS);
+    int textGlyphs = GetTextLayout(&textRenderer, TEXT_LABEL, 20, 2).glyphCount;
+    int maxTextLabels = (textGlyphs > 0) ? MAX_TEXT_GLYPHS / textGlyphs : MAX_INSTANCES;
+    bool textClamped = false;
+
+    // SDF shapes, one quad per shape evaluated in the fragment shader
+    SdfShapeRenderer sdfRenderer = LoadSdfShapeRenderer(MAX_INSTANCES);
+    // Non-instanced shapes are drawn through a fenced ring of batches
+    RenderBatchRing batchRing = LoadRenderBatchRing(2, 4, RL_DEFAULT_BATCH_BUFFER_ELEMENTS, MAX_BATCH_ELEMENTS);
+    double submitTime = 0.0;
+
     bool drawInstanced = false;
+    bool drawSdf = false;
 
     // 2D camera mode
     Camera2D camera = { 0 };
@@ -125,11 +188,22 @@ int main(void)
         if (IsKeyDown(KEY_D))
             camera.target.x += (int)(300.0f * dt);
 
-        // Turn instancing on/off
+        // Turn instancing on/off, SDF shapes replace the tessellated instance
         if (IsKeyPressed(KEY_ONE))
+        {
             drawInstanced = false;
+            drawSdf = false;
+        }
         if (IsKeyPressed(KEY_TWO))
+        {
             drawInstanced = true;
+            drawSdf = false;
+        }
+        if (IsKeyPressed(KEY_THREE))
+        {
+            drawInstanced = true;
+            drawSdf = true;
+        }
 
         // Switch between draw commands
         if (IsKeyPressed(KEY_LEFT))
@@ -142,12 +216,21 @@ int main(void)
         if (command < 0)
             command = MAX_DRAW_TYPES - 1;
 
+        // Change instance count
+        if (IsKeyPressed(KEY_UP))
+            batch.instances = (batch.instances * 10 > MAX_INSTANCES) ? MAX_INSTANCES : batch.instances * 10;
+        if (IsKeyPressed(KEY_DOWN))
+            batch.instances = (batch.instances / 10 < MIN_INSTANCES) ? MIN_INSTANCES : batch.instances / 10;
+
         int wheelMove = GetMouseWheelMove();
         if (wheelMove != 0)
         {
             camera.zoom += ((float)GetMouseWheelMove() * 0.05f);
         }
 
+        // Toggle dynamic resolution
+        UpdateDynamicResolutionToggle(&resolution);
+
         // Reset test
         if (IsKeyPressed(KEY_R))
         {
@@ -156,16 +239,60 @@ int main(void)
             camera.rotation = 0.0f;
             camera.zoom = 1.0f;
         }
+
+        // Text labels are clamped to the glyph buffer, both text paths draw the same labels
+        int instanceCount = batch.instances;
+        if ((command == DRAW_TEXT) && (instanceCount > maxTextLabels))
+            instanceCount = maxTextLabels;
+
+        if ((instanceCount != batch.instances) != textClamped)
+        {
+            textClamped = (instanceCount != batch.instances);
+            if (textClamped)
+                TraceLog(LOG_WARNING, "TEXT: Labels clamped to %i (%i glyphs maximum)", maxTextLabels, MAX_TEXT_GLYPHS);
+        }
         //----------------------------------------------------------------------------------
 
         // Draw
         //----------------------------------------------------------------------------------
         BeginDrawing();
+
+        BeginDynamicResolution(&resolution);
         ClearBackground(RAYWHITE);
 
         BeginMode2D(camera);
 
-        if (drawInstanced)
+        double submitStart = GetTime();
+
+        if (drawSdf && IsSdfCommand(command))
+        {
+            int width = 30;
+            BeginSdfShapes(&sdfRenderer);
+            for (int i = 0; i < instanceCount; i++)
+            {
+                Vector2 position = { i % width, i / width };
+                position.x += position.x * 50.0f;
+                position.y += position.y * 50.0f;
+                DrawCommandSdf(&sdfRenderer, command, position, BLUE);
+            }
+            EndSdfShapes(&sdfRenderer);
+        }
+        else if (drawInstanced && (command == DRAW_TEXT))
+        {
+            // Lay out every label on the CPU (repeated strings hit the layout cache)
+            // and draw all glyphs at once against the font atlas
+            int width = 30;
+            BeginTextInstanced(&textRenderer);
+            for (int i = 0; i < instanceCount; i++)
+            {
+                Vector2 position = { i % width, i / width };
+                position.x += position.x * 50.0f;
+                position.y += position.y * 50.0f;
+                DrawTextInstanced(&textRenderer, TEXT_LABEL, position, 20, 2, BLUE);
+            }
+            EndTextInstanced(&textRenderer);
+        }
+        else if (drawInstanced)
         {
             BeginShaderMode(instanceShader);
 
@@ -179,7 +306,8 @@ int main(void)
         else
         {
             int width = 30;
-            for (int i = 0; i < batch.instances; i++)
+            BeginRenderBatchRing(&batchRing);
+            for (int i = 0; i < instanceCount; i++)
             {
                 // % is the "modulo operator", the remainder of i / width;
                 // where "/" is an integer division
@@ -188,15 +316,32 @@ int main(void)
                 position.y += position.y * 50.0f;
                 DrawCommand(command, position, texture, BLUE);
             }
+            EndRenderBatchRing(&batchRing);
         }
 
+        submitTime = GetTime() - submitStart;
+
         EndMode2D();
 
+        EndDynamicResolution(&resolution);
+
         DrawRectangle(0, 0, screenWidth, 40, BLACK);
-        DrawText(TextFormat("instanceCount: %i", batch.instances), 120, 10, 20, GREEN);
+        DrawText(TextFormat("instanceCount: %i", instanceCount), 120, 10, 20, GREEN);
         DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
 
         DrawText(TextFormat("%s", drawTypeText[command]), 10, GetScreenHeight() - 20, 14, MAROON);
+        DrawText(TextFormat("submit: %.2f ms", submitTime * 1000.0), 200, GetScreenHeight() - 20, 14, MAROON);
+        DrawText(TextFormat("sdf: %i", drawSdf && IsSdfCommand(command)), 350, GetScreenHeight() - 20, 14, MAROON);
+
+        if (!drawInstanced && !(drawSdf && IsSdfCommand(command)))
+        {
+            RenderBatchStats stats = batchRing.stats;
+            DrawText(TextFormat("draw calls: %i, forced flushes: %i, padding: %i, waits: %i",
+                         stats.drawCalls, stats.forcedFlushes, stats.paddingVertices, stats.syncWaits),
+                10, GetScreenHeight() - 40, 14, MAROON);
+        }
+
+        DrawDynamicResolutionStats(&resolution, 10, GetScreenHeight() - 60);
 
         DrawFPS(10, 10);
 
@@ -206,8 +351,11 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    UnloadSdfShapeRenderer(&sdfRenderer);
+    UnloadTextRenderer(&textRenderer);
+    UnloadRenderBatchRing(&batchRing);
     UnloadShader(instanceShader);
-    UnloadRenderTexture(target);
+    UnloadDynamicResolution(&resolution);
 
     CloseWindow(); // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 #include "raylib.h"
 #include "rlgl.h"
 #include "camera_first_person.h"
+#include "rlgl_capture.h"
 
 // Required for: malloc(), free()
 #include <stdlib.h>
@@ -68,7 +69,7 @@ void DrawCommand(int command, Color color)
     }
 }
 
-int main(void)
+int main(int argc, char** argv)
 {
     // Initialization
     //--------------------------------------------------------------------------------------
@@ -77,57 +78,75 @@ int main(void)
 
     InitWindow(screenWidth, screenHeight, "raylib [others] example - 3d instancing testbed");
 
+    // Input is recorded or replayed with "--record <file>" / "--replay <file>" (see input_replay.h)
+    InputReplay* input = LoadInputReplay(argc, argv, 1.0f / 60.0f);
+
     Shader instancedShader = LoadShader("resources/shaders/shapes_instanced_3d.vs", NULL);
 
-    // Configure instanced buffer
-    // -------------------------
-    rlRenderBatch batch = rlLoadRenderBatch(1, 512);
-    batch.instances = 300;
+    const int instanceCount = 300;
 
     bool drawInstanced = true;
     int command = DRAW_LINE_3D;
 
+    // Record the shape tessellation once, it is only replayed while drawing
+    // -------------------------
+    rlBeginCapture();
+    DrawCommand(command, BLUE);
+    rlCapturedMesh shape = rlEndCapture();
+
     // Define the camera to look into our 3d world
     CameraFP camera = LoadCameraFP((Vector3){ 0.0f, 14.0f, 240.0f });
     camera.view.position = (Vector3){ 0.0f, 30.0f, 200.0f };
 
-    Vector2 mousePosition = GetMousePosition();
+    Vector2 mousePosition = GetInputMousePosition();
     Vector2 mouseLastPosition = mousePosition;
 
-    SetTargetFPS(60); // Set our game to run at 60 frames-per-second
+    SetTargetFPS((input->mode == INPUT_REPLAY) ? 0 : 60); // Set our game to run at 60 frames-per-second, replays run uncapped
     DisableCursor();
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose()) // Detect window close button or ESC key
+    while (!WindowShouldClose() && !IsInputReplayFinished()) // Detect window close button or ESC key
     {
         // Update
         //----------------------------------------------------------------------------------
-        mousePosition = GetMousePosition();
+        UpdateInputReplay(input);
+
+        mousePosition = GetInputMousePosition();
         Vector2 mouseDelta = Vector2Subtract(mousePosition, mouseLastPosition);
         mouseLastPosition = mousePosition;
 
         if (camera.view.projection == CAMERA_CUSTOM)
         {
-            UpdateCameraCustom(&camera, mouseDelta, GetFrameTime());
+            UpdateCameraCustom(&camera, mouseDelta, GetInputFrameTime());
         }
 
         // Turn instancing on/off
-        if (IsKeyPressed(KEY_ONE))
+        if (IsInputKeyPressed(KEY_ONE))
             drawInstanced = false;
-        if (IsKeyPressed(KEY_TWO))
+        if (IsInputKeyPressed(KEY_TWO))
             drawInstanced = true;
 
         // Set draw command
-        if (IsKeyPressed(KEY_LEFT))
+        if (IsInputKeyPressed(KEY_LEFT))
             command -= 1;
-        if (IsKeyPressed(KEY_RIGHT))
+        if (IsInputKeyPressed(KEY_RIGHT))
             command += 1;
 
         if (command < 0)
             command = MAX_DRAW_TYPES - 1;
         if (command > MAX_DRAW_TYPES - 1)
             command = 0;
+
+        // Re-capture shape when draw command changes
+        if (IsInputKeyPressed(KEY_LEFT) || IsInputKeyPressed(KEY_RIGHT))
+        {
+            rlUnloadCapturedMesh(shape);
+
+            rlBeginCapture();
+            DrawCommand(command, BLUE);
+            shape = rlEndCapture();
+        }
         //----------------------------------------------------------------------------------
 
         // Draw
@@ -141,14 +160,7 @@ int main(void)
 
         if (drawInstanced)
         {
-            rlSetRenderBatchActive(&batch);
-
-            BeginShaderMode(instancedShader);
-            DrawCommand(command, BLUE);
-            EndShaderMode();
-
-            rlDrawRenderBatch(&batch);
-            rlSetRenderBatchActive(NULL);
+            rlDrawCapturedMeshInstanced(shape, instancedShader, instanceCount);
         }
         else
         {
@@ -158,7 +170,7 @@ int main(void)
         EndMode3D();
 
         DrawRectangle(0, 0, screenWidth, 40, BLACK);
-        DrawText(TextFormat("instanceCount: %i", batch.instances), 120, 10, 20, GREEN);
+        DrawText(TextFormat("instanceCount: %i", instanceCount), 120, 10, 20, GREEN);
         DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
 
         DrawText(TextFormat("%s", drawTypeText[command]), 10, GetScreenHeight() - 20, 14, MAROON);
@@ -171,9 +183,11 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
-    rlUnloadRenderBatch(batch);
+    rlUnloadCapturedMesh(shape);
     UnloadShader(instancedShader);
 
+    UnloadInputReplay(input);
+
     CloseWindow(); // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
@@ -9,6 +9,19 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "rlgl.h"
+#include "batch_builder.h"
+#include "draw_cost_model.h"
+#include "draw_queue.h"
+#include "dynamic_resolution.h"
+#include "frame_memory.h"
+#include "input_replay.h"
+#include "instance_sort.h"
+#include "render_batch_ring.h"
+#include "shader_variants.h"
+#include "spatial_grid.h"
+#include "rlgl_buffer_texture.h"
+#include "sprite_atlas.h"
+#include "vertex_pulling.h"
 
 // Required for: malloc(), free()
 #include <stdlib.h>
@@ -19,8 +32,17 @@
 #define min(a,b) (((a)<(b))?(a):(b))
 #define max(a,b) (((a)>(b))?(a):(b))
 
-// 500K bunnies limit with instancing!
-#define MAX_BUNNIES 500000
+// 4M bunnies limit with instancing, only address space is reserved up front!
+#define MAX_BUNNIES 4000000
+
+// Largest transient data of a frame, sorted copy of every bunny (Bunny is defined below)
+#define FRAME_ARENA_SIZE ((size_t)MAX_BUNNIES * sizeof(Bunny) + (1 << 20))
+
+// Bunnies drawn with every submission path at startup to calibrate the cost model
+#define CALIBRATION_BUNNIES 65536
+
+// Bunny collision circle, smaller than the sprite so crowds still read as bunnies
+#define BUNNY_RADIUS 8.0f
 
 // This is the maximum amount of elements (quads) per batch
 // NOTE: This value is defined in [rlgl] module and can be changed there
@@ -29,9 +51,149 @@ typedef struct Bunny {
     Vector2 position;
     Vector2 speed;
     Color color;
+    unsigned int sprite;
 } Bunny;
 
-int main(void)
+// Draw paths, selected with number keys (adaptive selects batched, instanced or indirect)
+typedef enum DrawPath {
+    DRAW_ADAPTIVE,
+    DRAW_BATCHED,
+    DRAW_INSTANCED,
+    DRAW_BUFFER_TEXTURE,
+    DRAW_VERTEX_PULLING,
+    DRAW_SPRITE_ATLAS,
+    DRAW_QUEUED,
+    DRAW_THREADED,
+    DRAW_INDIRECT,
+    MAX_DRAW_PATHS
+} DrawPath;
+
+static const char* drawPathText[] = {
+    "DRAW_ADAPTIVE",
+    "DRAW_BATCHED",
+    "DRAW_INSTANCED",
+    "DRAW_BUFFER_TEXTURE",
+    "DRAW_VERTEX_PULLING",
+    "DRAW_SPRITE_ATLAS",
+    "DRAW_QUEUED",
+    "DRAW_THREADED",
+    "DRAW_INDIRECT",
+};
+
+// Draw path of each submission the cost model can select
+static const int submissionDrawPaths[DRAW_SUBMIT_COUNT] = {
+    DRAW_BATCHED,
+    DRAW_INSTANCED,
+    DRAW_INDIRECT,
+};
+
+// Bunny draw group, every submission path the cost model selects from
+typedef struct BunnyDraw {
+    const Bunny* bunnies;
+    Texture2D texture;
+    RenderBatchRing* batchRing;     // Batched, bunny quads written to a ring batch
+    rlRenderBatch* batch;           // Instanced, one bunny quad with instance attributes
+    Shader shader;
+    rlGeometryPool* geometryPool;   // Indirect, pulled bunny quad
+    rlGeometryRange quad;
+    rlInstancePool* instancePool;
+    Shader pulledShader;
+    unsigned int indirectBuffer;
+} BunnyDraw;
+
+// Draw the first instanceCount bunnies with a submission path (DrawGroupCallback)
+void DrawBunnies(int submission, int instanceCount, void* userData)
+{
+    BunnyDraw* draw = (BunnyDraw*)userData;
+
+    if (submission == DRAW_SUBMIT_BATCHED)
+    {
+        // NOTE: When the batch buffer limit is reached a draw call is launched and buffer starts
+        // being filled again, the ring grows its capacity so following frames draw in one flush,
+        // and only refills a batch the GPU finished reading (no stall on in-use buffers)
+        BeginRenderBatchRing(draw->batchRing);
+        for (int i = 0; i < instanceCount; i++)
+        {
+            DrawTexture(draw->texture, draw->bunnies[i].position.x, draw->bunnies[i].position.y, draw->bunnies[i].color);
+        }
+        EndRenderBatchRing(draw->batchRing);
+    }
+    else if (submission == DRAW_SUBMIT_INSTANCED)
+    {
+        BeginShaderMode(draw->shader);
+        draw->batch->instances = instanceCount;
+        rlSetRenderBatchActive(draw->batch);
+        DrawTexture(draw->texture, 0, 0, WHITE);
+        rlDrawRenderBatchActive();
+        rlSetRenderBatchActive(NULL);
+        EndShaderMode();
+    }
+    else
+    {
+        rlDrawCommand command = { draw->quad.indexCount, instanceCount, 0, 0 };
+        rlUpdateIndirectBuffer(draw->indirectBuffer, &command, 1, 0);
+        DrawGeometryIndirect(*draw->geometryPool, draw->quad, *draw->instancePool, 0, draw->indirectBuffer, 0, draw->pulledShader, draw->texture);
+    }
+}
+
+// Record bunny quads, called on disjoint ranges from every recording thread
+void RecordBunnyQuads(const void* items, int start, int end, BatchVertex* vertices, const void* userData)
+{
+    const Bunny* bunnies = (const Bunny*)items;
+    Vector2 size = *(const Vector2*)userData;
+
+    for (int i = start; i < end; i++, vertices += 4)
+    {
+        Rectangle dest = { bunnies[i].position.x, bunnies[i].position.y, size.x, size.y };
+        WriteBatchQuad(vertices, dest, (Rectangle) { 0.0f, 0.0f, 1.0f, 1.0f }, bunnies[i].color);
+    }
+}
+
+// Load bunnies buffer of capacity bunnies, set as instance attributes of the batch vertex array
+unsigned int LoadBunnyBuffer(rlRenderBatch batch, Shader shader, int capacity)
+{
+    rlEnableVertexArray(batch.vertexBuffer[0].vaoId);
+    unsigned int buffer = rlLoadVertexBuffer(NULL, capacity * sizeof(Bunny), true);
+
+    // Shader attribute locations
+    int positionAttrib = rlGetLocationAttrib(shader.id, "instancePosition");
+    int colorAttrib = rlGetLocationAttrib(shader.id, "instanceColor");
+
+    // instanced bunny positions(2 x float = 2 x GL_FLOAT)
+    rlEnableVertexAttribute(positionAttrib);
+    rlSetVertexAttribute(positionAttrib, 2, RL_FLOAT, false, sizeof(Bunny), (void*)0);
+    rlSetVertexAttributeDivisor(positionAttrib, 1);
+
+    // instanced bunny colors(4 x unsigned char = 4 x GL_UNSIGNED_BYTE)
+    rlEnableVertexAttribute(colorAttrib);
+    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(Bunny), (void*)offsetof(Bunny, color));
+    rlSetVertexAttributeDivisor(colorAttrib, 1);
+
+    rlDisableVertexArray();
+
+    return buffer;
+}
+
+// Record the same draw list with 1 to maxThreads threads and log the average recording time
+void BenchmarkBatchBuilder(const Bunny* bunnies, int bunniesCount, Vector2 size, int maxThreads)
+{
+    for (int threads = 1; threads <= maxThreads; threads++)
+    {
+        BatchBuilder* builder = LoadBatchBuilder(threads);
+
+        double total = 0.0;
+        for (int i = 0; i < 20; i++)
+        {
+            RecordBatch(builder, RecordBunnyQuads, bunnies, bunniesCount, 4, &size);
+            total += builder->recordTime;
+        }
+
+        TraceLog(LOG_INFO, "BATCH: %i bunnies, %i threads: %.3f ms", bunniesCount, threads, total / 20.0 * 1000.0);
+        UnloadBatchBuilder(builder);
+    }
+}
+
+int main(int argc, char** argv)
 {
     // Initialization
     //--------------------------------------------------------------------------------------
@@ -41,67 +203,198 @@ int main(void)
     SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
     InitWindow(screenWidth, screenHeight, "raylib [textures] example - bunnymark instanced");
 
+    // Input is recorded or replayed with "--record <file>" / "--replay <file>" (see input_replay.h)
+    InputReplay* input = LoadInputReplay(argc, argv, 1.0f / 60.0f);
+
     // Load bunny texture
     Texture2D texBunny = LoadTexture("resources/images/wabbit_alpha.png");
 
-    Shader shader = LoadShader("resources/shaders/bunnymark_instanced.vs", "resources/shaders/bunnymark_instanced.fs");
-
-    // Bunnies array
-    Bunny* bunnies = (Bunny*)RL_CALLOC(MAX_BUNNIES, sizeof(Bunny));
+    // Instanced shaders are variants of one base shader, linked programs are cached between runs
+    ShaderVariantSet shaderVariants = LoadShaderVariantSet("resources/shaders/instanced.vs", "resources/shaders/instanced.fs", "instanced");
+    Shader shader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_COLOR);
+    Shader tboShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_INSTANCE_RECORDS | SHADER_FEATURE_INSTANCE_COLOR);
+    Shader pulledShader = GetShaderVariant(&shaderVariants, SHADER_FEATURE_VERTEX_PULLING | SHADER_FEATURE_INSTANCE_COLOR);
+    SetShaderPulledLocations(pulledShader);
+    Shader atlasShader = LoadShaderPulled("resources/shaders/bunnymark_atlas.vs", "resources/shaders/bunnymark_atlas.fs");
+
+    // Load sprite atlas, packed once and then loaded from the cache file
+    const char* spriteFiles[] = {
+        "resources/images/wabbit_alpha.png",
+        "resources/objects/rock/rock.png",
+        "resources/objects/planet/mars.png",
+    };
+    const int spriteCount = sizeof(spriteFiles) / sizeof(spriteFiles[0]);
+    SpriteAtlas atlas = LoadSpriteAtlas(spriteFiles, spriteCount, texBunny.width, "bunnymark_atlas.cache");
+
+    // Atlas texture array and entries slots (slots 0-4 are used by pulled draws)
+    int atlasSlot = 5;
+    int atlasEntriesSlot = 6;
+    SetShaderValue(atlasShader, GetShaderLocation(atlasShader, "atlas"), &atlasSlot, SHADER_UNIFORM_INT);
+    SetShaderValue(atlasShader, GetShaderLocation(atlasShader, "atlasEntries"), &atlasEntriesSlot, SHADER_UNIFORM_INT);
+
+    // Bunnies array, pages are committed as bunnies spawn and the array never moves.
+    // Every bunny GPU buffer is sized from the store capacity and grows with it
+    InstanceStore bunnyStore = LoadInstanceStore(sizeof(Bunny), MAX_BUNNIES, CALIBRATION_BUNNIES);
+    Bunny* bunnies = (Bunny*)bunnyStore.data;
     int bunniesCount = 0;
 
+    // Transient data of each frame, reset at the start of the frame
+    FrameArena frameArena = LoadFrameArena(FRAME_ARENA_SIZE);
+
+    // Bunnies drawn in depth order, sorted every frame into a frame arena array (spawn order is kept for updates)
+    InstanceSorter* sorter = LoadInstanceSorter(0);
+    bool depthSort = false;
+
+    // Bunnies bounce off each other, grid cells are a bunny collision diameter wide
+    SpatialGrid* grid = LoadSpatialGrid(BUNNY_RADIUS * 2.0f, 0);
+    bool collisions = false;
+
     // Configure instanced buffer
     // -------------------------
     rlRenderBatch batch = rlLoadRenderBatch(1, 1);
     batch.instances = bunniesCount;
 
-    rlEnableVertexArray(batch.vertexBuffer[0].vaoId);
-    int bufferLength = 400000;
-    int buffer = rlLoadVertexBuffer(bunnies, bufferLength * sizeof(Bunny), true);
+    unsigned int buffer = LoadBunnyBuffer(batch, shader, bunnyStore.gpuCapacity);
 
-    // Shader attribute locations
-    int positionAttrib = rlGetLocationAttrib(shader.id, "bunnyPosition");
-    int colorAttrib = rlGetLocationAttrib(shader.id, "bunnyColor");
+    // Configure buffer texture, same bunny records fetched with texelFetch()
+    // instead of vertex attribute divisors (slot 0 is used by texture0)
+    // -------------------------
+    rlBufferTexture bunniesTexture = rlLoadBufferTexture(NULL, bunnyStore.gpuCapacity * sizeof(Bunny), RL_BUFFER_TEXTURE_R32UI, true);
+    int bunniesSlot = 1;
+    int instanceBase = 0;
+    SetShaderValue(tboShader, GetShaderLocation(tboShader, "instanceRecords"), &bunniesSlot, SHADER_UNIFORM_INT);
+    SetShaderValue(tboShader, GetShaderLocation(tboShader, "instanceBase"), &instanceBase, SHADER_UNIFORM_INT);
+
+    // Configure vertex pulling, bunny quad is fetched from a geometry pool
+    // and bunny records from an instance pool, no vertex layout is needed
+    // -------------------------
+    float w = texBunny.width;
+    float h = texBunny.height;
+    float quadVertices[4 * RL_PULLED_VERTEX_FLOATS] = {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, h, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        w, h, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        w, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f
+    };
+    unsigned int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    // Unit quad for atlas sprites, scaled by each sprite size in the shader
+    float unitVertices[4 * RL_PULLED_VERTEX_FLOATS] = {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    rlGeometryPool geometryPool = rlLoadGeometryPool(8, 12);
+    rlGeometryRange bunnyQuad = rlLoadGeometry(&geometryPool, quadVertices, 4, quadIndices, 6);
+    rlGeometryRange unitQuad = rlLoadGeometry(&geometryPool, unitVertices, 4, quadIndices, 6);
+    rlInstancePool instancePool = rlLoadInstancePool(bunnyStore.gpuCapacity * sizeof(Bunny));
+
+    // Deferred draw queue, same DrawTexture() loop merged into instanced draws
+    DrawQueue drawQueue = LoadDrawQueue(bunnyStore.gpuCapacity, (Shader) { 0 });
+
+    // Multithreaded batch recording, fallback for hardware without instancing
+    int recordThreads = GetWorkerCoreCount();
+    BatchBuilder* batchBuilder = LoadBatchBuilder(recordThreads);
+    Vector2 bunnySize = { (float)texBunny.width, (float)texBunny.height };
+
+    // Batched path draws through a fenced ring, capacity grows until every bunny fits one flush
+    RenderBatchRing batchRing = LoadRenderBatchRing(2, 4, RL_DEFAULT_BATCH_BUFFER_ELEMENTS, bunnyStore.gpuCapacity);
+
+    // Indirect draws read the bunny quad draw parameters from a command buffer
+    bool indirectSupported = rlIsIndirectDrawSupported();
+    unsigned int indirectBuffer = indirectSupported ? rlLoadIndirectBuffer(1) : 0;
+
+    // Adaptive path, the cost model is calibrated on a grid of bunnies then picks the cheapest
+    // path for the current bunny count, replacing a hand tuned batched/instanced threshold
+    BunnyDraw bunnyDraw = { bunnies, texBunny, &batchRing, &batch, shader, &geometryPool, bunnyQuad, &instancePool, pulledShader, indirectBuffer };
+    DrawGroup bunnyGroup = LoadDrawGroup("bunnies", DrawBunnies, &bunnyDraw);
+    SetDrawGroupSupported(&bunnyGroup, DRAW_SUBMIT_INDIRECT, indirectSupported);
+
+    PushInstanceStore(&bunnyStore, CALIBRATION_BUNNIES);
+    for (int i = 0; i < CALIBRATION_BUNNIES; i++)
+    {
+        bunnies[i].position = (Vector2) { (float)(i % 256) * screenWidth / 256, (float)(i / 256 % 256) * screenHeight / 256 };
+        bunnies[i].color = WHITE;
+    }
+    rlUpdateVertexBuffer(buffer, bunnies, CALIBRATION_BUNNIES * sizeof(Bunny), 0);
+    rlUpdateInstancePool(instancePool, bunnies, CALIBRATION_BUNNIES * sizeof(Bunny), 0);
 
-    // instanced bunny positions(2 x float = 2 x GL_FLOAT)
-    rlEnableVertexAttribute(positionAttrib);
-    rlSetVertexAttribute(positionAttrib, 2, RL_FLOAT, false, sizeof(Bunny), (void*)0);
-    rlSetVertexAttributeDivisor(positionAttrib, 1);
+    BeginDrawing();
+    CalibrateDrawGroup(&bunnyGroup, CALIBRATION_BUNNIES);
+    ClearBackground(RAYWHITE);
+    EndDrawing();
 
-    // instanced bunny colors(4 x unsigned char = 4 x GL_UNSIGNED_BYTE)
-    rlEnableVertexAttribute(colorAttrib);
-    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(Bunny), (void*)offsetof(Bunny, color));
-    rlSetVertexAttributeDivisor(colorAttrib, 1);
+    ClearInstanceStore(&bunnyStore);
 
-    rlDisableVertexArray();
+    // Dynamic resolution holds 14 ms of GPU time, fill bound scenes render between half and full resolution
+    DynamicResolution resolution = LoadDynamicResolution(0.014f, 0.5f, 1.0f);
 
-    bool drawInstanced = false;
+    int drawPath = DRAW_ADAPTIVE;
 
-    Vector2 mousePosition = GetMousePosition();
+    Vector2 mousePosition = GetInputMousePosition();
     Vector2 origin = { texBunny.width / 2, texBunny.height / 2 };
 
-    SetTargetFPS(60); // Set our game to run at 60 frames-per-second
+    SetTargetFPS((input->mode == INPUT_REPLAY) ? 0 : 60); // Set our game to run at 60 frames-per-second, replays run uncapped
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose()) // Detect window close button or ESC key
+    while (!WindowShouldClose() && !IsInputReplayFinished()) // Detect window close button or ESC key
     {
         // Update
         //----------------------------------------------------------------------------------
+        UpdateInputReplay(input);
+        ResetFrameArena(&frameArena);
 
         // Turn instancing on/off
-        if (IsKeyPressed(KEY_ONE))
-            drawInstanced = false;
-        if (IsKeyPressed(KEY_TWO))
-            drawInstanced = true;
+        if (IsInputKeyPressed(KEY_ZERO))
+            drawPath = DRAW_ADAPTIVE;
+        if (IsInputKeyPressed(KEY_ONE))
+            drawPath = DRAW_BATCHED;
+        if (IsInputKeyPressed(KEY_TWO))
+            drawPath = DRAW_INSTANCED;
+        if (IsInputKeyPressed(KEY_THREE))
+            drawPath = DRAW_BUFFER_TEXTURE;
+        if (IsInputKeyPressed(KEY_FOUR))
+            drawPath = DRAW_VERTEX_PULLING;
+        if (IsInputKeyPressed(KEY_FIVE))
+            drawPath = DRAW_SPRITE_ATLAS;
+        if (IsInputKeyPressed(KEY_SIX))
+            drawPath = DRAW_QUEUED;
+        if (IsInputKeyPressed(KEY_SEVEN))
+            drawPath = DRAW_THREADED;
+        if (IsInputKeyPressed(KEY_EIGHT) && indirectSupported)
+            drawPath = DRAW_INDIRECT;
+
+        // Change recording threads, or benchmark every thread count (logged)
+        if ((IsInputKeyPressed(KEY_UP) && (recordThreads < WORKER_POOL_MAX_THREADS)) || (IsInputKeyPressed(KEY_DOWN) && (recordThreads > 1)))
+        {
+            recordThreads += IsInputKeyPressed(KEY_UP) ? 1 : -1;
+            UnloadBatchBuilder(batchBuilder);
+            batchBuilder = LoadBatchBuilder(recordThreads);
+        }
+        if (IsKeyPressed(KEY_B))
+            BenchmarkBatchBuilder(bunnies, bunniesCount, bunnySize, GetWorkerCoreCount());
+
+        // Toggle dynamic resolution
+        UpdateDynamicResolutionToggle(&resolution);
+
+        // Toggle depth sorted drawing
+        if (IsInputKeyPressed(KEY_O))
+            depthSort = !depthSort;
+
+        // Toggle bunny collisions
+        if (IsInputKeyPressed(KEY_C))
+            collisions = !collisions;
 
         // Spawn bunnies
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
+        if (IsInputMouseButtonDown(MOUSE_LEFT_BUTTON))
         {
-            mousePosition = GetMousePosition();
+            mousePosition = GetInputMousePosition();
             for (int i = 0; i < 100; i++)
             {
-                if (bunniesCount < bufferLength)
+                if (PushInstanceStore(&bunnyStore, 1) != NULL)
                 {
                     bunnies[bunniesCount].position = Vector2Subtract(mousePosition, origin);
                     bunnies[bunniesCount].speed.x = (float)GetRandomValue(-250, 250) / 60.0f;
@@ -111,6 +404,7 @@ int main(void)
                         GetRandomValue(80, 240),
                         GetRandomValue(100, 240), 255
                     };
+                    bunnies[bunniesCount].sprite = GetRandomValue(0, spriteCount - 1);
                     bunniesCount++;
                     batch.instances = bunniesCount;
                 }
@@ -130,49 +424,167 @@ int main(void)
                 bunnies[i].speed.y *= -1;
         }
 
+        // Grid is rebuilt from the moved bunnies, then overlapping bunnies are pushed apart
+        if (collisions)
+        {
+            BuildSpatialGrid(grid, bunnies, bunniesCount, sizeof(Bunny), (Rectangle) { -origin.x, -origin.y, GetScreenWidth(), GetScreenHeight() });
+            CollideSpatialGrid(grid, offsetof(Bunny, speed), BUNNY_RADIUS, 1.0f);
+        }
+
+        // GPU buffers grow with the bunnies store
+        if (UpdateInstanceStoreCapacity(&bunnyStore))
+        {
+            rlUnloadVertexBuffer(buffer);
+            buffer = LoadBunnyBuffer(batch, shader, bunnyStore.gpuCapacity);
+            rlUnloadBufferTexture(bunniesTexture);
+            bunniesTexture = rlLoadBufferTexture(NULL, bunnyStore.gpuCapacity * sizeof(Bunny), RL_BUFFER_TEXTURE_R32UI, true);
+            rlUnloadInstancePool(instancePool);
+            instancePool = rlLoadInstancePool(bunnyStore.gpuCapacity * sizeof(Bunny));
+            batchRing.maxElements = bunnyStore.gpuCapacity;
+        }
+
+        // Bunnies lower on the screen are nearer, drawn back to front they overlap the ones above them
+        const Bunny* drawnBunnies = bunnies;
+        if (depthSort)
+        {
+            // Arena exhausted, bunnies are drawn unsorted
+            Bunny* sortedBunnies = (Bunny*)AllocFrameArena(&frameArena, bunniesCount * sizeof(Bunny));
+            if (sortedBunnies != NULL)
+            {
+                SortInstances(sorter, &bunnies[0].position, sizeof(Bunny), 2, NULL, bunniesCount, Vector3Zero(), (Vector3) { 0.0f, -1.0f, 0.0f }, SORT_BACK_TO_FRONT);
+                PermuteSortedInstances(sorter, bunnies, sizeof(Bunny), sortedBunnies);
+                drawnBunnies = sortedBunnies;
+            }
+        }
+        bunnyDraw.bunnies = drawnBunnies;
+
+        // Adaptive path draws with the path the cost model selects for this bunny count
+        int path = drawPath;
+        if (drawPath == DRAW_ADAPTIVE)
+            path = submissionDrawPaths[UpdateDrawGroup(&bunnyGroup, bunniesCount)];
+
         // Re-upload bunnies array every frame to apply movement
-        int length = min(bunniesCount, bufferLength);
-        rlUpdateVertexBuffer(buffer, bunnies, length * sizeof(Bunny), 0);
+        int length = bunniesCount;
+        if (path == DRAW_BUFFER_TEXTURE)
+            rlUpdateBufferTexture(bunniesTexture, drawnBunnies, length * sizeof(Bunny), 0);
+        else if ((path == DRAW_VERTEX_PULLING) || (path == DRAW_SPRITE_ATLAS) || (path == DRAW_INDIRECT))
+            rlUpdateInstancePool(instancePool, drawnBunnies, length * sizeof(Bunny), 0);
+        else
+            rlUpdateVertexBuffer(buffer, drawnBunnies, length * sizeof(Bunny), 0);
         //----------------------------------------------------------------------------------
 
         // Draw
         //----------------------------------------------------------------------------------
         BeginDrawing();
+
+        BeginDynamicResolution(&resolution);
         ClearBackground(RAYWHITE);
 
-        if (drawInstanced)
+        if (drawPath == DRAW_ADAPTIVE)
+        {
+            DrawGroupInstances(&bunnyGroup, length);
+        }
+        else if ((drawPath == DRAW_BATCHED) || (drawPath == DRAW_INSTANCED) || (drawPath == DRAW_INDIRECT))
+        {
+            DrawBunnies((drawPath == DRAW_BATCHED) ? DRAW_SUBMIT_BATCHED : (drawPath == DRAW_INSTANCED) ? DRAW_SUBMIT_INSTANCED : DRAW_SUBMIT_INDIRECT, length, &bunnyDraw);
+        }
+        else if (drawPath == DRAW_THREADED)
+        {
+            RecordBatch(batchBuilder, RecordBunnyQuads, drawnBunnies, bunniesCount, 4, &bunnySize);
+            DrawBatchQuads(batchBuilder, texBunny);
+        }
+        else if (drawPath == DRAW_QUEUED)
         {
-            BeginShaderMode(shader);
+            BeginDrawQueue(&drawQueue, Vector3Zero());
+            for (int i = 0; i < bunniesCount; i++)
+                QueueTexture(&drawQueue, texBunny, drawnBunnies[i].position.x, drawnBunnies[i].position.y, drawnBunnies[i].color);
+            EndDrawQueue(&drawQueue);
+        }
+        else if (drawPath == DRAW_VERTEX_PULLING)
+        {
+            DrawGeometryInstanced(geometryPool, bunnyQuad, instancePool, 0, length, pulledShader, texBunny);
+        }
+        else if (drawPath == DRAW_SPRITE_ATLAS)
+        {
+            // Every sprite comes from the same texture array, one draw for all bunnies
+            rlEnableSpriteAtlas(atlas, atlasSlot, atlasEntriesSlot);
+            DrawGeometryInstanced(geometryPool, unitQuad, instancePool, 0, length, atlasShader, texBunny);
+            rlDisableSpriteAtlas(atlasSlot, atlasEntriesSlot);
+        }
+        else
+        {
+            BeginShaderMode(tboShader);
+            rlEnableBufferTexture(bunniesTexture, bunniesSlot);
 
+            batch.instances = length;
             rlSetRenderBatchActive(&batch);
             DrawTexture(texBunny, 0, 0, WHITE);
             rlDrawRenderBatchActive();
             rlSetRenderBatchActive(NULL);
 
+            rlDisableBufferTexture(bunniesSlot);
             EndShaderMode();
         }
-        else
-        {
-            for (int i = 0; i < bunniesCount; i++)
-            {
-                // NOTE: When internal batch buffer limit is reached (MAX_BATCH_ELEMENTS),
-                // a draw call is launched and buffer starts being filled again;
-                // before issuing a draw call, updated vertex data from internal CPU buffer is send to GPU...
-                // Process of sending data is costly and it could happen that GPU data has not been completely
-                // processed for drawing while new data is tried to be sent (updating current in-use buffers)
-                // it could generates a stall and consequently a frame drop, limiting the number of drawn bunnies
-                DrawTexture(texBunny, bunnies[i].position.x, bunnies[i].position.y, bunnies[i].color);
-            }
-        }
+
+        EndDynamicResolution(&resolution);
 
         DrawRectangle(0, 0, GetScreenWidth(), 40, BLACK);
         DrawText(TextFormat("bunnies: %i", bunniesCount), 120, 10, 20, GREEN);
 
-        if (!drawInstanced)
+        if (path == DRAW_BATCHED)
         {
-            DrawText(TextFormat("batched draw calls: %i", 1 + bunniesCount / RL_DEFAULT_BATCH_BUFFER_ELEMENTS), 300, 10, 20, MAROON);
+            RenderBatchStats stats = batchRing.stats;
+            DrawText(TextFormat("batched draw calls: %i", stats.drawCalls), 300, 10, 20, MAROON);
+            DrawText(TextFormat("forced flushes: %i, padding: %i, waits: %i, capacity: %i",
+                         stats.forcedFlushes, stats.paddingVertices, stats.syncWaits, batchRing.elements),
+                250, GetScreenHeight() - 20, 14, MAROON);
         }
-        DrawText(TextFormat("instanced: %i", drawInstanced), 550, 10, 20, MAROON);
+        else if (drawPath == DRAW_QUEUED)
+        {
+            DrawText(TextFormat("queued draw calls: %i", drawQueue.stats.drawCalls), 300, 10, 20, MAROON);
+            DrawText(TextFormat("sort: %.2f ms", drawQueue.stats.sortTime * 1000.0), 250, GetScreenHeight() - 20, 14, MAROON);
+        }
+        else if (drawPath == DRAW_THREADED)
+        {
+            DrawText("threaded draw calls: 1", 300, 10, 20, MAROON);
+            DrawText(TextFormat("threads: %i, record: %.2f ms", batchBuilder->pool->threadCount, batchBuilder->recordTime * 1000.0), 250, GetScreenHeight() - 20, 14, MAROON);
+        }
+        DrawText(TextFormat("instanced: %i", (path != DRAW_BATCHED) && (path != DRAW_THREADED)), 550, 10, 20, MAROON);
+
+        // Frame time, to compare throughput between draw paths
+        DrawText(TextFormat("%s: %.2f ms", drawPathText[path], GetFrameTime() * 1000.0f), 10, GetScreenHeight() - 20, 14, MAROON);
+
+        if (drawPath == DRAW_ADAPTIVE)
+        {
+            DrawGroupStats stats = bunnyGroup.stats;
+            DrawText(TextFormat("adaptive: %s, predicted batched/instanced/indirect: %.2f/%.2f/%.2f ms, measured cpu/gpu: %.2f/%.2f ms, switches: %i",
+                         drawSubmissionText[stats.submission], stats.predicted[DRAW_SUBMIT_BATCHED] * 1000.0, stats.predicted[DRAW_SUBMIT_INSTANCED] * 1000.0,
+                         stats.predicted[DRAW_SUBMIT_INDIRECT] * 1000.0, stats.cpuTime * 1000.0, stats.gpuTime * 1000.0, stats.switches),
+                10, GetScreenHeight() - 60, 14, MAROON);
+        }
+
+        if (depthSort)
+        {
+            InstanceSortStats stats = sorter->stats;
+            DrawText(TextFormat("sort: %s, %i threads, keys: %.2f ms, sort: %.2f ms, permute: %.2f ms", instanceSortOrderText[SORT_BACK_TO_FRONT], sorter->pool->threadCount,
+                         stats.keyTime * 1000.0, stats.sortTime * 1000.0, stats.permuteTime * 1000.0),
+                10, GetScreenHeight() - 80, 14, MAROON);
+        }
+
+        if (collisions)
+        {
+            unsigned int nearBunnies[64] = { 0 };
+            int found = QuerySpatialGrid(grid, Vector2Subtract(GetInputMousePosition(), origin), BUNNY_RADIUS * 2.0f, nearBunnies, 64);
+            SpatialGridStats stats = grid->stats;
+            DrawText(TextFormat("grid: %ix%i cells, %i threads, rebuild: %.2f ms, collide: %.2f ms, contacts: %i, fullest cell: %i, under mouse: %i",
+                         grid->columns, grid->rows, grid->pool->threadCount, stats.buildTime * 1000.0, stats.collideTime * 1000.0, stats.contacts, stats.maxCellCount, found),
+                10, GetScreenHeight() - 120, 14, MAROON);
+        }
+
+        DrawDynamicResolutionStats(&resolution, 10, GetScreenHeight() - 40);
+        DrawText(TextFormat("bunnies store: %.2f MB committed, gpu capacity: %i, frame arena: %.2f MB peak, %.2f MB committed", bunnyStore.committed / 1048576.0f,
+                     bunnyStore.gpuCapacity, frameArena.lastPeak / 1048576.0f, frameArena.committed / 1048576.0f),
+            10, GetScreenHeight() - 100, 14, MAROON);
 
         DrawFPS(10, 10);
 
@@ -182,12 +594,29 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
-    RL_FREE(bunnies); // Unload bunnies data array
+    UnloadInstanceStore(&bunnyStore); // Unload bunnies data array
+    UnloadFrameArena(&frameArena);
 
     rlUnloadVertexBuffer(buffer);
+    rlUnloadBufferTexture(bunniesTexture);
+    rlUnloadInstancePool(instancePool);
+    rlUnloadGeometryPool(&geometryPool);
+    UnloadSpriteAtlas(atlas);
+    UnloadDrawQueue(&drawQueue);
+    UnloadBatchBuilder(batchBuilder);
+    UnloadInstanceSorter(sorter);
+    UnloadSpatialGrid(grid);
+    UnloadRenderBatchRing(&batchRing);
+    UnloadDynamicResolution(&resolution);
+    UnloadDrawGroup(&bunnyGroup);
+    if (indirectSupported)
+        rlUnloadIndirectBuffer(indirectBuffer);
     rlUnloadRenderBatch(batch);
     UnloadTexture(texBunny); // Unload bunny texture
-    UnloadShader(shader);
+    UnloadShaderVariantSet(&shaderVariants);
+    UnloadShader(atlasShader);
+
+    UnloadInputReplay(input);
 
     CloseWindow(); // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -0,0 +1,621 @@
+#ifndef MESH_QUANTIZE_H
+#define MESH_QUANTIZE_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "model_instanced.h"
+#include "hash_fnv.h"
+
+// Required for: memcpy(), memcmp()
+#include <string.h>
+
+// Quantized vertex size with 8-bit normals: position (4 x u16, w holds the normal), texcoord (2 x half)
+#define QUANTIZED_STRIDE_NORMAL8 12
+// Quantized vertex size with 16-bit normals: position (4 x u16), normal (2 x i16), texcoord (2 x half)
+#define QUANTIZED_STRIDE_NORMAL16 16
+
+// Post-transform cache size the triangle order is optimized for
+#define QUANTIZE_CACHE_SIZE 32
+
+// FIFO cache size of the reported cache miss ratios
+#define QUANTIZE_FIFO_SIZE 16
+
+// Quantization quality and size, maxima and totals over every mesh of a model
+typedef struct QuantizeStats {
+    float maxPositionError;     // Model units
+    float maxNormalError;       // Degrees
+    float maxTexcoordError;
+    float acmrBefore;           // Cache misses per triangle, welded vertices in source order
+    float acmrAfter;            // Cache misses per triangle, after vertex cache optimization
+    int sourceVertices;
+    int vertices;               // Unique quantized vertices
+    int sourceBytes;            // Float vertex streams (positions, texcoords, normals)
+    int quantizedBytes;         // Interleaved vertices and indices
+} QuantizeStats;
+
+// Mesh quantized into one interleaved vertex buffer and an index buffer
+typedef struct QuantizedMesh {
+    unsigned int vboId;
+    unsigned int eboId;
+    unsigned short* indices;    // Cache optimized triangle list
+    int indexCount;
+    int vertexCount;
+} QuantizedMesh;
+
+// Shader locations of the decode uniforms, stored before the pulled draw locations
+#define QUANTIZED_LOC_POSITION_OFFSET (RL_MAX_SHADER_LOCATIONS - 6)
+#define QUANTIZED_LOC_POSITION_SCALE (RL_MAX_SHADER_LOCATIONS - 5)
+#define QUANTIZED_LOC_NORMAL_BITS (RL_MAX_SHADER_LOCATIONS - 4)
+
+// Model with quantized meshes, decoded by the QUANTIZED_VERTICES shader variant
+// NOTE: Positions are 16-bit within the model bounds, normals are octahedral 8 or 16-bit pairs
+// and texcoords are half floats, all interleaved in one stream. Equal vertices are welded and
+// triangles reordered for the post-transform cache, vertices are stored in first use order
+typedef struct QuantizedModel {
+    Model model;                // Source model (not owned), materials are shared
+    QuantizedMesh* meshes;
+    Mesh* drawMeshes;           // Source meshes with quantized index counts, drawn by DrawInstancedModel()
+    int normalBits;             // 8 or 16
+    int stride;                 // Vertex size (bytes)
+    Vector3 positionOffset;     // Position decode, position = offset + quantized*scale
+    Vector3 positionScale;
+    QuantizeStats stats;
+} QuantizedModel;
+
+//----------------------------------------------------------------------------------
+// Vertex encoding
+//----------------------------------------------------------------------------------
+
+// Convert float to half float (round to nearest)
+unsigned short FloatToHalf(float value)
+{
+    unsigned int bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = bits & 0x7fffff;
+
+    if (exponent >= 31)
+        return (unsigned short)(sign | 0x7c00);
+
+    // Subnormal half, the implicit mantissa bit is shifted in
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return (unsigned short)sign;
+
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        unsigned int half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            half++;
+
+        return (unsigned short)(sign | half);
+    }
+
+    // Rounding carries into the exponent when the mantissa overflows
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+        half++;
+
+    return (unsigned short)half;
+}
+
+// Convert half float to float
+float HalfToFloat(unsigned short half)
+{
+    unsigned int sign = (unsigned int)(half & 0x8000) << 16;
+    int exponent = (half >> 10) & 0x1f;
+    unsigned int mantissa = half & 0x3ff;
+    unsigned int bits = 0;
+
+    if (exponent == 0)
+    {
+        float value = ldexpf((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    else if (exponent == 31)
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    else
+        bits = sign | ((unsigned int)(exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float value = 0.0f;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Decode octahedral normal, components in [-1, 1]
+Vector3 DecodeOctahedral(float x, float y)
+{
+    Vector3 n = { x, y, 1.0f - fabsf(x) - fabsf(y) };
+    float t = fmaxf(-n.z, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+    return Vector3Normalize(n);
+}
+
+// Encode normal to octahedral signed integers of bits, the nearest of the 4 surrounding codes is kept
+void EncodeOctahedral(Vector3 normal, int bits, int* x, int* y)
+{
+    float limit = (float)((1 << (bits - 1)) - 1);
+
+    float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    if (length == 0.0f)
+        normal = (Vector3) { 0.0f, 0.0f, 1.0f };
+    else
+        normal = Vector3Scale(normal, 1.0f / length);
+
+    float ex = normal.x;
+    float ey = normal.y;
+    if (normal.z < 0.0f)
+    {
+        ex = (1.0f - fabsf(normal.y)) * ((normal.x >= 0.0f) ? 1.0f : -1.0f);
+        ey = (1.0f - fabsf(normal.x)) * ((normal.y >= 0.0f) ? 1.0f : -1.0f);
+    }
+
+    Vector3 reference = Vector3Normalize(normal);
+    float best = -2.0f;
+    for (int i = 0; i < 4; i++)
+    {
+        float cx = fminf(fmaxf(floorf(ex * limit) + (float)(i & 1), -limit), limit);
+        float cy = fminf(fmaxf(floorf(ey * limit) + (float)(i >> 1), -limit), limit);
+        float similarity = Vector3DotProduct(DecodeOctahedral(cx / limit, cy / limit), reference);
+        if (similarity > best)
+        {
+            best = similarity;
+            *x = (int)cx;
+            *y = (int)cy;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Vertex cache optimization
+//----------------------------------------------------------------------------------
+
+// Average cache misses per triangle of a FIFO cache
+float GetCacheMissRatio(const unsigned short* indices, int indexCount, int vertexCount)
+{
+    if (indexCount < 3)
+        return 0.0f;
+
+    unsigned int* stamps = (unsigned int*)RL_CALLOC(vertexCount, sizeof(unsigned int));
+    unsigned int time = QUANTIZE_FIFO_SIZE + 1;
+    int misses = 0;
+
+    // A vertex is in the cache while less than cache size misses happened since it was loaded
+    for (int i = 0; i < indexCount; i++)
+    {
+        if (time - stamps[indices[i]] > QUANTIZE_FIFO_SIZE)
+        {
+            stamps[indices[i]] = time++;
+            misses++;
+        }
+    }
+
+    RL_FREE(stamps);
+
+    return (float)misses / (float)(indexCount / 3);
+}
+
+// Score of a vertex from its cache position and remaining triangles (Forsyth)
+float GetVertexCacheScore(int cachePosition, int remaining)
+{
+    if (remaining == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // Vertices of the last triangle score lower, the next triangle should not reuse all of them
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - (float)(cachePosition - 3) / (float)(QUANTIZE_CACHE_SIZE - 3), 1.5f);
+    }
+
+    // Vertices with few triangles left are finished first
+    return score + 2.0f / sqrtf((float)remaining);
+}
+
+// Reorder triangles for the post-transform vertex cache (Forsyth linear speed optimization)
+void OptimizeVertexCache(unsigned short* indices, int indexCount, int vertexCount)
+{
+    int triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    int* remaining = (int*)RL_CALLOC(vertexCount, sizeof(int));
+    int* adjacencyStart = (int*)RL_CALLOC(vertexCount + 1, sizeof(int));
+    int* adjacency = (int*)RL_MALLOC(indexCount * sizeof(int));
+    int* cachePosition = (int*)RL_MALLOC(vertexCount * sizeof(int));
+    float* vertexScore = (float*)RL_MALLOC(vertexCount * sizeof(float));
+    float* triangleScore = (float*)RL_MALLOC(triangleCount * sizeof(float));
+    bool* emitted = (bool*)RL_CALLOC(triangleCount, sizeof(bool));
+    unsigned short* output = (unsigned short*)RL_MALLOC(indexCount * sizeof(unsigned short));
+
+    // Triangles of each vertex
+    for (int i = 0; i < indexCount; i++)
+        remaining[indices[i]]++;
+    for (int v = 0; v < vertexCount; v++)
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+    for (int v = 0; v < vertexCount; v++)
+        remaining[v] = 0;
+    for (int i = 0; i < indexCount; i++)
+    {
+        int v = indices[i];
+        adjacency[adjacencyStart[v] + remaining[v]++] = i / 3;
+    }
+
+    for (int v = 0; v < vertexCount; v++)
+    {
+        cachePosition[v] = -1;
+        vertexScore[v] = GetVertexCacheScore(-1, remaining[v]);
+    }
+    for (int t = 0; t < triangleCount; t++)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    int cache[QUANTIZE_CACHE_SIZE + 3] = { 0 };
+    int cacheCount = 0;
+    int best = 0;
+    int nextCandidate = 0;
+
+    for (int e = 0; e < triangleCount; e++)
+    {
+        // No triangle touches the cache, continue with the next triangle in source order
+        if (best < 0)
+        {
+            while (emitted[nextCandidate])
+                nextCandidate++;
+            best = nextCandidate;
+        }
+
+        emitted[best] = true;
+        memcpy(&output[e * 3], &indices[best * 3], 3 * sizeof(unsigned short));
+
+        // Remove triangle from its vertices
+        for (int k = 0; k < 3; k++)
+        {
+            int v = indices[best * 3 + k];
+            int* triangles = &adjacency[adjacencyStart[v]];
+            for (int j = 0; j < remaining[v]; j++)
+            {
+                if (triangles[j] == best)
+                {
+                    triangles[j] = triangles[--remaining[v]];
+                    break;
+                }
+            }
+        }
+
+        // Triangle vertices move to the cache front, other entries follow in order
+        int newCache[QUANTIZE_CACHE_SIZE + 3] = { 0 };
+        int newCount = 0;
+        for (int k = 0; k < 3; k++)
+            newCache[newCount++] = indices[best * 3 + k];
+        for (int j = 0; j < cacheCount; j++)
+        {
+            int v = cache[j];
+            if ((v != newCache[0]) && (v != newCache[1]) && (v != newCache[2]))
+                newCache[newCount++] = v;
+        }
+
+        // Rescore cached vertices (and the ones pushed out), then their triangles
+        for (int j = 0; j < newCount; j++)
+        {
+            int v = newCache[j];
+            cachePosition[v] = (j < QUANTIZE_CACHE_SIZE) ? j : -1;
+            vertexScore[v] = GetVertexCacheScore(cachePosition[v], remaining[v]);
+        }
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (int j = 0; j < newCount; j++)
+        {
+            int v = newCache[j];
+            for (int a = 0; a < remaining[v]; a++)
+            {
+                int t = adjacency[adjacencyStart[v] + a];
+                triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = (newCount < QUANTIZE_CACHE_SIZE) ? newCount : QUANTIZE_CACHE_SIZE;
+        memcpy(cache, newCache, cacheCount * sizeof(int));
+    }
+
+    memcpy(indices, output, indexCount * sizeof(unsigned short));
+
+    RL_FREE(remaining);
+    RL_FREE(adjacencyStart);
+    RL_FREE(adjacency);
+    RL_FREE(cachePosition);
+    RL_FREE(vertexScore);
+    RL_FREE(triangleScore);
+    RL_FREE(emitted);
+    RL_FREE(output);
+}
+
+//----------------------------------------------------------------------------------
+// Quantized model
+//----------------------------------------------------------------------------------
+
+// Quantize one mesh, source vertices are welded and reordered, stats are accumulated
+QuantizedMesh LoadQuantizedMesh(Mesh mesh, const QuantizedModel* model, QuantizeStats* stats)
+{
+    QuantizedMesh quantized = { 0 };
+    int stride = model->stride;
+
+    // OBJ meshes are not indexed, every source vertex is its own index
+    int sourceCount = (mesh.indices != NULL) ? mesh.triangleCount * 3 : mesh.vertexCount;
+
+    unsigned char* sourceVertices = (unsigned char*)RL_CALLOC(mesh.vertexCount, stride);
+    for (int i = 0; i < mesh.vertexCount; i++)
+    {
+        unsigned char* vertex = sourceVertices + (size_t)i * stride;
+        unsigned short position[4] = { 0 };
+        for (int k = 0; k < 3; k++)
+        {
+            float scale = ((float*)&model->positionScale)[k];
+            float offset = ((float*)&model->positionOffset)[k];
+            float q = (scale > 0.0f) ? roundf((mesh.vertices[i * 3 + k] - offset) / scale) : 0.0f;
+            position[k] = (unsigned short)fminf(fmaxf(q, 0.0f), 65535.0f);
+        }
+
+        Vector3 normal = (mesh.normals != NULL) ? (Vector3) { mesh.normals[i * 3], mesh.normals[i * 3 + 1], mesh.normals[i * 3 + 2] } : (Vector3) { 0.0f, 0.0f, 1.0f };
+        int nx = 0;
+        int ny = 0;
+        EncodeOctahedral(normal, model->normalBits, &nx, &ny);
+
+        unsigned short texcoord[2] = { 0 };
+        if (mesh.texcoords != NULL)
+        {
+            texcoord[0] = FloatToHalf(mesh.texcoords[i * 2]);
+            texcoord[1] = FloatToHalf(mesh.texcoords[i * 2 + 1]);
+        }
+
+        if (model->normalBits == 8)
+        {
+            // Normal bytes are stored biased in the spare position component
+            position[3] = (unsigned short)(((nx + 127) << 8) | (ny + 127));
+            memcpy(vertex, position, 8);
+            memcpy(vertex + 8, texcoord, 4);
+        }
+        else
+        {
+            short packed[2] = { (short)nx, (short)ny };
+            memcpy(vertex, position, 8);
+            memcpy(vertex + 8, packed, 4);
+            memcpy(vertex + 12, texcoord, 4);
+        }
+
+        // Quality of the decoded vertex against the float mesh
+        for (int k = 0; k < 3; k++)
+        {
+            float decoded = ((float*)&model->positionOffset)[k] + position[k] * ((float*)&model->positionScale)[k];
+            stats->maxPositionError = fmaxf(stats->maxPositionError, fabsf(decoded - mesh.vertices[i * 3 + k]));
+        }
+
+        float limit = (float)((1 << (model->normalBits - 1)) - 1);
+        Vector3 decodedNormal = DecodeOctahedral(nx / limit, ny / limit);
+        if (mesh.normals != NULL)
+        {
+            float similarity = fminf(fmaxf(Vector3DotProduct(decodedNormal, Vector3Normalize(normal)), -1.0f), 1.0f);
+            stats->maxNormalError = fmaxf(stats->maxNormalError, acosf(similarity) * RAD2DEG);
+        }
+
+        if (mesh.texcoords != NULL)
+        {
+            for (int k = 0; k < 2; k++)
+                stats->maxTexcoordError = fmaxf(stats->maxTexcoordError, fabsf(HalfToFloat(texcoord[k]) - mesh.texcoords[i * 2 + k]));
+        }
+    }
+
+    // Weld equal quantized vertices, table holds welded vertex + 1
+    int tableSize = 1;
+    while (tableSize < sourceCount * 2)
+        tableSize <<= 1;
+    int* table = (int*)RL_CALLOC(tableSize, sizeof(int));
+    unsigned char* vertices = (unsigned char*)RL_MALLOC((size_t)sourceCount * stride);
+    quantized.indices = (unsigned short*)RL_MALLOC(sourceCount * sizeof(unsigned short));
+    quantized.indexCount = sourceCount;
+
+    for (int i = 0; i < sourceCount; i++)
+    {
+        int source = (mesh.indices != NULL) ? mesh.indices[i] : i;
+        const unsigned char* vertex = sourceVertices + (size_t)source * stride;
+
+        unsigned int slot = HashFNV(HASH_FNV_BASIS, vertex, stride) & (tableSize - 1);
+        while ((table[slot] != 0) && (memcmp(vertices + (size_t)(table[slot] - 1) * stride, vertex, stride) != 0))
+            slot = (slot + 1) & (tableSize - 1);
+
+        if (table[slot] == 0)
+        {
+            if (quantized.vertexCount > 0xFFFF)
+            {
+                TraceLog(LOG_WARNING, "QUANTIZE: Mesh has more than 65536 unique vertices, 16-bit indices can not address them");
+                RL_FREE(sourceVertices);
+                RL_FREE(table);
+                RL_FREE(vertices);
+                RL_FREE(quantized.indices);
+                return (QuantizedMesh) { 0 };
+            }
+
+            memcpy(vertices + (size_t)quantized.vertexCount * stride, vertex, stride);
+            table[slot] = ++quantized.vertexCount;
+        }
+
+        quantized.indices[i] = (unsigned short)(table[slot] - 1);
+    }
+
+    float acmrBefore = GetCacheMissRatio(quantized.indices, quantized.indexCount, quantized.vertexCount);
+    OptimizeVertexCache(quantized.indices, quantized.indexCount, quantized.vertexCount);
+    float acmrAfter = GetCacheMissRatio(quantized.indices, quantized.indexCount, quantized.vertexCount);
+
+    // Vertices in first use order, fetches follow the triangle order
+    int* remap = (int*)RL_MALLOC(quantized.vertexCount * sizeof(int));
+    for (int v = 0; v < quantized.vertexCount; v++)
+        remap[v] = -1;
+    unsigned char* ordered = (unsigned char*)RL_MALLOC((size_t)quantized.vertexCount * stride + 1);
+    int orderedCount = 0;
+    for (int i = 0; i < quantized.indexCount; i++)
+    {
+        int v = quantized.indices[i];
+        if (remap[v] < 0)
+        {
+            remap[v] = orderedCount;
+            memcpy(ordered + (size_t)orderedCount * stride, vertices + (size_t)v * stride, stride);
+            orderedCount++;
+        }
+        quantized.indices[i] = (unsigned short)remap[v];
+    }
+
+    quantized.vboId = rlLoadVertexBuffer(ordered, quantized.vertexCount * stride, false);
+    quantized.eboId = rlLoadVertexBufferElement(quantized.indices, quantized.indexCount * sizeof(unsigned short), false);
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+
+    // Cache miss ratios are averaged over triangles
+    int triangles = quantized.indexCount / 3;
+    int previousTriangles = stats->sourceVertices / 3;
+    if (previousTriangles + triangles > 0)
+    {
+        stats->acmrBefore = (stats->acmrBefore * previousTriangles + acmrBefore * triangles) / (previousTriangles + triangles);
+        stats->acmrAfter = (stats->acmrAfter * previousTriangles + acmrAfter * triangles) / (previousTriangles + triangles);
+    }
+
+    stats->sourceVertices += sourceCount;
+    stats->vertices += quantized.vertexCount;
+    stats->sourceBytes += mesh.vertexCount * (3 + (mesh.texcoords ? 2 : 0) + (mesh.normals ? 3 : 0)) * (int)sizeof(float);
+    stats->quantizedBytes += quantized.vertexCount * stride + quantized.indexCount * (int)sizeof(unsigned short);
+
+    RL_FREE(sourceVertices);
+    RL_FREE(table);
+    RL_FREE(vertices);
+    RL_FREE(remap);
+    RL_FREE(ordered);
+
+    return quantized;
+}
+
+// Load quantized model, normalBits is 8 or 16 (octahedral normal component size)
+QuantizedModel LoadQuantizedModel(Model model, int normalBits)
+{
+    QuantizedModel quantized = { 0 };
+    quantized.model = model;
+    quantized.normalBits = (normalBits == 8) ? 8 : 16;
+    quantized.stride = (quantized.normalBits == 8) ? QUANTIZED_STRIDE_NORMAL8 : QUANTIZED_STRIDE_NORMAL16;
+
+    // Every mesh shares the model bounds, one decode scale is set for the whole model
+    BoundingBox bounds = GetModelBoundingBox(model);
+    Vector3 size = Vector3Subtract(bounds.max, bounds.min);
+    quantized.positionOffset = bounds.min;
+    quantized.positionScale = Vector3Scale(size, 1.0f / 65535.0f);
+
+    quantized.meshes = (QuantizedMesh*)RL_CALLOC(model.meshCount, sizeof(QuantizedMesh));
+    quantized.drawMeshes = (Mesh*)RL_CALLOC(model.meshCount, sizeof(Mesh));
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        quantized.meshes[i] = LoadQuantizedMesh(model.meshes[i], &quantized, &quantized.stats);
+
+        quantized.drawMeshes[i] = model.meshes[i];
+        quantized.drawMeshes[i].indices = quantized.meshes[i].indices;
+        quantized.drawMeshes[i].triangleCount = quantized.meshes[i].indexCount / 3;
+        quantized.drawMeshes[i].vertexCount = quantized.meshes[i].vertexCount;
+    }
+
+    QuantizeStats stats = quantized.stats;
+    TraceLog(LOG_INFO, "QUANTIZE: Model quantized (%i-bit normals), vertices: %i -> %i, bytes: %i -> %i", quantized.normalBits,
+        stats.sourceVertices, stats.vertices, stats.sourceBytes, stats.quantizedBytes);
+    TraceLog(LOG_INFO, "QUANTIZE: Max error position: %f (%.4f%% of bounds), normal: %.3f deg, texcoord: %f, cache misses per triangle: %.3f -> %.3f",
+        stats.maxPositionError, stats.maxPositionError / fmaxf(fmaxf(size.x, size.y), fmaxf(size.z, 1e-6f)) * 100.0f,
+        stats.maxNormalError, stats.maxTexcoordError, stats.acmrBefore, stats.acmrAfter);
+
+    return quantized;
+}
+
+// Unload quantized model buffers (source model is not unloaded)
+void UnloadQuantizedModel(QuantizedModel* quantized)
+{
+    for (int i = 0; i < quantized->model.meshCount; i++)
+    {
+        rlUnloadVertexBuffer(quantized->meshes[i].vboId);
+        rlUnloadVertexBuffer(quantized->meshes[i].eboId);
+        RL_FREE(quantized->meshes[i].indices);
+    }
+
+    RL_FREE(quantized->meshes);
+    RL_FREE(quantized->drawMeshes);
+    *quantized = (QuantizedModel) { 0 };
+}
+
+// Load quantized model bound to an instance buffer, shader must be a QUANTIZED_VERTICES variant
+InstancedModel LoadQuantizedInstancedModel(QuantizedModel quantized, Shader shader, InstanceBuffer buffer)
+{
+    InstancedModel instanced = { 0 };
+    instanced.model = quantized.model;
+    instanced.model.meshes = quantized.drawMeshes;
+    instanced.shader = shader;
+    instanced.buffer = buffer;
+    instanced.vaoIds = (unsigned int*)RL_CALLOC(quantized.model.meshCount, sizeof(unsigned int));
+
+    int stride = quantized.stride;
+    for (int i = 0; i < quantized.model.meshCount; i++)
+    {
+        instanced.vaoIds[i] = rlLoadVertexArray();
+        rlEnableVertexArray(instanced.vaoIds[i]);
+
+        // Positions and normals are read as integers and decoded by the shader
+        rlEnableVertexBuffer(quantized.meshes[i].vboId);
+        rlSetVertexAttribute(0, 4, GL_UNSIGNED_SHORT, false, stride, (void*)0);
+        rlEnableVertexAttribute(0);
+        rlSetVertexAttribute(1, 2, GL_HALF_FLOAT, false, stride, (void*)(size_t)(stride - 4));
+        rlEnableVertexAttribute(1);
+        if (quantized.normalBits == 16)
+        {
+            rlSetVertexAttribute(2, 2, GL_SHORT, false, stride, (void*)8);
+            rlEnableVertexAttribute(2);
+        }
+
+        rlEnableVertexBufferElement(quantized.meshes[i].eboId);
+
+        SetInstancedModelBase(instanced, 0);
+
+        rlDisableVertexArray();
+    }
+
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+
+    return instanced;
+}
+
+// Set decode uniform locations of a QUANTIZED_VERTICES shader variant, call once after loading it
+void SetShaderQuantizedLocations(Shader shader)
+{
+    if ((shader.id == 0) || (shader.id == rlGetShaderIdDefault()))
+        return;
+
+    shader.locs[QUANTIZED_LOC_POSITION_OFFSET] = rlGetLocationUniform(shader.id, "positionOffset");
+    shader.locs[QUANTIZED_LOC_POSITION_SCALE] = rlGetLocationUniform(shader.id, "positionScale");
+    shader.locs[QUANTIZED_LOC_NORMAL_BITS] = rlGetLocationUniform(shader.id, "normalBits");
+}
+
+// Set decode uniforms of a quantized model, call before drawing it with a QUANTIZED_VERTICES variant
+// NOTE: Shader locations are set by SetShaderQuantizedLocations()
+void SetQuantizedModelShader(QuantizedModel quantized, Shader shader)
+{
+    SetShaderValue(shader, shader.locs[QUANTIZED_LOC_POSITION_OFFSET], &quantized.positionOffset, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, shader.locs[QUANTIZED_LOC_POSITION_SCALE], &quantized.positionScale, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, shader.locs[QUANTIZED_LOC_NORMAL_BITS], &quantized.normalBits, SHADER_UNIFORM_INT);
+}
+
+#endif // MESH_QUANTIZE_H
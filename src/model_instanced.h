@@ -0,0 +1,261 @@
+#ifndef MODEL_INSTANCED_H
+#define MODEL_INSTANCED_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// Mesh vertex buffers as loaded by UploadMesh() (see Mesh.vboId)
+#define MESH_BUFFER_POSITIONS 0
+#define MESH_BUFFER_TEXCOORDS 1
+#define MESH_BUFFER_NORMALS 2
+#define MESH_BUFFER_COLORS 3
+#define MESH_BUFFER_TANGENTS 4
+#define MESH_BUFFER_TEXCOORDS2 5
+#define MESH_BUFFER_INDICES 6
+
+// Material maps per material (MAX_MATERIAL_MAPS in raylib config.h)
+#ifndef INSTANCED_MATERIAL_MAPS
+#define INSTANCED_MATERIAL_MAPS 12
+#endif
+
+// Retained instance transforms buffer, shared by every mesh drawn from it
+typedef struct InstanceBuffer {
+    unsigned int vboId;         // OpenGL Vertex Buffer Object id
+    int capacity;               // Number of transforms stored
+    long long uploadedBytes;    // Bytes uploaded since load, to track per frame uploads
+} InstanceBuffer;
+
+// Model bound to an instance buffer, one vertex array per mesh
+typedef struct InstancedModel {
+    Model model;                // Drawn model (not owned)
+    Shader shader;              // Instancing shader, SHADER_LOC_MATRIX_MODEL is the transform attribute
+    InstanceBuffer buffer;      // Instance transforms (not owned)
+    unsigned int* vaoIds;       // Vertex array per mesh (mesh buffers + instance transforms)
+    int viewCount;              // Instances drawn per transform (multi-view draws), 0 draws each transform once
+} InstancedModel;
+
+// Load instance transforms buffer, transforms can be NULL to only reserve storage
+InstanceBuffer LoadInstanceBuffer(const Matrix* transforms, int capacity)
+{
+    InstanceBuffer buffer = { 0 };
+    buffer.capacity = capacity;
+    buffer.vboId = rlLoadVertexBuffer(NULL, capacity * sizeof(float16), true);
+    rlDisableVertexBuffer();
+
+    if (transforms != NULL)
+    {
+        float16* data = (float16*)RL_MALLOC(capacity * sizeof(float16));
+        for (int i = 0; i < capacity; i++)
+            data[i] = MatrixToFloatV(transforms[i]);
+
+        rlUpdateVertexBuffer(buffer.vboId, data, capacity * sizeof(float16), 0);
+        buffer.uploadedBytes += capacity * sizeof(float16);
+        RL_FREE(data);
+    }
+
+    return buffer;
+}
+
+// Update a range of instance transforms, only changed instances need to be uploaded
+void UpdateInstanceBuffer(InstanceBuffer* buffer, const Matrix* transforms, int offset, int count)
+{
+    if (offset + count > buffer->capacity)
+        count = buffer->capacity - offset;
+    if (count <= 0)
+        return;
+
+    float16* data = (float16*)RL_MALLOC(count * sizeof(float16));
+    for (int i = 0; i < count; i++)
+        data[i] = MatrixToFloatV(transforms[i]);
+
+    rlUpdateVertexBuffer(buffer->vboId, data, count * sizeof(float16), offset * sizeof(float16));
+    buffer->uploadedBytes += count * sizeof(float16);
+    RL_FREE(data);
+}
+
+// Update a range of raw instance records, each record is read by the shader as one mat4 attribute
+void UpdateInstanceBufferData(InstanceBuffer* buffer, const void* data, int offset, int count)
+{
+    if (offset + count > buffer->capacity)
+        count = buffer->capacity - offset;
+    if (count <= 0)
+        return;
+
+    rlUpdateVertexBuffer(buffer->vboId, data, count * sizeof(float16), offset * sizeof(float16));
+    buffer->uploadedBytes += count * sizeof(float16);
+}
+
+// Unload instance transforms buffer
+void UnloadInstanceBuffer(InstanceBuffer buffer)
+{
+    rlUnloadVertexBuffer(buffer.vboId);
+}
+
+// Set instance transform attributes, starting at a given instance
+void SetInstancedModelBase(InstancedModel instanced, int base)
+{
+    int location = instanced.shader.locs[SHADER_LOC_MATRIX_MODEL];
+    int divisor = (instanced.viewCount > 1) ? instanced.viewCount : 1;
+
+    rlEnableVertexBuffer(instanced.buffer.vboId);
+    for (int i = 0; i < 4; i++)
+    {
+        rlEnableVertexAttribute(location + i);
+        rlSetVertexAttribute(location + i, 4, RL_FLOAT, false, sizeof(float16), (void*)((size_t)base * sizeof(float16) + i * sizeof(Vector4)));
+        rlSetVertexAttributeDivisor(location + i, divisor);
+    }
+}
+
+// Bind mesh vertex buffers to a new vertex array, using default attribute locations
+void BindInstancedMeshBuffer(Mesh mesh, int buffer, int location, int size, int type, bool normalized)
+{
+    if (mesh.vboId[buffer] == 0)
+        return;
+
+    rlEnableVertexBuffer(mesh.vboId[buffer]);
+    rlSetVertexAttribute(location, size, type, normalized, 0, 0);
+    rlEnableVertexAttribute(location);
+}
+
+// Load model bound to an instance buffer
+// NOTE: Mesh buffers are shared with the model, raylib mesh vertex arrays are left untouched
+InstancedModel LoadInstancedModel(Model model, Shader shader, InstanceBuffer buffer)
+{
+    InstancedModel instanced = { 0 };
+    instanced.model = model;
+    instanced.shader = shader;
+    instanced.buffer = buffer;
+    instanced.vaoIds = (unsigned int*)RL_CALLOC(model.meshCount, sizeof(unsigned int));
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        Mesh mesh = model.meshes[i];
+
+        instanced.vaoIds[i] = rlLoadVertexArray();
+        rlEnableVertexArray(instanced.vaoIds[i]);
+
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_POSITIONS, 0, 3, RL_FLOAT, false);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_TEXCOORDS, 1, 2, RL_FLOAT, false);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_NORMALS, 2, 3, RL_FLOAT, false);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_COLORS, 3, 4, RL_UNSIGNED_BYTE, true);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_TANGENTS, 4, 4, RL_FLOAT, false);
+        BindInstancedMeshBuffer(mesh, MESH_BUFFER_TEXCOORDS2, 5, 2, RL_FLOAT, false);
+
+        if (mesh.vboId[MESH_BUFFER_INDICES] != 0)
+            rlEnableVertexBufferElement(mesh.vboId[MESH_BUFFER_INDICES]);
+
+        SetInstancedModelBase(instanced, 0);
+
+        rlDisableVertexArray();
+    }
+
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+
+    return instanced;
+}
+
+// Unload instanced model vertex arrays (model and instance buffer are not unloaded)
+void UnloadInstancedModel(InstancedModel instanced)
+{
+    for (int i = 0; i < instanced.model.meshCount; i++)
+        rlUnloadVertexArray(instanced.vaoIds[i]);
+
+    RL_FREE(instanced.vaoIds);
+}
+
+// Draw a range of instances of every mesh of the model, nothing is uploaded but uniforms
+void DrawInstancedModel(InstancedModel instanced, int offset, int count)
+{
+    if (offset + count > instanced.buffer.capacity)
+        count = instanced.buffer.capacity - offset;
+    if (count <= 0)
+        return;
+
+    // Every transform is drawn once per view
+    int views = (instanced.viewCount > 1) ? instanced.viewCount : 1;
+    bool rebase = (offset != 0) || (views > 1);
+
+    Shader shader = instanced.shader;
+
+    // Flush pending batched draws, instances are drawn directly
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(shader.id);
+
+    // Matrices as uploaded by DrawMeshInstanced(), model matrix is per instance
+    Matrix matView = rlGetMatrixModelview();
+    Matrix matProjection = rlGetMatrixProjection();
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), matView);
+
+    if (shader.locs[SHADER_LOC_MATRIX_VIEW] != -1)
+        rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_VIEW], matView);
+    if (shader.locs[SHADER_LOC_MATRIX_PROJECTION] != -1)
+        rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_PROJECTION], matProjection);
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(matModelView, matProjection));
+
+    for (int m = 0; m < instanced.model.meshCount; m++)
+    {
+        Mesh mesh = instanced.model.meshes[m];
+        Material material = instanced.model.materials[instanced.model.meshMaterial[m]];
+
+        if (shader.locs[SHADER_LOC_COLOR_DIFFUSE] != -1)
+        {
+            Color color = material.maps[MATERIAL_MAP_DIFFUSE].color;
+            float values[4] = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+            rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], values, SHADER_UNIFORM_VEC4, 1);
+        }
+
+        // Bind material texture maps
+        for (int i = 0; i < INSTANCED_MATERIAL_MAPS; i++)
+        {
+            if (material.maps[i].texture.id > 0)
+            {
+                rlActiveTextureSlot(i);
+                if ((i == MATERIAL_MAP_IRRADIANCE) || (i == MATERIAL_MAP_PREFILTER) || (i == MATERIAL_MAP_CUBEMAP))
+                    rlEnableTextureCubemap(material.maps[i].texture.id);
+                else
+                    rlEnableTexture(material.maps[i].texture.id);
+
+                rlSetUniform(shader.locs[SHADER_LOC_MAP_DIFFUSE + i], &i, SHADER_UNIFORM_INT, 1);
+            }
+        }
+
+        rlEnableVertexArray(instanced.vaoIds[m]);
+
+        // Instance ranges are selected by moving the attribute start
+        if (rebase)
+            SetInstancedModelBase(instanced, offset);
+
+        if (mesh.indices != NULL)
+            rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, 0, count * views);
+        else
+            rlDrawVertexArrayInstanced(0, mesh.vertexCount, count * views);
+
+        if (rebase)
+        {
+            InstancedModel restored = instanced;
+            restored.viewCount = 0;
+            SetInstancedModelBase(restored, 0);
+        }
+
+        for (int i = 0; i < INSTANCED_MATERIAL_MAPS; i++)
+        {
+            if (material.maps[i].texture.id > 0)
+            {
+                rlActiveTextureSlot(i);
+                if ((i == MATERIAL_MAP_IRRADIANCE) || (i == MATERIAL_MAP_PREFILTER) || (i == MATERIAL_MAP_CUBEMAP))
+                    rlDisableTextureCubemap();
+                else
+                    rlDisableTexture();
+            }
+        }
+    }
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableShader();
+}
+
+#endif // MODEL_INSTANCED_H
@@ -0,0 +1,207 @@
+#ifndef MULTI_VIEW_H
+#define MULTI_VIEW_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "instance_passes.h"
+#include "model_instanced.h"
+#include "visibility_cache.h"
+
+// Maximum views of one draw (viewProjections array size in instanced.vs)
+#define MULTI_VIEW_MAX 16
+
+// Clip planes of a view region (left, right, bottom, top)
+#define MULTI_VIEW_CLIP_PLANES 4
+
+// Multi-view timings and counters, reset by UpdateMultiView()
+typedef struct MultiViewStats {
+    double cullTime;                    // Seconds spent culling chunks for every view
+    double submitTime;                  // Seconds spent submitting draws
+    int drawCalls;
+    int instances;                      // Instances drawn, every view of a transform included
+    int visible[MULTI_VIEW_MAX];        // Instances in chunks visible from each view
+} MultiViewStats;
+
+// Views drawn by one instanced draw, each view is a camera and a region of the target
+// NOTE: Instance attributes advance once every view count instances (attribute divisor), so
+// gl_InstanceID modulo the view count is the view of an instance. The vertex shader moves the
+// view clip space into the view region and clip distances keep it inside, no layered target
+// or geometry shader is needed, so views are regions of one target (split screen, minimap,
+// cube faces side by side). Culling is merged, a chunk is drawn when any view sees it
+typedef struct MultiView {
+    Shader shader;                      // Multi-view variant (SHADER_FEATURE_MULTI_VIEW)
+    int viewCountLoc;
+    int viewProjectionsLoc;
+    int viewRegionsLoc;
+
+    int count;                          // Views in use
+    Camera3D cameras[MULTI_VIEW_MAX];
+    Rectangle regions[MULTI_VIEW_MAX];  // Target regions (pixels, from the top left corner)
+
+    Matrix viewProjections[MULTI_VIEW_MAX]; // Instance space to view clip space
+    Vector4 clipRegions[MULTI_VIEW_MAX];    // Region in target clip space (scale, offset)
+
+    MultiViewStats stats;
+} MultiView;
+
+// Load multi-view state for a shader variant with the MULTI_VIEW feature
+MultiView LoadMultiView(Shader shader)
+{
+    MultiView views = { 0 };
+    views.shader = shader;
+    views.viewCountLoc = GetShaderLocation(shader, "viewCount");
+    views.viewProjectionsLoc = GetShaderLocation(shader, "viewProjections");
+    views.viewRegionsLoc = GetShaderLocation(shader, "viewRegions");
+
+    if ((views.viewCountLoc == -1) || (views.viewProjectionsLoc == -1) || (views.viewRegionsLoc == -1))
+        TraceLog(LOG_WARNING, "VIEWS: Shader [ID %i] has no multi-view uniforms", shader.id);
+
+    return views;
+}
+
+// Remove every view
+void ClearMultiView(MultiView* views)
+{
+    views->count = 0;
+}
+
+// Add a view drawn into a target region, returns view index or -1 when every view is used
+int AddMultiView(MultiView* views, Camera3D camera, Rectangle region)
+{
+    if (views->count >= MULTI_VIEW_MAX)
+    {
+        TraceLog(LOG_WARNING, "VIEWS: Failed to add view, %i views maximum", MULTI_VIEW_MAX);
+        return -1;
+    }
+
+    views->cameras[views->count] = camera;
+    views->regions[views->count] = region;
+
+    return views->count++;
+}
+
+// Update view matrices and regions for a target size, transform is the instance space (rlgl transform)
+// NOTE: Projections match BeginMode3D() with the aspect of each region
+void UpdateMultiView(MultiView* views, Matrix transform, int width, int height)
+{
+    views->stats = (MultiViewStats) { 0 };
+
+    for (int i = 0; i < views->count; i++)
+    {
+        Camera3D camera = views->cameras[i];
+        Rectangle region = views->regions[i];
+        double aspect = (double)region.width / (double)region.height;
+
+        Matrix projection = MatrixIdentity();
+        if (camera.projection == CAMERA_ORTHOGRAPHIC)
+        {
+            double top = camera.fovy / 2.0;
+            double right = top * aspect;
+            projection = MatrixOrtho(-right, right, -top, top, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+        }
+        else
+            projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+
+        Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+        views->viewProjections[i] = MatrixMultiply(MatrixMultiply(transform, view), projection);
+
+        // Region center and size in target clip space, y goes up
+        views->clipRegions[i] = (Vector4) {
+            region.width / width,
+            region.height / height,
+            (region.x + region.width * 0.5f) / width * 2.0f - 1.0f,
+            1.0f - (region.y + region.height * 0.5f) / height * 2.0f
+        };
+    }
+}
+
+// Cull chunks against views [firstView, firstView + viewCount), ranges hold chunks visible from any of them
+void CullMultiViewChunks(MultiView* views, int firstView, int viewCount, InstanceChunks chunks, InstanceRanges* ranges)
+{
+    double startTime = GetTime();
+
+    Vector4 planes[MULTI_VIEW_MAX][6];
+    for (int v = 0; v < viewCount; v++)
+        GetFrustumPlanes(views->viewProjections[firstView + v], planes[v]);
+
+    ranges->count = 0;
+    ranges->instances = 0;
+
+    bool previousVisible = false;
+    for (int c = 0; c < chunks.chunkCount; c++)
+    {
+        Vector4 s = chunks.spheres[c];
+        int start = c * INSTANCE_CHUNK_SIZE;
+        int count = (start + INSTANCE_CHUNK_SIZE < chunks.instanceCount) ? INSTANCE_CHUNK_SIZE : chunks.instanceCount - start;
+
+        bool visible = false;
+        for (int v = 0; v < viewCount; v++)
+        {
+            float margin = 0.0f;
+            if (TestFrustumSphere(planes[v], (Vector3) { s.x, s.y, s.z }, s.w, &margin))
+            {
+                views->stats.visible[firstView + v] += count;
+                visible = true;
+            }
+        }
+
+        if (!visible)
+        {
+            previousVisible = false;
+            continue;
+        }
+
+        // Extend the previous range when the previous chunk is visible too
+        if (previousVisible)
+        {
+            ranges->counts[ranges->count - 1] += count;
+        }
+        else
+        {
+            ranges->offsets[ranges->count] = start;
+            ranges->counts[ranges->count] = count;
+            ranges->count++;
+        }
+
+        ranges->instances += count;
+        previousVisible = true;
+    }
+
+    views->stats.cullTime += GetTime() - startTime;
+}
+
+// Draw instance ranges into views [firstView, firstView + viewCount) with one draw per range and mesh
+// NOTE: Model instance attribute must use the multi-view shader layout
+void DrawMultiViewRanges(MultiView* views, int firstView, int viewCount, InstancedModel instanced, InstanceRanges ranges)
+{
+    double startTime = GetTime();
+
+    float16 matrices[MULTI_VIEW_MAX] = { 0 };
+    for (int v = 0; v < viewCount; v++)
+        matrices[v] = MatrixToFloatV(views->viewProjections[firstView + v]);
+
+    rlDrawRenderBatchActive();
+    rlEnableShader(views->shader.id);
+    rlSetUniform(views->viewCountLoc, &viewCount, SHADER_UNIFORM_INT, 1);
+    glUniformMatrix4fv(views->viewProjectionsLoc, viewCount, GL_FALSE, (const float*)matrices);
+    rlSetUniform(views->viewRegionsLoc, &views->clipRegions[firstView], SHADER_UNIFORM_VEC4, viewCount);
+
+    for (int i = 0; i < MULTI_VIEW_CLIP_PLANES; i++)
+        glEnable(GL_CLIP_DISTANCE0 + i);
+
+    instanced.shader = views->shader;
+    instanced.viewCount = viewCount;
+    for (int i = 0; i < ranges.count; i++)
+        DrawInstancedModel(instanced, ranges.offsets[i], ranges.counts[i]);
+
+    for (int i = 0; i < MULTI_VIEW_CLIP_PLANES; i++)
+        glDisable(GL_CLIP_DISTANCE0 + i);
+
+    views->stats.drawCalls += ranges.count * instanced.model.meshCount;
+    views->stats.instances += ranges.instances * viewCount;
+    views->stats.submitTime += GetTime() - startTime;
+}
+
+#endif // MULTI_VIEW_H
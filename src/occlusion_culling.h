@@ -0,0 +1,409 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "worker_pool.h"
+
+// Software occlusion culling, occluders are rasterized on the CPU into a small
+// depth buffer and instance bounds are tested against its depth pyramid
+// NOTE: No GPU state or window is used, CheckOcclusionCulling() tests culling without a GPU
+// context (build.sh runs it from src/checks/occlusion_check.c)
+
+// Maximum depth pyramid levels (1x1 is reached first for buffers up to 32768 pixels wide)
+#define OCCLUSION_MAX_LEVELS 16
+
+// Vertices closer than this clip w are not rasterized (occluders) or always visible (bounds)
+#define OCCLUSION_NEAR_W 1e-4f
+
+// Timer used for stats (seconds), monotonic clock that needs no window, can be replaced by the application
+#ifndef OCCLUSION_TIME
+#define OCCLUSION_TIME() GetWorkerTime()
+#endif
+
+// Occlusion culling statistics for current frame
+typedef struct OcclusionStats {
+    int occluderTriangles;  // Triangles rasterized
+    int tested;             // Bounds tested
+    int culled;             // Bounds found occluded
+    double rasterTime;      // Occluders rasterization and pyramid build time (seconds)
+    double testTime;        // Bounds test time (seconds)
+} OcclusionStats;
+
+// Occlusion depth buffer, depth goes from 0 (near) to 1 (far)
+typedef struct OcclusionBuffer {
+    int width;                                  // Level 0 width
+    int height;                                 // Level 0 height
+    int levelCount;                             // Depth pyramid levels
+    int levelWidth[OCCLUSION_MAX_LEVELS];       // Level widths
+    int levelHeight[OCCLUSION_MAX_LEVELS];      // Level heights
+    float* levels[OCCLUSION_MAX_LEVELS];        // Farthest depth per texel, level 0 is the depth buffer
+
+    Matrix viewProjection;                      // Transform from occluder/bounds space to clip space
+    OcclusionStats stats;                       // Current frame statistics
+} OcclusionBuffer;
+
+// Load occlusion buffer and its depth pyramid
+OcclusionBuffer LoadOcclusionBuffer(int width, int height)
+{
+    OcclusionBuffer buffer = { 0 };
+    buffer.width = width;
+    buffer.height = height;
+
+    int w = width;
+    int h = height;
+    while (buffer.levelCount < OCCLUSION_MAX_LEVELS)
+    {
+        buffer.levelWidth[buffer.levelCount] = w;
+        buffer.levelHeight[buffer.levelCount] = h;
+        buffer.levels[buffer.levelCount] = (float*)RL_CALLOC(w * h, sizeof(float));
+        buffer.levelCount++;
+
+        if ((w == 1) && (h == 1))
+            break;
+
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+
+    return buffer;
+}
+
+// Unload occlusion buffer
+void UnloadOcclusionBuffer(OcclusionBuffer* buffer)
+{
+    for (int i = 0; i < buffer->levelCount; i++)
+        RL_FREE(buffer->levels[i]);
+
+    buffer->levelCount = 0;
+}
+
+// Clear depth and stats, occluders and bounds are then given in the space viewProjection transforms from
+void BeginOcclusionFrame(OcclusionBuffer* buffer, Matrix viewProjection)
+{
+    buffer->viewProjection = viewProjection;
+    buffer->stats = (OcclusionStats) { 0 };
+
+    float* depth = buffer->levels[0];
+    for (int i = 0; i < buffer->width * buffer->height; i++)
+        depth[i] = 1.0f;
+}
+
+// Transform a point to clip space, w is returned separately
+Vector3 GetOcclusionClipPosition(Matrix mat, Vector3 v, float* w)
+{
+    // NOTE: raymath matrices are stored by rows of columns (m0, m4, m8, m12 is the first row)
+    Vector3 result = {
+        mat.m0 * v.x + mat.m4 * v.y + mat.m8 * v.z + mat.m12,
+        mat.m1 * v.x + mat.m5 * v.y + mat.m9 * v.z + mat.m13,
+        mat.m2 * v.x + mat.m6 * v.y + mat.m10 * v.z + mat.m14
+    };
+    *w = mat.m3 * v.x + mat.m7 * v.y + mat.m11 * v.z + mat.m15;
+
+    return result;
+}
+
+// Rasterize one occluder triangle given in screen space (x, y in pixels, z in [0, 1])
+void RasterizeOcclusionTriangle(OcclusionBuffer* buffer, Vector3 v0, Vector3 v1, Vector3 v2)
+{
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (area == 0.0f)
+        return;
+
+    // Both windings are rasterized, back faces lose the depth test anyway
+    if (area < 0.0f)
+    {
+        Vector3 tmp = v1;
+        v1 = v2;
+        v2 = tmp;
+        area = -area;
+    }
+
+    int minX = (int)fmaxf(floorf(fminf(v0.x, fminf(v1.x, v2.x))), 0.0f);
+    int minY = (int)fmaxf(floorf(fminf(v0.y, fminf(v1.y, v2.y))), 0.0f);
+    int maxX = (int)fminf(ceilf(fmaxf(v0.x, fmaxf(v1.x, v2.x))), (float)buffer->width - 1.0f);
+    int maxY = (int)fminf(ceilf(fmaxf(v0.y, fmaxf(v1.y, v2.y))), (float)buffer->height - 1.0f);
+    if ((minX > maxX) || (minY > maxY))
+        return;
+
+    // Edge functions are stepped incrementally along rows and columns
+    float a0 = v1.y - v2.y, b0 = v2.x - v1.x;
+    float a1 = v2.y - v0.y, b1 = v0.x - v2.x;
+    float a2 = v0.y - v1.y, b2 = v1.x - v0.x;
+
+    float px = minX + 0.5f;
+    float py = minY + 0.5f;
+    float row0 = (px - v1.x) * a0 + (py - v1.y) * b0;
+    float row1 = (px - v2.x) * a1 + (py - v2.y) * b1;
+    float row2 = (px - v0.x) * a2 + (py - v0.y) * b2;
+
+    // Depth is affine in screen space
+    float invArea = 1.0f / area;
+    float dz1 = (v1.z - v0.z) * invArea;
+    float dz2 = (v2.z - v0.z) * invArea;
+
+    float* depth = buffer->levels[0];
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        float e0 = row0;
+        float e1 = row1;
+        float e2 = row2;
+        float* line = &depth[y * buffer->width];
+
+        for (int x = minX; x <= maxX; x++)
+        {
+            if ((e0 >= 0.0f) && (e1 >= 0.0f) && (e2 >= 0.0f))
+            {
+                float z = v0.z + e1 * dz1 + e2 * dz2;
+                if (z < line[x])
+                    line[x] = z;
+            }
+
+            e0 += a0;
+            e1 += a1;
+            e2 += a2;
+        }
+
+        row0 += b0;
+        row1 += b1;
+        row2 += b2;
+    }
+}
+
+// Rasterize occluder mesh triangles into the depth buffer
+// NOTE: Triangles crossing the near plane are skipped, which only makes culling less aggressive
+void RasterizeOccluder(OcclusionBuffer* buffer, Mesh mesh, Matrix transform)
+{
+    double start = OCCLUSION_TIME();
+
+    Matrix mat = MatrixMultiply(transform, buffer->viewProjection);
+    int triangleCount = (mesh.indices != NULL) ? mesh.triangleCount : mesh.vertexCount / 3;
+
+    for (int t = 0; t < triangleCount; t++)
+    {
+        Vector3 screen[3] = { 0 };
+        bool clipped = false;
+
+        for (int k = 0; k < 3; k++)
+        {
+            int index = (mesh.indices != NULL) ? mesh.indices[t * 3 + k] : t * 3 + k;
+            Vector3 v = { mesh.vertices[index * 3], mesh.vertices[index * 3 + 1], mesh.vertices[index * 3 + 2] };
+
+            float w = 0.0f;
+            Vector3 clip = GetOcclusionClipPosition(mat, v, &w);
+            if (w <= OCCLUSION_NEAR_W)
+            {
+                clipped = true;
+                break;
+            }
+
+            screen[k].x = (clip.x / w * 0.5f + 0.5f) * buffer->width;
+            screen[k].y = (0.5f - clip.y / w * 0.5f) * buffer->height;
+            screen[k].z = clip.z / w * 0.5f + 0.5f;
+        }
+
+        if (clipped)
+            continue;
+
+        RasterizeOcclusionTriangle(buffer, screen[0], screen[1], screen[2]);
+        buffer->stats.occluderTriangles++;
+    }
+
+    buffer->stats.rasterTime += OCCLUSION_TIME() - start;
+}
+
+// Build depth pyramid, each texel keeps the farthest depth of the texels below it
+void BuildOcclusionPyramid(OcclusionBuffer* buffer)
+{
+    double start = OCCLUSION_TIME();
+
+    for (int level = 1; level < buffer->levelCount; level++)
+    {
+        const float* src = buffer->levels[level - 1];
+        int srcWidth = buffer->levelWidth[level - 1];
+        int srcHeight = buffer->levelHeight[level - 1];
+
+        float* dst = buffer->levels[level];
+        int width = buffer->levelWidth[level];
+        int height = buffer->levelHeight[level];
+
+        for (int y = 0; y < height; y++)
+        {
+            int y0 = y * 2;
+            int y1 = (y0 + 1 < srcHeight) ? y0 + 1 : y0;
+
+            for (int x = 0; x < width; x++)
+            {
+                int x0 = x * 2;
+                int x1 = (x0 + 1 < srcWidth) ? x0 + 1 : x0;
+
+                float depth = fmaxf(fmaxf(src[y0 * srcWidth + x0], src[y0 * srcWidth + x1]),
+                    fmaxf(src[y1 * srcWidth + x0], src[y1 * srcWidth + x1]));
+                dst[y * width + x] = depth;
+            }
+        }
+    }
+
+    buffer->stats.rasterTime += OCCLUSION_TIME() - start;
+}
+
+// Check if a bounding box is hidden behind rasterized occluders
+// NOTE: Boxes crossing the near plane or outside the screen are never occluded
+bool IsBoxOccluded(OcclusionBuffer* buffer, BoundingBox box)
+{
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    float nearest = 1e30f;
+
+    for (int i = 0; i < 8; i++)
+    {
+        Vector3 corner = {
+            (i & 1) ? box.max.x : box.min.x,
+            (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z
+        };
+
+        float w = 0.0f;
+        Vector3 clip = GetOcclusionClipPosition(buffer->viewProjection, corner, &w);
+        if (w <= OCCLUSION_NEAR_W)
+            return false;
+
+        float x = clip.x / w;
+        float y = clip.y / w;
+        minX = fminf(minX, x);
+        maxX = fmaxf(maxX, x);
+        minY = fminf(minY, y);
+        maxY = fmaxf(maxY, y);
+        nearest = fminf(nearest, clip.z / w * 0.5f + 0.5f);
+    }
+
+    if ((maxX < -1.0f) || (minX > 1.0f) || (maxY < -1.0f) || (minY > 1.0f))
+        return false;
+
+    // Screen rectangle in level 0 pixels (y goes down)
+    int x0 = (int)fmaxf((minX * 0.5f + 0.5f) * buffer->width, 0.0f);
+    int x1 = (int)fminf((maxX * 0.5f + 0.5f) * buffer->width, (float)buffer->width - 1.0f);
+    int y0 = (int)fmaxf((0.5f - maxY * 0.5f) * buffer->height, 0.0f);
+    int y1 = (int)fminf((0.5f - minY * 0.5f) * buffer->height, (float)buffer->height - 1.0f);
+
+    // Pick the level where the rectangle covers at most 4x4 texels,
+    // coarser levels read fewer texels but reject fewer bounds near occluder edges
+    int level = 0;
+    while ((level < buffer->levelCount - 1) && (((x1 >> level) - (x0 >> level) > 3) || ((y1 >> level) - (y0 >> level) > 3)))
+        level++;
+
+    const float* depth = buffer->levels[level];
+    int width = buffer->levelWidth[level];
+
+    float farthest = 0.0f;
+    for (int y = y0 >> level; y <= (y1 >> level); y++)
+    {
+        for (int x = x0 >> level; x <= (x1 >> level); x++)
+            farthest = fmaxf(farthest, depth[y * width + x]);
+    }
+
+    return nearest > farthest;
+}
+
+// Check if a bounding sphere is hidden behind rasterized occluders
+bool IsSphereOccluded(OcclusionBuffer* buffer, Vector3 center, float radius)
+{
+    BoundingBox box = {
+        (Vector3) { center.x - radius, center.y - radius, center.z - radius },
+        (Vector3) { center.x + radius, center.y + radius, center.z + radius }
+    };
+
+    return IsBoxOccluded(buffer, box);
+}
+
+// Check if an instance is hidden, bounds are the mesh local bounding box
+// NOTE: Bounds are enclosed in a sphere scaled by the largest transform axis
+bool IsInstanceOccluded(OcclusionBuffer* buffer, Matrix transform, BoundingBox bounds)
+{
+    Vector3 localCenter = Vector3Scale(Vector3Add(bounds.min, bounds.max), 0.5f);
+    float localRadius = Vector3Length(Vector3Subtract(bounds.max, localCenter));
+
+    float scaleX = Vector3Length((Vector3) { transform.m0, transform.m1, transform.m2 });
+    float scaleY = Vector3Length((Vector3) { transform.m4, transform.m5, transform.m6 });
+    float scaleZ = Vector3Length((Vector3) { transform.m8, transform.m9, transform.m10 });
+    float radius = localRadius * fmaxf(scaleX, fmaxf(scaleY, scaleZ));
+
+    return IsSphereOccluded(buffer, Vector3Transform(localCenter, transform), radius);
+}
+
+// Test instances bounds and copy visible transforms, returns visible count
+int CullOccludedInstances(OcclusionBuffer* buffer, const Matrix* transforms, int count, BoundingBox bounds, Matrix* visible)
+{
+    double start = OCCLUSION_TIME();
+
+    int visibleCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (IsInstanceOccluded(buffer, transforms[i], bounds))
+            buffer->stats.culled++;
+        else
+            visible[visibleCount++] = transforms[i];
+    }
+
+    buffer->stats.tested += count;
+    buffer->stats.testTime += OCCLUSION_TIME() - start;
+
+    return visibleCount;
+}
+
+// Test instances bounds and store visible instance indices, returns visible count
+int CullOccludedIndices(OcclusionBuffer* buffer, const Matrix* transforms, int count, BoundingBox bounds, unsigned int* visible)
+{
+    double start = OCCLUSION_TIME();
+
+    int visibleCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (IsInstanceOccluded(buffer, transforms[i], bounds))
+            buffer->stats.culled++;
+        else
+            visible[visibleCount++] = i;
+    }
+
+    buffer->stats.tested += count;
+    buffer->stats.testTime += OCCLUSION_TIME() - start;
+
+    return visibleCount;
+}
+
+// Check rasterization and tests against a known scene, returns true when every check passes
+// NOTE: A quad occluder faces the camera, a box behind it must be occluded while boxes
+// beside it and in front of it must stay visible
+bool CheckOcclusionCulling(void)
+{
+    OcclusionBuffer buffer = LoadOcclusionBuffer(64, 64);
+
+    Matrix view = MatrixLookAt((Vector3) { 0.0f, 0.0f, 0.0f }, (Vector3) { 0.0f, 0.0f, -1.0f }, (Vector3) { 0.0f, 1.0f, 0.0f });
+    Matrix projection = MatrixPerspective(90.0f * DEG2RAD, 1.0, 0.1, 100.0);
+    BeginOcclusionFrame(&buffer, MatrixMultiply(view, projection));
+
+    float vertices[12] = { -2.0f, -2.0f, -5.0f, 2.0f, -2.0f, -5.0f, 2.0f, 2.0f, -5.0f, -2.0f, 2.0f, -5.0f };
+    unsigned short indices[6] = { 0, 1, 2, 0, 2, 3 };
+    Mesh quad = { 0 };
+    quad.vertexCount = 4;
+    quad.triangleCount = 2;
+    quad.vertices = vertices;
+    quad.indices = indices;
+
+    RasterizeOccluder(&buffer, quad, MatrixIdentity());
+    BuildOcclusionPyramid(&buffer);
+
+    bool behind = IsSphereOccluded(&buffer, (Vector3) { 0.0f, 0.0f, -10.0f }, 0.5f);
+    bool beside = IsSphereOccluded(&buffer, (Vector3) { 6.0f, 0.0f, -10.0f }, 0.5f);
+    bool front = IsSphereOccluded(&buffer, (Vector3) { 0.0f, 0.0f, -3.0f }, 0.5f);
+
+    UnloadOcclusionBuffer(&buffer);
+
+    bool passed = behind && !beside && !front;
+    if (!passed)
+        TraceLog(LOG_WARNING, "OCCLUSION: Self-check failed (behind: %i, beside: %i, front: %i)", behind, beside, front);
+
+    return passed;
+}
+
+#endif // OCCLUSION_CULLING_H
@@ -0,0 +1,72 @@
+#ifndef ORBITAL_MOTION_H
+#define ORBITAL_MOTION_H
+
+#include "raylib.h"
+#include "raymath.h"
+
+// Required for: sinf(), cosf(), sqrtf()
+#include <math.h>
+
+// Orbital parameters of one instance, the transform at any time is built from them
+// NOTE: Record is 16 floats so it is read by the shader as one mat4 attribute (one column per line),
+// see resources/shaders/asteroids_orbital.vs which must match GetOrbitalTransform()
+typedef struct OrbitalParams {
+    float radius, phase, angularVelocity, inclination;  // Orbit radius, angle at time 0, radians per second, plane tilt around x
+    float node, height, scale, unused;                  // Orbit plane rotation around y, offset above plane, uniform scale
+    Vector3 spinAxis;                                   // Spin axis (normalized)
+    float spinPhase;                                    // Spin angle at time 0
+    float spinRate, padding[3];                         // Spin radians per second
+} OrbitalParams;
+
+// Get instance position at a given time
+Vector3 GetOrbitalPosition(OrbitalParams orbit, float time)
+{
+    float angle = orbit.phase + orbit.angularVelocity * time;
+
+    // Position in the orbit plane, same layout as the static ring (x = sin, z = cos)
+    float x = sinf(angle) * orbit.radius;
+    float y = orbit.height;
+    float z = cosf(angle) * orbit.radius;
+
+    // Tilt the plane around x, then rotate it around y
+    float ci = cosf(orbit.inclination), si = sinf(orbit.inclination);
+    float ty = ci * y - si * z;
+    float tz = si * y + ci * z;
+
+    float cn = cosf(orbit.node), sn = sinf(orbit.node);
+
+    return (Vector3) { cn * x + sn * tz, ty, -sn * x + cn * tz };
+}
+
+// Get instance transform at a given time (scale, spin, then orbit position)
+// NOTE: CPU reference of the orbital shader, culling and picking use it to match rendered positions
+Matrix GetOrbitalTransform(OrbitalParams orbit, float time)
+{
+    Vector3 position = GetOrbitalPosition(orbit, time);
+
+    Matrix matScale = MatrixScale(orbit.scale, orbit.scale, orbit.scale);
+    Matrix matRotation = MatrixRotate(orbit.spinAxis, orbit.spinPhase + orbit.spinRate * time);
+    Matrix matTranslation = MatrixTranslate(position.x, position.y, position.z);
+
+    return MatrixMultiply(MatrixMultiply(matScale, matRotation), matTranslation);
+}
+
+// Get transforms of a list of instances at a given time
+void GetOrbitalTransforms(const OrbitalParams* orbits, int count, float time, Matrix* transforms)
+{
+    for (int i = 0; i < count; i++)
+        transforms[i] = GetOrbitalTransform(orbits[i], time);
+}
+
+// Get angular velocity of a circular orbit, inner orbits are faster (Kepler's third law)
+// NOTE: Speed is given at a reference radius
+float GetOrbitalVelocity(float radius, float referenceRadius, float referenceVelocity)
+{
+    if (radius <= 0.0f)
+        return referenceVelocity;
+
+    float ratio = referenceRadius / radius;
+    return referenceVelocity * ratio * sqrtf(ratio);
+}
+
+#endif // ORBITAL_MOTION_H
@@ -0,0 +1,236 @@
+#ifndef RENDER_BATCH_RING_H
+#define RENDER_BATCH_RING_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// Maximum render batches in a ring
+#ifndef RENDER_BATCH_RING_MAX
+#define RENDER_BATCH_RING_MAX 8
+#endif
+
+// Free vertices left by a flush that still counts as a full batch, rlgl flushes when the
+// next shape (up to a few hundred vertices) does not fit
+#ifndef RENDER_BATCH_RING_FULL_MARGIN
+#define RENDER_BATCH_RING_FULL_MARGIN 512
+#endif
+
+// Render batch ring stats, frame counters are from last EndRenderBatchRing()
+typedef struct RenderBatchStats {
+    int flushes;            // Batch flushes last frame
+    int forcedFlushes;      // Flushes forced by a full batch last frame
+    int drawCalls;          // Draw calls last frame
+    int drawnVertices;      // Vertices drawn last frame
+    int paddingVertices;    // Vertices uploaded for alignment last frame (vertexAlignment)
+    int syncWaits;          // Frames that had to wait for the GPU to release a batch (total)
+    int ringGrows;          // Batches added to the ring (total)
+    int elementGrows;       // Element capacity increases (total)
+} RenderBatchStats;
+
+// Ring of render batches, a batch is only filled again once the GPU is done with it
+// NOTE: Every batch is reloaded to the ring element capacity before its next use,
+// capacity doubles (up to maxElements) after a frame that forced a flush. Every flush fences the
+// batch and continues the frame in the next batch of the ring, only flushes of a full batch are
+// forced, flushes from state changes (shader, blend, mode) or the draw call limit are not
+typedef struct RenderBatchRing {
+    rlRenderBatch batches[RENDER_BATCH_RING_MAX];
+    GLsync fences[RENDER_BATCH_RING_MAX];       // Signaled when GPU finished last frame using the batch
+    int capacities[RENDER_BATCH_RING_MAX];      // Element capacity of each batch
+    int count;              // Batches in the ring
+    int maxCount;           // Batches the ring can grow to instead of waiting
+    int current;            // Batch in use, -1 outside Begin/End
+    int elements;           // Element capacity (quads) for next batch loads
+    int maxElements;        // Largest element capacity
+
+    rlRenderBatch start;    // Batch counters when the current batch was set active
+    RenderBatchStats frame; // Counters of the frame in progress
+    RenderBatchStats stats;
+} RenderBatchRing;
+
+// Load ring of count batches of elements capacity, growing up to maxCount batches and maxElements
+RenderBatchRing LoadRenderBatchRing(int count, int maxCount, int elements, int maxElements)
+{
+    RenderBatchRing ring = { 0 };
+    ring.maxCount = (maxCount < RENDER_BATCH_RING_MAX) ? maxCount : RENDER_BATCH_RING_MAX;
+    ring.count = (count < ring.maxCount) ? count : ring.maxCount;
+    ring.current = -1;
+    ring.elements = elements;
+    ring.maxElements = (maxElements > elements) ? maxElements : elements;
+
+    for (int i = 0; i < ring.count; i++)
+    {
+        ring.batches[i] = rlLoadRenderBatch(1, elements);
+        ring.capacities[i] = elements;
+    }
+
+    TraceLog(LOG_INFO, "BATCH: Render batch ring loaded (%i batches, %i elements)", ring.count, elements);
+
+    return ring;
+}
+
+// Unload ring batches and fences
+void UnloadRenderBatchRing(RenderBatchRing* ring)
+{
+    for (int i = 0; i < ring->count; i++)
+    {
+        if (ring->fences[i] != NULL)
+            glDeleteSync(ring->fences[i]);
+
+        rlUnloadRenderBatch(ring->batches[i]);
+    }
+
+    ring->count = 0;
+}
+
+// Check whether the GPU finished with a batch, without waiting
+bool IsRenderBatchReady(RenderBatchRing* ring, int index)
+{
+    if (ring->fences[index] == NULL)
+        return true;
+
+    GLenum result = glClientWaitSync(ring->fences[index], 0, 0);
+    return (result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED);
+}
+
+// Insert a new batch in the ring before index
+void InsertRenderBatch(RenderBatchRing* ring, int index)
+{
+    for (int i = ring->count; i > index; i--)
+    {
+        ring->batches[i] = ring->batches[i - 1];
+        ring->fences[i] = ring->fences[i - 1];
+        ring->capacities[i] = ring->capacities[i - 1];
+    }
+
+    ring->batches[index] = rlLoadRenderBatch(1, ring->elements);
+    ring->fences[index] = NULL;
+    ring->capacities[index] = ring->elements;
+    ring->count++;
+    ring->stats.ringGrows++;
+
+    TraceLog(LOG_INFO, "BATCH: Render batch ring grown to %i batches", ring->count);
+}
+
+void FlushRenderBatchRing(void* data);
+
+// Add counters of the current batch since it was set active to the frame counters
+void AddRenderBatchStats(RenderBatchRing* ring)
+{
+    rlRenderBatch* batch = &ring->batches[ring->current];
+    ring->frame.flushes += batch->flushes - ring->start.flushes;
+    ring->frame.drawCalls += batch->drawCalls - ring->start.drawCalls;
+    ring->frame.drawnVertices += batch->drawnVertices - ring->start.drawnVertices;
+    ring->frame.paddingVertices += batch->paddingVertices - ring->start.paddingVertices;
+}
+
+// Set next free batch of the ring active
+void SetNextRenderBatchActive(RenderBatchRing* ring)
+{
+    int next = (ring->current + 1) % ring->count;
+
+    // GPU still reads the oldest batch, add a batch before it or wait as last resort
+    if (!IsRenderBatchReady(ring, next))
+    {
+        if (ring->count < ring->maxCount)
+        {
+            InsertRenderBatch(ring, next);
+        }
+        else
+        {
+            while (glClientWaitSync(ring->fences[next], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) { }
+            ring->stats.syncWaits++;
+        }
+    }
+
+    if (ring->fences[next] != NULL)
+    {
+        glDeleteSync(ring->fences[next]);
+        ring->fences[next] = NULL;
+    }
+
+    // Batch is free, reload it if the ring capacity grew since its last use
+    if (ring->capacities[next] < ring->elements)
+    {
+        rlUnloadRenderBatch(ring->batches[next]);
+        ring->batches[next] = rlLoadRenderBatch(1, ring->elements);
+        ring->capacities[next] = ring->elements;
+    }
+
+    ring->current = next;
+    ring->batches[next].flushCallback = FlushRenderBatchRing;
+    ring->batches[next].flushData = ring;
+    ring->start = ring->batches[next];
+    rlSetRenderBatchActive(&ring->batches[next]);
+}
+
+// Batch draw callback, a flush fences the batch and moves the frame to the next batch
+// NOTE: Called by rlgl after drawing the current batch, flushes that drew nothing are ignored
+void FlushRenderBatchRing(void* data)
+{
+    RenderBatchRing* ring = (RenderBatchRing*)data;
+    rlRenderBatch* batch = &ring->batches[ring->current];
+    if (batch->flushes == ring->start.flushes)
+        return;
+
+    // Vertex counter is reset by the draw, the batch was full if its uploaded vertices
+    // (drawn and alignment) reached the capacity
+    int capacity = ring->capacities[ring->current] * 4;
+    int margin = (RENDER_BATCH_RING_FULL_MARGIN < capacity / 4) ? RENDER_BATCH_RING_FULL_MARGIN : capacity / 4;
+    int usedVertices = (batch->drawnVertices - ring->start.drawnVertices) + (batch->paddingVertices - ring->start.paddingVertices);
+    if (usedVertices + margin >= capacity)
+        ring->frame.forcedFlushes++;
+
+    // Callback is cleared first, setting the next batch active flushes this one again
+    batch->flushCallback = NULL;
+    ring->fences[ring->current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    AddRenderBatchStats(ring);
+
+    SetNextRenderBatchActive(ring);
+}
+
+// Set next free batch of the ring active, draws until EndRenderBatchRing() go to the ring
+void BeginRenderBatchRing(RenderBatchRing* ring)
+{
+    ring->frame = (RenderBatchStats) { 0 };
+    SetNextRenderBatchActive(ring);
+}
+
+// Draw active ring batch, fence it and restore the default batch
+void EndRenderBatchRing(RenderBatchRing* ring)
+{
+    if (ring->current < 0)
+        return;
+
+    rlRenderBatch* batch = &ring->batches[ring->current];
+    batch->flushCallback = NULL;
+    rlDrawRenderBatchActive();
+    ring->fences[ring->current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    AddRenderBatchStats(ring);
+
+    rlSetRenderBatchActive(NULL);
+
+    ring->stats.flushes = ring->frame.flushes;
+    ring->stats.forcedFlushes = ring->frame.forcedFlushes;
+    ring->stats.drawCalls = ring->frame.drawCalls;
+    ring->stats.drawnVertices = ring->frame.drawnVertices;
+    ring->stats.paddingVertices = ring->frame.paddingVertices;
+
+    // Frame did not fit, grow capacity so the next frames draw in a single flush
+    if ((ring->stats.forcedFlushes > 0) && (ring->elements < ring->maxElements))
+    {
+        int needed = (ring->stats.drawnVertices + ring->stats.paddingVertices + 3) / 4;
+        int elements = ring->elements * 2;
+        if (elements < needed)
+            elements = needed;
+        if (elements > ring->maxElements)
+            elements = ring->maxElements;
+
+        ring->elements = elements;
+        ring->stats.elementGrows++;
+
+        TraceLog(LOG_INFO, "BATCH: Render batch ring capacity grown to %i elements (%i forced flushes)", elements, ring->stats.forcedFlushes);
+    }
+}
+
+#endif // RENDER_BATCH_RING_H
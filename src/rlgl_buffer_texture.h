@@ -0,0 +1,134 @@
+#ifndef RLGL_BUFFER_TEXTURE_H
+#define RLGL_BUFFER_TEXTURE_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// Buffer texture texel formats (one texel is fetched per texelFetch() call)
+#define RL_BUFFER_TEXTURE_R32F GL_R32F
+#define RL_BUFFER_TEXTURE_RG32F GL_RG32F
+#define RL_BUFFER_TEXTURE_RGBA32F GL_RGBA32F
+#define RL_BUFFER_TEXTURE_R32UI GL_R32UI
+#define RL_BUFFER_TEXTURE_RGBA32UI GL_RGBA32UI
+#define RL_BUFFER_TEXTURE_RGBA8 GL_RGBA8
+
+// Buffer texture, a buffer object read in shaders through samplerBuffer
+// NOTE: Not limited by uniform storage or vertex attribute divisors,
+// any number of draws can index the same records with a base offset
+typedef struct rlBufferTexture {
+    unsigned int bufferId;  // OpenGL buffer object id (GL_TEXTURE_BUFFER)
+    unsigned int textureId; // OpenGL texture id bound to the buffer
+    int format;             // Texel format (RL_BUFFER_TEXTURE_*)
+    int size;               // Buffer size in bytes
+} rlBufferTexture;
+
+// Get texel size in bytes for a buffer texture format
+int rlGetBufferTextureTexelSize(int format)
+{
+    switch (format)
+    {
+        case RL_BUFFER_TEXTURE_R32F:
+        case RL_BUFFER_TEXTURE_R32UI:
+        case RL_BUFFER_TEXTURE_RGBA8:
+            return 4;
+        case RL_BUFFER_TEXTURE_RG32F:
+            return 8;
+        case RL_BUFFER_TEXTURE_RGBA32F:
+        case RL_BUFFER_TEXTURE_RGBA32UI:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+// Load buffer texture, data can be NULL to only reserve storage
+rlBufferTexture rlLoadBufferTexture(const void* data, int size, int format, bool dynamic)
+{
+    rlBufferTexture texture = { 0 };
+
+    int maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+
+    int texelSize = rlGetBufferTextureTexelSize(format);
+    if ((texelSize == 0) || ((long long)size / texelSize > maxTexels))
+    {
+        TraceLog(LOG_WARNING, "TBO: Failed to load buffer texture (%i bytes, max %i texels)", size, maxTexels);
+        return texture;
+    }
+
+    glGenBuffers(1, &texture.bufferId);
+    glBindBuffer(GL_TEXTURE_BUFFER, texture.bufferId);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &texture.textureId);
+    glBindTexture(GL_TEXTURE_BUFFER, texture.textureId);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, texture.bufferId);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    texture.format = format;
+    texture.size = size;
+
+    TraceLog(LOG_INFO, "TBO: [ID %i] Buffer texture loaded successfully (%i bytes)", texture.textureId, size);
+
+    return texture;
+}
+
+// Load another view of a buffer texture storage with a different texel format
+// NOTE: The view does not own the buffer, update data through the source texture
+rlBufferTexture rlLoadBufferTextureView(rlBufferTexture source, int format)
+{
+    rlBufferTexture texture = { 0 };
+
+    glGenTextures(1, &texture.textureId);
+    glBindTexture(GL_TEXTURE_BUFFER, texture.textureId);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, source.bufferId);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    texture.format = format;
+    texture.size = source.size;
+
+    return texture;
+}
+
+// Update buffer texture data, offset and size in bytes
+void rlUpdateBufferTexture(rlBufferTexture texture, const void* data, int size, int offset)
+{
+    if ((offset + size) > texture.size)
+        size = texture.size - offset;
+    if (size <= 0)
+        return;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, texture.bufferId);
+    glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Bind buffer texture to a texture slot, sampler uniform must be set to the same slot
+void rlEnableBufferTexture(rlBufferTexture texture, int slot)
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_BUFFER, texture.textureId);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Unbind buffer texture from a texture slot
+void rlDisableBufferTexture(int slot)
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Unload buffer texture from GPU memory
+void rlUnloadBufferTexture(rlBufferTexture texture)
+{
+    glDeleteTextures(1, &texture.textureId);
+    if (texture.bufferId != 0)
+        glDeleteBuffers(1, &texture.bufferId);
+
+    TraceLog(LOG_INFO, "TBO: [ID %i] Unloaded buffer texture data from VRAM (GPU)", texture.textureId);
+}
+
+#endif // RLGL_BUFFER_TEXTURE_H
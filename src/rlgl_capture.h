@@ -0,0 +1,212 @@
+#ifndef RLGL_CAPTURE_H
+#define RLGL_CAPTURE_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// Required for: memcpy()
+#include <string.h>
+
+// Maximum amount of elements (quads) that can be recorded by a single capture
+// NOTE: Shapes that overflow this limit (or the batch draw calls limit) make rlgl flush the
+// capture batch mid-way, rlEndCapture() then fails and returns an empty mesh
+#ifndef RL_CAPTURE_BUFFER_ELEMENTS
+#define RL_CAPTURE_BUFFER_ELEMENTS 8192
+#endif
+
+// Default vertex attribute locations used by rlgl (see rlLoadShaderProgram())
+#define RL_CAPTURE_ATTRIB_POSITION 0
+#define RL_CAPTURE_ATTRIB_TEXCOORD 1
+#define RL_CAPTURE_ATTRIB_COLOR 3
+
+// Captured draw, a range of vertices that share a primitive mode and texture
+typedef struct rlCapturedDraw {
+    int mode;               // RL_LINES or RL_TRIANGLES (quads are converted)
+    int vertexOffset;       // First vertex of the draw
+    int vertexCount;        // Number of vertices of the draw
+    unsigned int textureId; // Texture bound while drawing
+} rlCapturedDraw;
+
+// Static GPU mesh recorded from rlgl immediate-mode calls
+typedef struct rlCapturedMesh {
+    int vertexCount;        // Total number of vertices stored
+    int drawCount;          // Number of draws
+    rlCapturedDraw* draws;  // Draws array
+
+    unsigned int vaoId;     // OpenGL Vertex Array Object id
+    unsigned int vboId[3];  // OpenGL Vertex Buffer Objects id (positions, texcoords, colors)
+} rlCapturedMesh;
+
+// Batch receiving immediate-mode output between rlBeginCapture() and rlEndCapture()
+static rlRenderBatch captureBatch = { 0 };
+
+// Start recording immediate-mode output (rlBegin/rlVertex/rlEnd and raylib shapes)
+// NOTE: Current active batch is flushed, default batch is restored by rlEndCapture()
+void rlBeginCapture(void)
+{
+    captureBatch = rlLoadRenderBatch(1, RL_CAPTURE_BUFFER_ELEMENTS);
+    rlSetRenderBatchActive(&captureBatch);
+}
+
+// Restore default batch and unload the capture batch, recorded draws are not rendered
+void rlUnloadCaptureBatch(void)
+{
+    // Empty the draw list so restoring the default batch (which flushes the
+    // capture batch) does not render the recorded shapes to the screen
+    for (int i = 0; i < captureBatch.drawCounter; i++)
+    {
+        captureBatch.draws[i].vertexCount = 0;
+        captureBatch.draws[i].vertexAlignment = 0;
+    }
+
+    rlSetRenderBatchActive(NULL);
+    rlUnloadRenderBatch(captureBatch);
+    captureBatch = (rlRenderBatch) { 0 };
+}
+
+// Stop recording and upload the recorded vertices into a static mesh
+// NOTE: Returns an empty mesh (nothing drawn) if the capture batch was flushed while recording
+rlCapturedMesh rlEndCapture(void)
+{
+    rlCapturedMesh mesh = { 0 };
+
+    // Flushed vertices were drawn to the screen instead of recorded, the mesh would miss them
+    if (captureBatch.flushes > 0)
+    {
+        TraceLog(LOG_WARNING, "RLGL: Capture overflowed its batch (%i elements, %i flushes), increase RL_CAPTURE_BUFFER_ELEMENTS", RL_CAPTURE_BUFFER_ELEMENTS, captureBatch.flushes);
+        rlUnloadCaptureBatch();
+        return mesh;
+    }
+
+    rlVertexBuffer* buffer = &captureBatch.vertexBuffer[captureBatch.currentBuffer];
+
+    // Count output vertices, quads are expanded into two triangles
+    for (int i = 0; i < captureBatch.drawCounter; i++)
+    {
+        rlDrawCall draw = captureBatch.draws[i];
+        mesh.vertexCount += (draw.mode == RL_QUADS) ? draw.vertexCount / 4 * 6 : draw.vertexCount;
+    }
+
+    float* vertices = (float*)RL_MALLOC(mesh.vertexCount * 3 * sizeof(float));
+    float* texcoords = (float*)RL_MALLOC(mesh.vertexCount * 2 * sizeof(float));
+    unsigned char* colors = (unsigned char*)RL_MALLOC(mesh.vertexCount * 4 * sizeof(unsigned char));
+    mesh.draws = (rlCapturedDraw*)RL_CALLOC(captureBatch.drawCounter, sizeof(rlCapturedDraw));
+
+    int srcOffset = 0;
+    int dstOffset = 0;
+    for (int i = 0; i < captureBatch.drawCounter; i++)
+    {
+        rlDrawCall draw = captureBatch.draws[i];
+        int mode = (draw.mode == RL_LINES) ? RL_LINES : RL_TRIANGLES;
+        int start = dstOffset;
+
+        for (int v = 0; v < draw.vertexCount; v++)
+        {
+            // Same index pattern used by rlgl for quads: 0, 1, 2, 0, 2, 3
+            int corners[6] = { 0, 1, 2, 0, 2, 3 };
+            int count = 1;
+            if (draw.mode == RL_QUADS)
+            {
+                if ((v % 4) != 0)
+                    continue;
+                count = 6;
+            }
+
+            for (int c = 0; c < count; c++)
+            {
+                int src = srcOffset + v + ((draw.mode == RL_QUADS) ? corners[c] : 0);
+                memcpy(&vertices[dstOffset * 3], &buffer->vertices[src * 3], 3 * sizeof(float));
+                memcpy(&texcoords[dstOffset * 2], &buffer->texcoords[src * 2], 2 * sizeof(float));
+                memcpy(&colors[dstOffset * 4], &buffer->colors[src * 4], 4 * sizeof(unsigned char));
+                dstOffset++;
+            }
+        }
+
+        srcOffset += (draw.vertexCount + draw.vertexAlignment);
+
+        if (dstOffset == start)
+            continue;
+
+        // Merge consecutive draws that share mode and texture
+        rlCapturedDraw* last = (mesh.drawCount > 0) ? &mesh.draws[mesh.drawCount - 1] : NULL;
+        if ((last != NULL) && (last->mode == mode) && (last->textureId == draw.textureId))
+        {
+            last->vertexCount += (dstOffset - start);
+        }
+        else
+        {
+            mesh.draws[mesh.drawCount] = (rlCapturedDraw) { mode, start, dstOffset - start, draw.textureId };
+            mesh.drawCount++;
+        }
+    }
+
+    // Upload recorded vertex data into static buffers
+    mesh.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(mesh.vaoId);
+
+    mesh.vboId[0] = rlLoadVertexBuffer(vertices, mesh.vertexCount * 3 * sizeof(float), false);
+    rlSetVertexAttribute(RL_CAPTURE_ATTRIB_POSITION, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_CAPTURE_ATTRIB_POSITION);
+
+    mesh.vboId[1] = rlLoadVertexBuffer(texcoords, mesh.vertexCount * 2 * sizeof(float), false);
+    rlSetVertexAttribute(RL_CAPTURE_ATTRIB_TEXCOORD, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_CAPTURE_ATTRIB_TEXCOORD);
+
+    mesh.vboId[2] = rlLoadVertexBuffer(colors, mesh.vertexCount * 4 * sizeof(unsigned char), false);
+    rlSetVertexAttribute(RL_CAPTURE_ATTRIB_COLOR, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+    rlEnableVertexAttribute(RL_CAPTURE_ATTRIB_COLOR);
+
+    rlDisableVertexArray();
+
+    RL_FREE(vertices);
+    RL_FREE(texcoords);
+    RL_FREE(colors);
+
+    rlUnloadCaptureBatch();
+
+    return mesh;
+}
+
+// Draw a captured mesh instanced, per-instance data is provided by the shader
+void rlDrawCapturedMeshInstanced(rlCapturedMesh mesh, Shader shader, int instances)
+{
+    // Keep order with anything already recorded into the active batch
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(shader.id);
+
+    // Same matrices raylib uses in DrawMesh()
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix matMVP = MatrixMultiply(matModelView, rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlEnableVertexArray(mesh.vaoId);
+    rlActiveTextureSlot(0);
+
+    for (int i = 0; i < mesh.drawCount; i++)
+    {
+        rlEnableTexture(mesh.draws[i].textureId);
+        glDrawArraysInstanced(mesh.draws[i].mode, mesh.draws[i].vertexOffset, mesh.draws[i].vertexCount, instances);
+    }
+
+    rlDisableTexture();
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+// Unload captured mesh from GPU and CPU memory
+void rlUnloadCapturedMesh(rlCapturedMesh mesh)
+{
+    for (int i = 0; i < 3; i++)
+        rlUnloadVertexBuffer(mesh.vboId[i]);
+    rlUnloadVertexArray(mesh.vaoId);
+
+    RL_FREE(mesh.draws);
+}
+
+#endif // RLGL_CAPTURE_H
@@ -0,0 +1,409 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "hash_fnv.h"
+
+// Required for: strstr(), strlen(), memcpy()
+#include <string.h>
+// Required for: snprintf()
+#include <stdio.h>
+
+// Maximum variants loaded from a set
+#ifndef SHADER_VARIANT_MAX
+#define SHADER_VARIANT_MAX 32
+#endif
+
+// Cache file identification
+#define SHADER_VARIANT_CACHE_MAGIC 0x52444853 // "SHDR"
+#define SHADER_VARIANT_CACHE_VERSION 1
+
+// Default vertex attribute locations used by rlgl (see rlLoadShaderProgram())
+#define SHADER_VARIANT_ATTRIB_COUNT 6
+
+// Shader features, each one adds a #define to the composed sources
+typedef enum {
+    SHADER_FEATURE_INSTANCE_MATRIX = 1 << 0,    // Instance model matrix, else a 2D position offset
+    SHADER_FEATURE_INSTANCE_COLOR = 1 << 1,     // Instance color
+    SHADER_FEATURE_INSTANCE_RECORDS = 1 << 2,   // Instances fetched from a buffer texture of records
+    SHADER_FEATURE_VERTEX_PULLING = 1 << 3,     // Vertices and instances fetched from pools
+    SHADER_FEATURE_DEPTH_ONLY = 1 << 4,         // Position only, nothing but depth is written
+    SHADER_FEATURE_SHADOW_CASCADES = 1 << 5,    // Fragments shadowed by cascaded shadow maps
+    SHADER_FEATURE_MULTI_VIEW = 1 << 6,         // Each instance drawn once per view, into the view region
+    SHADER_FEATURE_QUANTIZED_VERTICES = 1 << 7, // Quantized vertex attributes decoded by the shader
+} ShaderFeature;
+
+#define SHADER_FEATURE_COUNT 8
+
+// Define added for each feature bit
+static const char* shaderFeatureDefines[SHADER_FEATURE_COUNT] = {
+    "INSTANCE_MATRIX",
+    "INSTANCE_COLOR",
+    "INSTANCE_RECORDS",
+    "VERTEX_PULLING",
+    "DEPTH_ONLY",
+    "SHADOW_CASCADES",
+    "MULTI_VIEW",
+    "QUANTIZED_VERTICES",
+};
+
+// Shader variant, a program composed from the set sources and feature flags
+typedef struct ShaderVariant {
+    unsigned int features;  // ShaderFeature flags
+    Shader shader;
+} ShaderVariant;
+
+// Shader variant stats, totals since load
+typedef struct ShaderVariantStats {
+    int compiled;           // Variants compiled from source
+    int cached;             // Variants loaded from a program binary
+    int rejected;           // Program binaries out of date or refused by the driver
+    double loadTime;        // Time spent loading variants (seconds)
+} ShaderVariantStats;
+
+// Base shader sources and the variants loaded from them
+// NOTE: Linked programs are stored as "<cachePrefix>_<features>.cache" program binaries,
+// a binary is only used if both the driver and the composed sources hash match
+typedef struct ShaderVariantSet {
+    char* vsText;           // Base sources, includes expanded
+    char* fsText;
+    const char* cachePrefix; // Program binaries file prefix (NULL disables the cache)
+    unsigned int driverKey; // Hash of vendor, renderer and version strings
+    int binaryFormats;      // Program binary formats supported by the driver (0 disables the cache)
+
+    ShaderVariant variants[SHADER_VARIANT_MAX];
+    int variantCount;
+
+    ShaderVariantStats stats;
+} ShaderVariantSet;
+
+// Cache file header, followed by the program binary
+typedef struct ShaderVariantCacheHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int driverKey;
+    unsigned int sourceKey;
+    unsigned int format;    // Program binary format
+    int length;             // Program binary length
+} ShaderVariantCacheHeader;
+
+// Load shader text replacing '#include "file"' lines with the file from the same directory
+char* LoadShaderVariantText(const char* fileName)
+{
+    char* text = LoadFileText(fileName);
+    if (text == NULL)
+        return NULL;
+
+    const char* directive = "#include \"";
+    char* include = strstr(text, directive);
+    while (include != NULL)
+    {
+        char* nameStart = include + strlen(directive);
+        char* nameEnd = strchr(nameStart, '"');
+        if (nameEnd == NULL)
+            break;
+
+        char includeName[256] = { 0 };
+        snprintf(includeName, sizeof(includeName), "%s/%.*s", GetDirectoryPath(fileName), (int)(nameEnd - nameStart), nameStart);
+        char* includeText = LoadFileText(includeName);
+        if (includeText == NULL)
+        {
+            TraceLog(LOG_WARNING, "SHADER: [%s] Include file %s not found", fileName, includeName);
+            break;
+        }
+
+        int headLength = include - text;
+        int includeLength = strlen(includeText);
+        const char* tail = nameEnd + 1;
+
+        char* expanded = (char*)RL_MALLOC(headLength + includeLength + strlen(tail) + 1);
+        memcpy(expanded, text, headLength);
+        memcpy(expanded + headLength, includeText, includeLength);
+        strcpy(expanded + headLength + includeLength, tail);
+
+        UnloadFileText(includeText);
+        UnloadFileText(text);
+        text = expanded;
+
+        // Continue after the pasted text, included files are not expanded again
+        include = strstr(text + headLength + includeLength, directive);
+    }
+
+    return text;
+}
+
+// Load base shader sources, variants are compiled on first use
+ShaderVariantSet LoadShaderVariantSet(const char* vsFileName, const char* fsFileName, const char* cachePrefix)
+{
+    ShaderVariantSet set = { 0 };
+    set.vsText = LoadShaderVariantText(vsFileName);
+    set.fsText = LoadShaderVariantText(fsFileName);
+    set.cachePrefix = cachePrefix;
+
+    // Binaries are only valid for the driver that produced them
+    unsigned int key = HASH_FNV_BASIS;
+    GLenum driverStrings[4] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+    for (int i = 0; i < 4; i++)
+    {
+        const char* value = (const char*)glGetString(driverStrings[i]);
+        if (value != NULL)
+            key = HashFNV(key, value, strlen(value));
+    }
+    set.driverKey = key;
+
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &set.binaryFormats);
+    if ((cachePrefix != NULL) && (set.binaryFormats == 0))
+        TraceLog(LOG_INFO, "SHADER: Driver exposes no program binary formats, variants are compiled from source");
+
+    return set;
+}
+
+// Unload shader variants and base sources
+void UnloadShaderVariantSet(ShaderVariantSet* set)
+{
+    for (int i = 0; i < set->variantCount; i++)
+        UnloadShader(set->variants[i].shader);
+
+    set->variantCount = 0;
+
+    UnloadFileText(set->vsText);
+    UnloadFileText(set->fsText);
+}
+
+// Compose variant source, feature defines are added after the #version line
+char* ComposeShaderVariant(const char* text, unsigned int features)
+{
+    const char* body = strchr(text, '\n');
+    body = (body != NULL) ? body + 1 : text;
+    int versionLength = body - text;
+
+    int length = versionLength + strlen(body) + 1;
+    for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if (features & (1u << i))
+            length += strlen("#define \n") + strlen(shaderFeatureDefines[i]);
+    }
+
+    char* code = (char*)RL_MALLOC(length);
+    memcpy(code, text, versionLength);
+    int offset = versionLength;
+    for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if (features & (1u << i))
+            offset += sprintf(code + offset, "#define %s\n", shaderFeatureDefines[i]);
+    }
+    strcpy(code + offset, body);
+
+    return code;
+}
+
+// Set shader locations the same way raylib does for loaded shaders
+void SetShaderVariantLocations(Shader* shader)
+{
+    shader->locs = (int*)RL_MALLOC(RL_MAX_SHADER_LOCATIONS * sizeof(int));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++)
+        shader->locs[i] = -1;
+
+    shader->locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader->id, "vertexPosition");
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(shader->id, "vertexTexCoord");
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib(shader->id, "vertexTexCoord2");
+    shader->locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(shader->id, "vertexNormal");
+    shader->locs[SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib(shader->id, "vertexTangent");
+    shader->locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(shader->id, "vertexColor");
+
+    shader->locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(shader->id, "mvp");
+    shader->locs[SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform(shader->id, "matView");
+    shader->locs[SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform(shader->id, "matProjection");
+    shader->locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(shader->id, "matModel");
+    shader->locs[SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform(shader->id, "matNormal");
+    shader->locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader->id, "colDiffuse");
+    shader->locs[SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform(shader->id, "texture0");
+    shader->locs[SHADER_LOC_MAP_SPECULAR] = rlGetLocationUniform(shader->id, "texture1");
+    shader->locs[SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform(shader->id, "texture2");
+}
+
+// Compile and link variant program, kept retrievable as a binary
+unsigned int CompileShaderVariant(const char* vsCode, const char* fsCode)
+{
+    unsigned int vertexShader = rlCompileShader(vsCode, RL_VERTEX_SHADER);
+    unsigned int fragmentShader = rlCompileShader(fsCode, RL_FRAGMENT_SHADER);
+    if ((vertexShader == 0) || (fragmentShader == 0))
+    {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+
+    // Same attribute locations as rlgl programs, so meshes and batches can be drawn with variants
+    const char* attribNames[SHADER_VARIANT_ATTRIB_COUNT] = {
+        "vertexPosition", "vertexTexCoord", "vertexNormal", "vertexColor", "vertexTangent", "vertexTexCoord2"
+    };
+    for (int i = 0; i < SHADER_VARIANT_ATTRIB_COUNT; i++)
+        glBindAttribLocation(program, i, attribNames[i]);
+
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE)
+    {
+        char log[1024] = { 0 };
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        TraceLog(LOG_WARNING, "SHADER: [ID %i] Failed to link variant program: %s", program, log);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+// Load program binary from cache file, returns 0 if missing, out of date or refused by the driver
+unsigned int LoadShaderVariantBinary(ShaderVariantSet* set, const char* fileName, unsigned int sourceKey)
+{
+    if (!FileExists(fileName))
+        return 0;
+
+    unsigned int dataSize = 0;
+    unsigned char* data = LoadFileData(fileName, &dataSize);
+
+    ShaderVariantCacheHeader header = { 0 };
+    if ((data != NULL) && (dataSize >= sizeof(header)))
+        memcpy(&header, data, sizeof(header));
+
+    unsigned int program = 0;
+    if ((header.magic == SHADER_VARIANT_CACHE_MAGIC) && (header.version == SHADER_VARIANT_CACHE_VERSION)
+        && (header.driverKey == set->driverKey) && (header.sourceKey == sourceKey)
+        && (dataSize == sizeof(header) + header.length))
+    {
+        // Driver can still refuse a binary (driver update with the same strings), checked by link status
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, data + sizeof(header), header.length);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE)
+        {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    UnloadFileData(data);
+
+    if (program == 0)
+    {
+        set->stats.rejected++;
+        TraceLog(LOG_INFO, "SHADER: Program binary %s is out of date, compiling variant again", fileName);
+    }
+
+    return program;
+}
+
+// Store linked program binary in cache file
+void SaveShaderVariantBinary(ShaderVariantSet* set, unsigned int program, const char* fileName, unsigned int sourceKey)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    unsigned char* data = (unsigned char*)RL_MALLOC(sizeof(ShaderVariantCacheHeader) + length);
+
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, data + sizeof(ShaderVariantCacheHeader));
+
+    ShaderVariantCacheHeader header = { SHADER_VARIANT_CACHE_MAGIC, SHADER_VARIANT_CACHE_VERSION, set->driverKey, sourceKey, format, written };
+    memcpy(data, &header, sizeof(header));
+
+    if (written > 0)
+        SaveFileData(fileName, data, sizeof(header) + written);
+
+    RL_FREE(data);
+}
+
+// Get shader variant for feature flags, composed and loaded on first use
+Shader GetShaderVariant(ShaderVariantSet* set, unsigned int features)
+{
+    for (int i = 0; i < set->variantCount; i++)
+    {
+        if (set->variants[i].features == features)
+            return set->variants[i].shader;
+    }
+
+    Shader shader = { 0 };
+    if ((set->vsText == NULL) || (set->fsText == NULL) || (set->variantCount == SHADER_VARIANT_MAX))
+    {
+        TraceLog(LOG_WARNING, "SHADER: Failed to load variant 0x%02x", features);
+        shader.id = rlGetShaderIdDefault();
+        shader.locs = rlGetShaderLocsDefault();
+        return shader;
+    }
+
+    double loadStart = GetTime();
+
+    char* vsCode = ComposeShaderVariant(set->vsText, features);
+    char* fsCode = ComposeShaderVariant(set->fsText, features);
+
+    unsigned int sourceKey = HASH_FNV_BASIS;
+    sourceKey = HashFNV(sourceKey, vsCode, strlen(vsCode));
+    sourceKey = HashFNV(sourceKey, fsCode, strlen(fsCode));
+
+    bool useCache = (set->cachePrefix != NULL) && (set->binaryFormats > 0);
+    const char* fileName = TextFormat("%s_%02x.cache", set->cachePrefix, features);
+
+    bool cached = false;
+    if (useCache)
+    {
+        shader.id = LoadShaderVariantBinary(set, fileName, sourceKey);
+        cached = (shader.id > 0);
+    }
+
+    if (shader.id == 0)
+    {
+        shader.id = CompileShaderVariant(vsCode, fsCode);
+        if (useCache && (shader.id > 0))
+            SaveShaderVariantBinary(set, shader.id, fileName, sourceKey);
+    }
+
+    RL_FREE(vsCode);
+    RL_FREE(fsCode);
+
+    if (shader.id == 0)
+    {
+        TraceLog(LOG_WARNING, "SHADER: Failed to load variant 0x%02x, default shader used", features);
+        shader.id = rlGetShaderIdDefault();
+        shader.locs = rlGetShaderLocsDefault();
+        return shader;
+    }
+
+    SetShaderVariantLocations(&shader);
+
+    double loadTime = GetTime() - loadStart;
+    set->stats.loadTime += loadTime;
+    if (cached)
+        set->stats.cached++;
+    else
+        set->stats.compiled++;
+
+    TraceLog(LOG_INFO, "SHADER: [ID %i] Variant 0x%02x %s (%.2f ms)", shader.id, features, cached ? "loaded from program binary" : "compiled", loadTime * 1000.0);
+
+    set->variants[set->variantCount] = (ShaderVariant) { features, shader };
+    set->variantCount++;
+
+    return shader;
+}
+
+#endif // SHADER_VARIANTS_H
@@ -0,0 +1,179 @@
+#ifndef SHAPES_SDF_H
+#define SHAPES_SDF_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// Required for: offsetof()
+#include <stddef.h>
+
+// Shape types, evaluated analytically in the fragment shader
+typedef enum SdfShapeType {
+    SDF_CIRCLE = 0,     // geometry: center.xy, radius
+    SDF_RING,           // geometry: center.xy, radius, thickness
+    SDF_RECTANGLE,      // geometry: x, y, width, height - params: corner radius, outline thickness (0 = filled)
+    SDF_LINE            // geometry: start.xy, end.xy - params: thickness, cap
+} SdfShapeType;
+
+// Line caps
+typedef enum SdfLineCap {
+    SDF_CAP_BUTT = 0,
+    SDF_CAP_ROUND,
+    SDF_CAP_SQUARE
+} SdfLineCap;
+
+// Shape instance record, one quad per shape
+typedef struct SdfShape {
+    Vector4 geometry;   // Shape placement, depends on type
+    Vector2 params;     // Shape parameters, depends on type
+    Color color;        // Shape color
+    float type;         // SdfShapeType
+} SdfShape;
+
+// Instanced SDF shapes renderer, all queued shapes are drawn with one instanced draw
+typedef struct SdfShapeRenderer {
+    Shader shader;              // Shapes shader
+    SdfShape* shapes;           // Shapes queued for current draw
+    int shapeCount;             // Number of queued shapes
+    int maxShapes;              // Instance buffer capacity
+
+    unsigned int vaoId;         // Vertex array (unit quad + shape instances)
+    unsigned int quadVboId;     // Unit quad vertex buffer
+    unsigned int instanceVboId; // Shape instances buffer
+} SdfShapeRenderer;
+
+// Load SDF shapes renderer
+SdfShapeRenderer LoadSdfShapeRenderer(int maxShapes)
+{
+    SdfShapeRenderer renderer = { 0 };
+    renderer.shader = LoadShader("resources/shaders/shapes_sdf.vs", "resources/shaders/shapes_sdf.fs");
+    renderer.maxShapes = maxShapes;
+    renderer.shapes = (SdfShape*)RL_CALLOC(maxShapes, sizeof(SdfShape));
+
+    // Unit quad corners in [-1, 1], drawn as a 4 vertex triangle strip
+    float quad[8] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+    renderer.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(renderer.vaoId);
+
+    renderer.quadVboId = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    int cornerAttrib = rlGetLocationAttrib(renderer.shader.id, "vertexPosition");
+    rlSetVertexAttribute(cornerAttrib, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(cornerAttrib);
+
+    renderer.instanceVboId = rlLoadVertexBuffer(NULL, maxShapes * sizeof(SdfShape), true);
+
+    // shape geometry (4 x GL_FLOAT)
+    int geometryAttrib = rlGetLocationAttrib(renderer.shader.id, "shapeGeometry");
+    rlEnableVertexAttribute(geometryAttrib);
+    rlSetVertexAttribute(geometryAttrib, 4, RL_FLOAT, false, sizeof(SdfShape), (void*)0);
+    rlSetVertexAttributeDivisor(geometryAttrib, 1);
+
+    // shape params (2 x GL_FLOAT)
+    int paramsAttrib = rlGetLocationAttrib(renderer.shader.id, "shapeParams");
+    rlEnableVertexAttribute(paramsAttrib);
+    rlSetVertexAttribute(paramsAttrib, 2, RL_FLOAT, false, sizeof(SdfShape), (void*)offsetof(SdfShape, params));
+    rlSetVertexAttributeDivisor(paramsAttrib, 1);
+
+    // shape color (4 x GL_UNSIGNED_BYTE)
+    int colorAttrib = rlGetLocationAttrib(renderer.shader.id, "shapeColor");
+    rlEnableVertexAttribute(colorAttrib);
+    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(SdfShape), (void*)offsetof(SdfShape, color));
+    rlSetVertexAttributeDivisor(colorAttrib, 1);
+
+    // shape type (1 x GL_FLOAT)
+    int typeAttrib = rlGetLocationAttrib(renderer.shader.id, "shapeType");
+    rlEnableVertexAttribute(typeAttrib);
+    rlSetVertexAttribute(typeAttrib, 1, RL_FLOAT, false, sizeof(SdfShape), (void*)offsetof(SdfShape, type));
+    rlSetVertexAttributeDivisor(typeAttrib, 1);
+
+    rlDisableVertexArray();
+
+    return renderer;
+}
+
+// Unload SDF shapes renderer
+void UnloadSdfShapeRenderer(SdfShapeRenderer* renderer)
+{
+    RL_FREE(renderer->shapes);
+
+    rlUnloadVertexBuffer(renderer->quadVboId);
+    rlUnloadVertexBuffer(renderer->instanceVboId);
+    rlUnloadVertexArray(renderer->vaoId);
+    UnloadShader(renderer->shader);
+}
+
+// Start queuing shapes for an instanced draw
+void BeginSdfShapes(SdfShapeRenderer* renderer)
+{
+    renderer->shapeCount = 0;
+}
+
+// Queue a shape, ignored once the instance buffer is full
+void DrawSdfShape(SdfShapeRenderer* renderer, int type, Vector4 geometry, Vector2 params, Color color)
+{
+    if (renderer->shapeCount >= renderer->maxShapes)
+        return;
+
+    renderer->shapes[renderer->shapeCount++] = (SdfShape) { geometry, params, color, (float)type };
+}
+
+// Draw a color-filled circle
+void DrawCircleSdf(SdfShapeRenderer* renderer, Vector2 center, float radius, Color color)
+{
+    DrawSdfShape(renderer, SDF_CIRCLE, (Vector4) { center.x, center.y, radius, 0.0f }, Vector2Zero(), color);
+}
+
+// Draw circle outline centered on radius
+void DrawRingSdf(SdfShapeRenderer* renderer, Vector2 center, float radius, float thickness, Color color)
+{
+    DrawSdfShape(renderer, SDF_RING, (Vector4) { center.x, center.y, radius, thickness }, Vector2Zero(), color);
+}
+
+// Draw rectangle with rounded corners, lineThick 0 fills it, otherwise outline grows inwards
+void DrawRectangleSdf(SdfShapeRenderer* renderer, Rectangle rec, float cornerRadius, float lineThick, Color color)
+{
+    DrawSdfShape(renderer, SDF_RECTANGLE, (Vector4) { rec.x, rec.y, rec.width, rec.height }, (Vector2) { cornerRadius, lineThick }, color);
+}
+
+// Draw a line segment of any thickness with caps
+void DrawLineSdf(SdfShapeRenderer* renderer, Vector2 startPos, Vector2 endPos, float thick, int cap, Color color)
+{
+    DrawSdfShape(renderer, SDF_LINE, (Vector4) { startPos.x, startPos.y, endPos.x, endPos.y }, (Vector2) { thick, (float)cap }, color);
+}
+
+// Upload queued shapes and draw them with one instanced draw
+void EndSdfShapes(SdfShapeRenderer* renderer)
+{
+    if (renderer->shapeCount == 0)
+        return;
+
+    // Flush pending batched draws first
+    rlDrawRenderBatchActive();
+
+    rlUpdateVertexBuffer(renderer->instanceVboId, renderer->shapes, renderer->shapeCount * sizeof(SdfShape), 0);
+
+    rlEnableShader(renderer->shader.id);
+
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix matMVP = MatrixMultiply(matModelView, rlGetMatrixProjection());
+    rlSetUniformMatrix(renderer->shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    // Quads are grown by about one pixel so anti-aliased edges are not clipped
+    float zoom = sqrtf(matModelView.m0 * matModelView.m0 + matModelView.m1 * matModelView.m1);
+    float aaMargin = 1.5f / ((zoom > 0.0f) ? zoom : 1.0f);
+    rlSetUniform(rlGetLocationUniform(renderer->shader.id, "aaMargin"), &aaMargin, SHADER_UNIFORM_FLOAT, 1);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(renderer->shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlEnableVertexArray(renderer->vaoId);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, renderer->shapeCount);
+    rlDisableVertexArray();
+
+    rlDisableShader();
+}
+
+#endif // SHAPES_SDF_H
@@ -0,0 +1,352 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "worker_pool.h"
+
+// Required for: memset()
+#include <string.h>
+
+// Contacts resolved per body and frame, bounds collision cost in crowded cells
+#ifndef GRID_MAX_CONTACTS
+#define GRID_MAX_CONTACTS 8
+#endif
+
+// Work done by every thread on its range
+typedef enum SpatialGridPhase {
+    GRID_PHASE_COUNT,       // Find cell of each body, count bodies per cell
+    GRID_PHASE_SCATTER,     // Move bodies to their cell range
+    GRID_PHASE_GATHER,      // Copy body speeds to sorted order
+    GRID_PHASE_COLLIDE,     // Resolve contacts of each body with its neighbor cells
+    GRID_PHASE_APPLY,       // Write resolved positions and speeds back to the bodies
+} SpatialGridPhase;
+
+// Grid timings of the last frame (seconds)
+typedef struct SpatialGridStats {
+    double buildTime;
+    double collideTime;
+    int contacts;           // Contacts resolved by last collision
+    int maxCellCount;       // Bodies in the most crowded cell
+} SpatialGridStats;
+
+// Uniform grid spatial hash of 2D bodies, rebuilt every frame
+// NOTE: Bodies are sorted by cell with a counting sort, every thread counts and scatters its own
+// range of bodies, so each cell is one contiguous range of the sorted bodies (cellStart[cell] to
+// cellStart[cell + 1]). Bodies are found by testing the 3x3 cells around a position
+typedef struct SpatialGrid {
+    WorkerPool* pool;                       // Grid threads, main thread included
+    int contacts[WORKER_POOL_MAX_THREADS];  // Contacts resolved by each thread
+
+    float cellSize;
+    Vector2 origin;                         // Position of the first cell corner
+    int columns;
+    int rows;
+    int cellCount;
+    int cellCapacity;
+
+    // Current phase
+    SpatialGridPhase phase;
+    unsigned char* bodies;                  // Body positions (and speeds) every stride bytes
+    int stride;
+    int speedOffset;                        // Body speed offset, collision only
+    float radius;
+    float restitution;
+
+    int count;                              // Bodies of last build
+    int capacity;
+    unsigned int* cells;                    // Cell of each body
+    unsigned int* cellStart;                // Sorted bodies range of each cell (cellCount + 1)
+    unsigned int* counts;                   // Bodies per cell of each thread, then scatter offsets
+    unsigned int* items;                    // Body index of each sorted body
+    Vector2* positions;                     // Position of each sorted body
+    Vector2* speeds;                        // Speed of each sorted body, collision only
+    Vector2* resolvedPositions;             // Collision output of each sorted body
+    Vector2* resolvedSpeeds;
+
+    SpatialGridStats stats;
+} SpatialGrid;
+
+// Get cell coordinates of a position, positions outside the grid are clamped to the border cells
+void GetSpatialGridCoords(const SpatialGrid* grid, Vector2 position, int* column, int* row)
+{
+    int x = (int)floorf((position.x - grid->origin.x) / grid->cellSize);
+    int y = (int)floorf((position.y - grid->origin.y) / grid->cellSize);
+    *column = (x < 0) ? 0 : (x >= grid->columns) ? grid->columns - 1 : x;
+    *row = (y < 0) ? 0 : (y >= grid->rows) ? grid->rows - 1 : y;
+}
+
+// Resolve contacts of a sorted body with the bodies of its 3x3 neighbor cells
+// NOTE: Only the body itself is written (to the resolved arrays), each contact is resolved
+// by both bodies on their own, so no two threads write the same body
+int CollideSpatialGridBody(SpatialGrid* grid, int slot)
+{
+    Vector2 position = grid->positions[slot];
+    Vector2 speed = grid->speeds[slot];
+    Vector2 push = { 0.0f, 0.0f };
+    Vector2 impulse = { 0.0f, 0.0f };
+
+    float diameter = grid->radius * 2.0f;
+    int contacts = 0;
+
+    int column = 0;
+    int row = 0;
+    GetSpatialGridCoords(grid, position, &column, &row);
+
+    // Own cell first, it holds most contacts of crowded bodies
+    static const int neighbors[9][2] = { { 0, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+
+    for (int n = 0; (n < 9) && (contacts < GRID_MAX_CONTACTS); n++)
+    {
+        int x = column + neighbors[n][0];
+        int y = row + neighbors[n][1];
+        if ((x < 0) || (x >= grid->columns) || (y < 0) || (y >= grid->rows))
+            continue;
+
+        int cell = y * grid->columns + x;
+        for (unsigned int other = grid->cellStart[cell]; (other < grid->cellStart[cell + 1]) && (contacts < GRID_MAX_CONTACTS); other++)
+        {
+            Vector2 delta = Vector2Subtract(position, grid->positions[other]);
+            float distanceSqr = delta.x * delta.x + delta.y * delta.y;
+            if ((other == (unsigned int)slot) || (distanceSqr >= diameter * diameter) || (distanceSqr == 0.0f))
+                continue;
+
+            float distance = sqrtf(distanceSqr);
+            Vector2 normal = Vector2Scale(delta, 1.0f / distance);
+
+            // Each body moves half the overlap away from the other
+            push = Vector2Add(push, Vector2Scale(normal, (diameter - distance) * 0.5f));
+
+            // Equal mass bodies exchange their approaching normal speed
+            float approach = Vector2DotProduct(Vector2Subtract(speed, grid->speeds[other]), normal);
+            if (approach < 0.0f)
+                impulse = Vector2Add(impulse, Vector2Scale(normal, -approach * (1.0f + grid->restitution) * 0.5f));
+
+            contacts++;
+        }
+    }
+
+    grid->resolvedPositions[slot] = Vector2Add(position, push);
+    grid->resolvedSpeeds[slot] = Vector2Add(speed, impulse);
+
+    return contacts;
+}
+
+// Run current phase on the range assigned to a thread
+void RunSpatialGridRange(void* data, int index)
+{
+    SpatialGrid* grid = (SpatialGrid*)data;
+
+    int first = 0;
+    int last = 0;
+    GetWorkerRange(grid->pool, grid->count, index, &first, &last);
+
+    if (grid->phase == GRID_PHASE_COUNT)
+    {
+        unsigned int* counts = grid->counts + (size_t)index * grid->cellCount;
+        memset(counts, 0, grid->cellCount * sizeof(unsigned int));
+
+        for (int i = first; i < last; i++)
+        {
+            int column = 0;
+            int row = 0;
+            GetSpatialGridCoords(grid, *(Vector2*)(grid->bodies + (size_t)i * grid->stride), &column, &row);
+
+            unsigned int cell = row * grid->columns + column;
+            grid->cells[i] = cell;
+            counts[cell]++;
+        }
+    }
+    else if (grid->phase == GRID_PHASE_SCATTER)
+    {
+        unsigned int* offsets = grid->counts + (size_t)index * grid->cellCount;
+        for (int i = first; i < last; i++)
+        {
+            unsigned int slot = offsets[grid->cells[i]]++;
+            grid->items[slot] = i;
+            grid->positions[slot] = *(Vector2*)(grid->bodies + (size_t)i * grid->stride);
+        }
+    }
+    else if (grid->phase == GRID_PHASE_GATHER)
+    {
+        for (int slot = first; slot < last; slot++)
+            grid->speeds[slot] = *(Vector2*)(grid->bodies + (size_t)grid->items[slot] * grid->stride + grid->speedOffset);
+    }
+    else if (grid->phase == GRID_PHASE_COLLIDE)
+    {
+        // Sorted bodies are split evenly, crowded cells do not leave threads idle
+        int contacts = 0;
+        for (int slot = first; slot < last; slot++)
+            contacts += CollideSpatialGridBody(grid, slot);
+
+        grid->contacts[index] = contacts;
+    }
+    else
+    {
+        for (int slot = first; slot < last; slot++)
+        {
+            unsigned char* body = grid->bodies + (size_t)grid->items[slot] * grid->stride;
+            *(Vector2*)body = grid->resolvedPositions[slot];
+            *(Vector2*)(body + grid->speedOffset) = grid->resolvedSpeeds[slot];
+        }
+    }
+}
+
+// Run a phase on every thread, returns when all ranges are done
+void RunSpatialGridPhase(SpatialGrid* grid, SpatialGridPhase phase)
+{
+    grid->phase = phase;
+    RunWorkerPool(grid->pool, RunSpatialGridRange, grid);
+}
+
+// Load spatial grid of cellSize cells, threadCount <= 0 uses every core
+// NOTE: Bodies collide with the 3x3 cells around them, cellSize must be at least the body diameter
+SpatialGrid* LoadSpatialGrid(float cellSize, int threadCount)
+{
+    SpatialGrid* grid = (SpatialGrid*)RL_CALLOC(1, sizeof(SpatialGrid));
+    grid->pool = LoadWorkerPool(threadCount);
+    grid->cellSize = cellSize;
+
+    TraceLog(LOG_INFO, "GRID: Spatial grid loaded (cell size: %.1f, %i threads)", cellSize, grid->pool->threadCount);
+
+    return grid;
+}
+
+// Stop grid threads and unload spatial grid
+void UnloadSpatialGrid(SpatialGrid* grid)
+{
+    UnloadWorkerPool(grid->pool);
+
+    RL_FREE(grid->cells);
+    RL_FREE(grid->cellStart);
+    RL_FREE(grid->counts);
+    RL_FREE(grid->items);
+    RL_FREE(grid->positions);
+    RL_FREE(grid->speeds);
+    RL_FREE(grid->resolvedPositions);
+    RL_FREE(grid->resolvedSpeeds);
+    RL_FREE(grid);
+}
+
+// Build grid over bounds from body positions (Vector2 at the start of each body, every stride bytes)
+void BuildSpatialGrid(SpatialGrid* grid, void* bodies, int count, int stride, Rectangle bounds)
+{
+    double start = GetWorkerTime();
+
+    grid->origin = (Vector2) { bounds.x, bounds.y };
+    grid->columns = (int)ceilf(bounds.width / grid->cellSize);
+    grid->rows = (int)ceilf(bounds.height / grid->cellSize);
+    if (grid->columns < 1)
+        grid->columns = 1;
+    if (grid->rows < 1)
+        grid->rows = 1;
+    grid->cellCount = grid->columns * grid->rows;
+
+    if (grid->cellCount > grid->cellCapacity)
+    {
+        grid->cellCapacity = grid->cellCount;
+        grid->cellStart = (unsigned int*)RL_REALLOC(grid->cellStart, (grid->cellCapacity + 1) * sizeof(unsigned int));
+        grid->counts = (unsigned int*)RL_REALLOC(grid->counts, (size_t)grid->pool->threadCount * grid->cellCapacity * sizeof(unsigned int));
+    }
+
+    if (count > grid->capacity)
+    {
+        grid->capacity = (count > grid->capacity * 2) ? count : grid->capacity * 2;
+        grid->cells = (unsigned int*)RL_REALLOC(grid->cells, grid->capacity * sizeof(unsigned int));
+        grid->items = (unsigned int*)RL_REALLOC(grid->items, grid->capacity * sizeof(unsigned int));
+        grid->positions = (Vector2*)RL_REALLOC(grid->positions, grid->capacity * sizeof(Vector2));
+        grid->speeds = (Vector2*)RL_REALLOC(grid->speeds, grid->capacity * sizeof(Vector2));
+        grid->resolvedPositions = (Vector2*)RL_REALLOC(grid->resolvedPositions, grid->capacity * sizeof(Vector2));
+        grid->resolvedSpeeds = (Vector2*)RL_REALLOC(grid->resolvedSpeeds, grid->capacity * sizeof(Vector2));
+    }
+
+    grid->bodies = (unsigned char*)bodies;
+    grid->count = count;
+    grid->stride = stride;
+
+    RunSpatialGridPhase(grid, GRID_PHASE_COUNT);
+
+    // Exclusive prefix sum over cells then threads, each thread scatters to its own offsets
+    unsigned int offset = 0;
+    int maxCellCount = 0;
+    for (int cell = 0; cell < grid->cellCount; cell++)
+    {
+        grid->cellStart[cell] = offset;
+        for (int t = 0; t < grid->pool->threadCount; t++)
+        {
+            unsigned int* counts = grid->counts + (size_t)t * grid->cellCount;
+            unsigned int cellCount = counts[cell];
+            counts[cell] = offset;
+            offset += cellCount;
+        }
+
+        if ((int)(offset - grid->cellStart[cell]) > maxCellCount)
+            maxCellCount = offset - grid->cellStart[cell];
+    }
+    grid->cellStart[grid->cellCount] = offset;
+
+    RunSpatialGridPhase(grid, GRID_PHASE_SCATTER);
+
+    grid->stats.maxCellCount = maxCellCount;
+    grid->stats.buildTime = GetWorkerTime() - start;
+}
+
+// Separate overlapping bodies of radius and bounce them off each other, restitution in [0, 1]
+// NOTE: Bodies must be the same array as the last build, speed is a Vector2 at speedOffset
+void CollideSpatialGrid(SpatialGrid* grid, int speedOffset, float radius, float restitution)
+{
+    double start = GetWorkerTime();
+
+    grid->speedOffset = speedOffset;
+    grid->radius = (radius * 2.0f <= grid->cellSize) ? radius : grid->cellSize * 0.5f;
+    grid->restitution = restitution;
+
+    // Neighbor speeds are read from sorted order, next to their positions
+    RunSpatialGridPhase(grid, GRID_PHASE_GATHER);
+    RunSpatialGridPhase(grid, GRID_PHASE_COLLIDE);
+    RunSpatialGridPhase(grid, GRID_PHASE_APPLY);
+
+    grid->stats.contacts = 0;
+    for (int i = 0; i < grid->pool->threadCount; i++)
+        grid->stats.contacts += grid->contacts[i];
+
+    grid->stats.collideTime = GetWorkerTime() - start;
+}
+
+// Find bodies within radius of a position, returns number of bodies found (up to maxResults)
+// NOTE: Only the 3x3 cells around the position are searched, radius must not exceed cellSize
+int QuerySpatialGrid(const SpatialGrid* grid, Vector2 position, float radius, unsigned int* results, int maxResults)
+{
+    int column = 0;
+    int row = 0;
+    GetSpatialGridCoords(grid, position, &column, &row);
+
+    int found = 0;
+    for (int y = row - 1; y <= row + 1; y++)
+    {
+        if ((y < 0) || (y >= grid->rows))
+            continue;
+
+        for (int x = column - 1; x <= column + 1; x++)
+        {
+            if ((x < 0) || (x >= grid->columns))
+                continue;
+
+            int cell = y * grid->columns + x;
+            for (unsigned int slot = grid->cellStart[cell]; slot < grid->cellStart[cell + 1]; slot++)
+            {
+                Vector2 delta = Vector2Subtract(position, grid->positions[slot]);
+                if (delta.x * delta.x + delta.y * delta.y > radius * radius)
+                    continue;
+
+                if (found < maxResults)
+                    results[found] = grid->items[slot];
+                found++;
+            }
+        }
+    }
+
+    return (found < maxResults) ? found : maxResults;
+}
+
+#endif // SPATIAL_GRID_H
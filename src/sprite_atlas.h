@@ -0,0 +1,355 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "rlgl_buffer_texture.h"
+#include "hash_fnv.h"
+
+// Required for: qsort()
+#include <stdlib.h>
+
+// Required for: memcpy(), memset(), strlen()
+#include <string.h>
+
+// Atlas layer size, sprites are shelf-packed into layers of a texture array
+#define SPRITE_ATLAS_LAYER_SIZE 1024
+
+// Gutter around each sprite, filled by extruding the sprite edges
+// NOTE: Sprites are placed on 4 pixel boundaries so the gutter survives down to mip level 2
+#define SPRITE_ATLAS_PADDING 4
+#define SPRITE_ATLAS_ALIGNMENT 4
+#define SPRITE_ATLAS_MIPMAPS 3
+
+// Cache file identification
+#define SPRITE_ATLAS_CACHE_MAGIC 0x534c5441 // "ATLS"
+#define SPRITE_ATLAS_CACHE_VERSION 1
+
+// Atlas entry, matches the layout read by shaders (2 x RGBA32F texels)
+typedef struct SpriteAtlasEntry {
+    Vector4 uvRect; // Normalized sub-image rectangle (u0, v0, u1, v1)
+    float layer;    // Texture array layer
+    float width;    // Sprite width in pixels
+    float height;   // Sprite height in pixels
+    float unused;
+} SpriteAtlasEntry;
+
+// Sprite atlas, many images in one texture array so they can share a draw
+typedef struct SpriteAtlas {
+    unsigned int textureId;         // OpenGL texture id (GL_TEXTURE_2D_ARRAY)
+    int layerCount;                 // Number of layers
+    int entryCount;                 // Number of sprites
+    SpriteAtlasEntry* entries;      // Sprites location in the atlas
+    rlBufferTexture entriesTexture; // Sprites location, read with texelFetch(sprite*2)
+} SpriteAtlas;
+
+// Cache file header, followed by the entries and the layers pixel data (RGBA8)
+typedef struct SpriteAtlasCacheHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int key;
+    int layerSize;
+    int layerCount;
+    int entryCount;
+} SpriteAtlasCacheHeader;
+
+// Sprite waiting to be packed
+typedef struct SpriteAtlasItem {
+    int index;
+    int width;
+    int height;
+} SpriteAtlasItem;
+
+int CompareSpriteAtlasItems(const void* a, const void* b)
+{
+    const SpriteAtlasItem* itemA = (const SpriteAtlasItem*)a;
+    const SpriteAtlasItem* itemB = (const SpriteAtlasItem*)b;
+
+    // Taller sprites first, then by index to keep packing deterministic
+    if (itemA->height != itemB->height)
+        return itemB->height - itemA->height;
+    return itemA->index - itemB->index;
+}
+
+// Shelf-pack images into atlas layers, returns the layers pixel data (RGBA8)
+// NOTE: Images must be PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+unsigned char* PackSpriteAtlas(Image* images, int imageCount, SpriteAtlasEntry* entries, int* layerCount)
+{
+    const int size = SPRITE_ATLAS_LAYER_SIZE;
+    const int padding = SPRITE_ATLAS_PADDING;
+    const int align = SPRITE_ATLAS_ALIGNMENT;
+
+    SpriteAtlasItem* items = (SpriteAtlasItem*)RL_CALLOC(imageCount, sizeof(SpriteAtlasItem));
+    for (int i = 0; i < imageCount; i++)
+        items[i] = (SpriteAtlasItem) { i, images[i].width, images[i].height };
+    qsort(items, imageCount, sizeof(SpriteAtlasItem), CompareSpriteAtlasItems);
+
+    // Place sprites, x/y are the top-left corner of the padded slot
+    int* positions = (int*)RL_CALLOC(imageCount * 3, sizeof(int));
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    int layer = 0;
+
+    for (int i = 0; i < imageCount; i++)
+    {
+        int slotWidth = (items[i].width + 2 * padding + align - 1) / align * align;
+        int slotHeight = (items[i].height + 2 * padding + align - 1) / align * align;
+
+        if (images[items[i].index].data == NULL)
+        {
+            TraceLog(LOG_WARNING, "ATLAS: Sprite %i has no image data, skipped", items[i].index);
+            positions[items[i].index * 3 + 2] = -1;
+            continue;
+        }
+
+        if ((slotWidth > size) || (slotHeight > size))
+        {
+            TraceLog(LOG_WARNING, "ATLAS: Sprite %i (%ix%i) does not fit in an atlas layer", items[i].index, items[i].width, items[i].height);
+            positions[items[i].index * 3 + 2] = -1;
+            continue;
+        }
+
+        // Start a new shelf, then a new layer
+        if (x + slotWidth > size)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (y + slotHeight > size)
+        {
+            x = 0;
+            y = 0;
+            shelfHeight = 0;
+            layer++;
+        }
+
+        positions[items[i].index * 3] = x + padding;
+        positions[items[i].index * 3 + 1] = y + padding;
+        positions[items[i].index * 3 + 2] = layer;
+
+        x += slotWidth;
+        if (slotHeight > shelfHeight)
+            shelfHeight = slotHeight;
+    }
+
+    *layerCount = layer + 1;
+    unsigned char* pixels = (unsigned char*)RL_CALLOC((size_t)size * size * 4 * (*layerCount), 1);
+
+    for (int i = 0; i < imageCount; i++)
+    {
+        int px = positions[i * 3];
+        int py = positions[i * 3 + 1];
+        int pl = positions[i * 3 + 2];
+        int width = images[i].width;
+        int height = images[i].height;
+
+        entries[i] = (SpriteAtlasEntry) { 0 };
+        if (pl < 0)
+            continue;
+
+        // Copy sprite and extrude its edges into the gutter
+        unsigned char* layerPixels = pixels + (size_t)size * size * 4 * pl;
+        const unsigned char* src = (const unsigned char*)images[i].data;
+        for (int dy = -padding; dy < height + padding; dy++)
+        {
+            int sy = (dy < 0) ? 0 : ((dy >= height) ? height - 1 : dy);
+            for (int dx = -padding; dx < width + padding; dx++)
+            {
+                int sx = (dx < 0) ? 0 : ((dx >= width) ? width - 1 : dx);
+                memcpy(&layerPixels[((py + dy) * size + (px + dx)) * 4], &src[(sy * width + sx) * 4], 4);
+            }
+        }
+
+        entries[i].uvRect = (Vector4) {
+            (float)px / size,
+            (float)py / size,
+            (float)(px + width) / size,
+            (float)(py + height) / size
+        };
+        entries[i].layer = (float)pl;
+        entries[i].width = (float)width;
+        entries[i].height = (float)height;
+    }
+
+    RL_FREE(items);
+    RL_FREE(positions);
+
+    return pixels;
+}
+
+// Upload packed layers into a texture array and entries into a buffer texture
+SpriteAtlas UploadSpriteAtlas(const SpriteAtlasEntry* entries, int entryCount, const unsigned char* pixels, int layerCount)
+{
+    SpriteAtlas atlas = { 0 };
+    atlas.layerCount = layerCount;
+    atlas.entryCount = entryCount;
+    atlas.entries = (SpriteAtlasEntry*)RL_MALLOC(entryCount * sizeof(SpriteAtlasEntry));
+    memcpy(atlas.entries, entries, entryCount * sizeof(SpriteAtlasEntry));
+
+    glGenTextures(1, &atlas.textureId);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas.textureId);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, SPRITE_ATLAS_LAYER_SIZE, SPRITE_ATLAS_LAYER_SIZE, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    // Limit mip chain to the levels where the gutter still separates sprites
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, SPRITE_ATLAS_MIPMAPS - 1);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    atlas.entriesTexture = rlLoadBufferTexture(entries, entryCount * sizeof(SpriteAtlasEntry), RL_BUFFER_TEXTURE_RGBA32F, false);
+
+    TraceLog(LOG_INFO, "ATLAS: [ID %i] Sprite atlas loaded successfully (%i sprites, %i layers)", atlas.textureId, entryCount, layerCount);
+
+    return atlas;
+}
+
+// Load sprite atlas from images (no cache)
+SpriteAtlas LoadSpriteAtlasFromImages(Image* images, int imageCount)
+{
+    for (int i = 0; i < imageCount; i++)
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    SpriteAtlasEntry* entries = (SpriteAtlasEntry*)RL_CALLOC(imageCount, sizeof(SpriteAtlasEntry));
+    int layerCount = 0;
+    unsigned char* pixels = PackSpriteAtlas(images, imageCount, entries, &layerCount);
+
+    SpriteAtlas atlas = UploadSpriteAtlas(entries, imageCount, pixels, layerCount);
+
+    RL_FREE(entries);
+    RL_FREE(pixels);
+
+    return atlas;
+}
+
+// Load sprite atlas from image files, images larger than maxSpriteSize are downscaled
+// NOTE: Packed result is stored in cacheFileName (can be NULL) and reused while
+// file names, modification times and atlas settings do not change
+SpriteAtlas LoadSpriteAtlas(const char** fileNames, int fileCount, int maxSpriteSize, const char* cacheFileName)
+{
+    // Cache key
+    unsigned int key = HASH_FNV_BASIS;
+    int settings[4] = { SPRITE_ATLAS_LAYER_SIZE, SPRITE_ATLAS_PADDING, SPRITE_ATLAS_MIPMAPS, maxSpriteSize };
+    key = HashFNV(key, settings, sizeof(settings));
+    for (int i = 0; i < fileCount; i++)
+    {
+        long modTime = GetFileModTime(fileNames[i]);
+        key = HashFNV(key, fileNames[i], strlen(fileNames[i]));
+        key = HashFNV(key, &modTime, sizeof(modTime));
+    }
+
+    // Try packed result from cache
+    if ((cacheFileName != NULL) && FileExists(cacheFileName))
+    {
+        unsigned int dataSize = 0;
+        unsigned char* data = LoadFileData(cacheFileName, &dataSize);
+
+        SpriteAtlasCacheHeader header = { 0 };
+        if ((data != NULL) && (dataSize >= sizeof(header)))
+            memcpy(&header, data, sizeof(header));
+
+        size_t entriesSize = (size_t)header.entryCount * sizeof(SpriteAtlasEntry);
+        size_t pixelsSize = (size_t)SPRITE_ATLAS_LAYER_SIZE * SPRITE_ATLAS_LAYER_SIZE * 4 * header.layerCount;
+
+        if ((header.magic == SPRITE_ATLAS_CACHE_MAGIC) && (header.version == SPRITE_ATLAS_CACHE_VERSION)
+            && (header.key == key) && (header.layerSize == SPRITE_ATLAS_LAYER_SIZE) && (header.entryCount == fileCount)
+            && (dataSize == sizeof(header) + entriesSize + pixelsSize))
+        {
+            const SpriteAtlasEntry* entries = (const SpriteAtlasEntry*)(data + sizeof(header));
+            const unsigned char* pixels = data + sizeof(header) + entriesSize;
+            SpriteAtlas atlas = UploadSpriteAtlas(entries, header.entryCount, pixels, header.layerCount);
+            UnloadFileData(data);
+
+            TraceLog(LOG_INFO, "ATLAS: Packed atlas loaded from cache: %s", cacheFileName);
+            return atlas;
+        }
+
+        UnloadFileData(data);
+        TraceLog(LOG_INFO, "ATLAS: Cache %s is out of date, packing atlas again", cacheFileName);
+    }
+
+    // Load and pack source images
+    Image* images = (Image*)RL_CALLOC(fileCount, sizeof(Image));
+    for (int i = 0; i < fileCount; i++)
+    {
+        images[i] = LoadImage(fileNames[i]);
+        if (images[i].data == NULL)
+        {
+            TraceLog(LOG_WARNING, "ATLAS: Failed to load sprite %i: %s", i, fileNames[i]);
+            continue;
+        }
+
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        int largest = (images[i].width > images[i].height) ? images[i].width : images[i].height;
+        if ((maxSpriteSize > 0) && (largest > maxSpriteSize))
+        {
+            float scale = (float)maxSpriteSize / largest;
+            ImageResize(&images[i], (int)(images[i].width * scale), (int)(images[i].height * scale));
+        }
+    }
+
+    SpriteAtlasEntry* entries = (SpriteAtlasEntry*)RL_CALLOC(fileCount, sizeof(SpriteAtlasEntry));
+    int layerCount = 0;
+    unsigned char* pixels = PackSpriteAtlas(images, fileCount, entries, &layerCount);
+
+    // Store packed result
+    if (cacheFileName != NULL)
+    {
+        SpriteAtlasCacheHeader header = { SPRITE_ATLAS_CACHE_MAGIC, SPRITE_ATLAS_CACHE_VERSION, key, SPRITE_ATLAS_LAYER_SIZE, layerCount, fileCount };
+        size_t entriesSize = (size_t)fileCount * sizeof(SpriteAtlasEntry);
+        size_t pixelsSize = (size_t)SPRITE_ATLAS_LAYER_SIZE * SPRITE_ATLAS_LAYER_SIZE * 4 * layerCount;
+
+        unsigned char* data = (unsigned char*)RL_MALLOC(sizeof(header) + entriesSize + pixelsSize);
+        memcpy(data, &header, sizeof(header));
+        memcpy(data + sizeof(header), entries, entriesSize);
+        memcpy(data + sizeof(header) + entriesSize, pixels, pixelsSize);
+        SaveFileData(cacheFileName, data, sizeof(header) + entriesSize + pixelsSize);
+        RL_FREE(data);
+    }
+
+    SpriteAtlas atlas = UploadSpriteAtlas(entries, fileCount, pixels, layerCount);
+
+    for (int i = 0; i < fileCount; i++)
+        UnloadImage(images[i]);
+    RL_FREE(images);
+    RL_FREE(entries);
+    RL_FREE(pixels);
+
+    return atlas;
+}
+
+// Bind atlas texture array and entries to texture slots
+void rlEnableSpriteAtlas(SpriteAtlas atlas, int slot, int entriesSlot)
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas.textureId);
+    glActiveTexture(GL_TEXTURE0);
+
+    rlEnableBufferTexture(atlas.entriesTexture, entriesSlot);
+}
+
+void rlDisableSpriteAtlas(int slot, int entriesSlot)
+{
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    rlDisableBufferTexture(entriesSlot);
+}
+
+// Unload sprite atlas from GPU and CPU memory
+void UnloadSpriteAtlas(SpriteAtlas atlas)
+{
+    glDeleteTextures(1, &atlas.textureId);
+    rlUnloadBufferTexture(atlas.entriesTexture);
+    RL_FREE(atlas.entries);
+}
+
+#endif // SPRITE_ATLAS_H
@@ -0,0 +1,295 @@
+#ifndef TEXT_INSTANCED_H
+#define TEXT_INSTANCED_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "hash_fnv.h"
+
+// Required for: offsetof()
+#include <stddef.h>
+
+// Required for: memcpy(), strlen(), strcmp()
+#include <string.h>
+
+// Shaped strings kept in the layout cache (power of two)
+#ifndef TEXT_LAYOUT_CACHE_SIZE
+#define TEXT_LAYOUT_CACHE_SIZE 4096
+#endif
+
+// Glyph instance record, one per drawn glyph (2 x vec4)
+typedef struct GlyphInstance {
+    Vector2 position;   // Top-left corner of the glyph quad
+    float scale;        // Font size / font base size
+    Color color;        // Glyph tint
+    Rectangle source;   // Glyph rectangle in the font atlas (pixels)
+} GlyphInstance;
+
+// Glyph of a shaped string, relative to the string position
+typedef struct CachedGlyph {
+    Vector2 offset;
+    Rectangle source;
+} CachedGlyph;
+
+// Shaped string, glyphs are stored in the cache glyph pool
+typedef struct TextLayout {
+    char* text;         // Copy of the string (NULL if slot is free)
+    unsigned int hash;  // String hash
+    float fontSize;
+    float spacing;
+    int firstGlyph;     // First glyph in glyph pool
+    int glyphCount;     // Number of glyphs
+} TextLayout;
+
+// Instanced text renderer, all queued glyphs are drawn with one instanced draw
+typedef struct TextRenderer {
+    Font font;                  // Font used for layout and atlas texture
+    Shader shader;              // Glyph instancing shader
+
+    GlyphInstance* glyphs;      // Glyphs queued for current draw
+    int glyphCount;             // Number of queued glyphs
+    int maxGlyphs;              // Instance buffer capacity
+
+    TextLayout* layouts;        // Shaped strings cache (open addressing)
+    int layoutCount;            // Number of cached strings
+    CachedGlyph* cachedGlyphs;  // Glyph pool for cached strings
+    int cachedGlyphCount;       // Number of glyphs in pool
+    int maxCachedGlyphs;        // Glyph pool capacity
+
+    unsigned int vaoId;         // Vertex array (unit quad + glyph instances)
+    unsigned int quadVboId;     // Unit quad vertex buffer
+    unsigned int instanceVboId; // Glyph instances buffer
+} TextRenderer;
+
+// Load instanced text renderer for a font
+TextRenderer LoadTextRenderer(Font font, int maxGlyphs)
+{
+    TextRenderer renderer = { 0 };
+    renderer.font = font;
+    renderer.shader = LoadShader("resources/shaders/text_instanced.vs", NULL);
+    renderer.maxGlyphs = maxGlyphs;
+    renderer.glyphs = (GlyphInstance*)RL_CALLOC(maxGlyphs, sizeof(GlyphInstance));
+
+    renderer.layouts = (TextLayout*)RL_CALLOC(TEXT_LAYOUT_CACHE_SIZE, sizeof(TextLayout));
+    renderer.maxCachedGlyphs = TEXT_LAYOUT_CACHE_SIZE * 16;
+    renderer.cachedGlyphs = (CachedGlyph*)RL_CALLOC(renderer.maxCachedGlyphs, sizeof(CachedGlyph));
+
+    // Unit quad, two triangles
+    float quad[12] = {
+        0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f
+    };
+
+    renderer.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(renderer.vaoId);
+
+    renderer.quadVboId = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    int cornerAttrib = rlGetLocationAttrib(renderer.shader.id, "vertexPosition");
+    rlSetVertexAttribute(cornerAttrib, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(cornerAttrib);
+
+    renderer.instanceVboId = rlLoadVertexBuffer(NULL, maxGlyphs * sizeof(GlyphInstance), true);
+
+    // glyph position and scale (3 x GL_FLOAT)
+    int placementAttrib = rlGetLocationAttrib(renderer.shader.id, "glyphPlacement");
+    rlEnableVertexAttribute(placementAttrib);
+    rlSetVertexAttribute(placementAttrib, 3, RL_FLOAT, false, sizeof(GlyphInstance), (void*)0);
+    rlSetVertexAttributeDivisor(placementAttrib, 1);
+
+    // glyph color (4 x GL_UNSIGNED_BYTE)
+    int colorAttrib = rlGetLocationAttrib(renderer.shader.id, "glyphColor");
+    rlEnableVertexAttribute(colorAttrib);
+    rlSetVertexAttribute(colorAttrib, 4, RL_UNSIGNED_BYTE, true, sizeof(GlyphInstance), (void*)offsetof(GlyphInstance, color));
+    rlSetVertexAttributeDivisor(colorAttrib, 1);
+
+    // glyph atlas rectangle (4 x GL_FLOAT)
+    int sourceAttrib = rlGetLocationAttrib(renderer.shader.id, "glyphSource");
+    rlEnableVertexAttribute(sourceAttrib);
+    rlSetVertexAttribute(sourceAttrib, 4, RL_FLOAT, false, sizeof(GlyphInstance), (void*)offsetof(GlyphInstance, source));
+    rlSetVertexAttributeDivisor(sourceAttrib, 1);
+
+    rlDisableVertexArray();
+
+    return renderer;
+}
+
+// Unload instanced text renderer (font is not unloaded)
+void UnloadTextRenderer(TextRenderer* renderer)
+{
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; i++)
+        RL_FREE(renderer->layouts[i].text);
+
+    RL_FREE(renderer->layouts);
+    RL_FREE(renderer->cachedGlyphs);
+    RL_FREE(renderer->glyphs);
+
+    rlUnloadVertexBuffer(renderer->quadVboId);
+    rlUnloadVertexBuffer(renderer->instanceVboId);
+    rlUnloadVertexArray(renderer->vaoId);
+    UnloadShader(renderer->shader);
+}
+
+// Clear shaped strings cache
+void ClearTextLayoutCache(TextRenderer* renderer)
+{
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; i++)
+    {
+        RL_FREE(renderer->layouts[i].text);
+        renderer->layouts[i] = (TextLayout) { 0 };
+    }
+
+    renderer->layoutCount = 0;
+    renderer->cachedGlyphCount = 0;
+}
+
+// Shape string into glyphs relative to its position, same layout as DrawTextEx()
+int ShapeText(Font font, const char* text, float fontSize, float spacing, CachedGlyph* glyphs, int maxGlyphs)
+{
+    int count = 0;
+    int length = TextLength(text);
+    float scaleFactor = fontSize / font.baseSize;
+    float padding = (float)font.glyphPadding;
+
+    float textOffsetX = 0.0f;
+    float textOffsetY = 0.0f;
+
+    for (int i = 0; i < length;)
+    {
+        int codepointByteCount = 0;
+        int codepoint = GetCodepoint(&text[i], &codepointByteCount);
+        int index = GetGlyphIndex(font, codepoint);
+
+        // NOTE: Normally we exit the decoding sequence as soon as a bad byte is found (and return 0x3f)
+        // but we need to draw all of the bad bytes using the '?' symbol moving one byte
+        if (codepoint == 0x3f)
+            codepointByteCount = 1;
+
+        if (codepoint == '\n')
+        {
+            textOffsetY += (int)((font.baseSize + font.baseSize / 2) * scaleFactor);
+            textOffsetX = 0.0f;
+        }
+        else
+        {
+            if ((codepoint != ' ') && (codepoint != '\t') && (count < maxGlyphs))
+            {
+                Rectangle rec = font.recs[index];
+                glyphs[count].offset = (Vector2) {
+                    textOffsetX + (font.glyphs[index].offsetX - padding) * scaleFactor,
+                    textOffsetY + (font.glyphs[index].offsetY - padding) * scaleFactor
+                };
+                glyphs[count].source = (Rectangle) { rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding };
+                count++;
+            }
+
+            if (font.glyphs[index].advanceX == 0)
+                textOffsetX += ((float)font.recs[index].width * scaleFactor + spacing);
+            else
+                textOffsetX += ((float)font.glyphs[index].advanceX * scaleFactor + spacing);
+        }
+
+        i += codepointByteCount;
+    }
+
+    return count;
+}
+
+// Get shaped string from cache, shaping and storing it on a miss
+TextLayout GetTextLayout(TextRenderer* renderer, const char* text, float fontSize, float spacing)
+{
+    unsigned int hash = HashFNV(HASH_FNV_BASIS, text, strlen(text));
+    unsigned int mask = TEXT_LAYOUT_CACHE_SIZE - 1;
+    unsigned int slot = hash & mask;
+
+    // Linear probing
+    while (renderer->layouts[slot].text != NULL)
+    {
+        TextLayout* layout = &renderer->layouts[slot];
+        if ((layout->hash == hash) && (layout->fontSize == fontSize) && (layout->spacing == spacing) && (strcmp(layout->text, text) == 0))
+            return *layout;
+        slot = (slot + 1) & mask;
+    }
+
+    // Keep probe sequences short and the glyph pool from overflowing, start over when full
+    int length = strlen(text);
+    if ((renderer->layoutCount + 1 > TEXT_LAYOUT_CACHE_SIZE * 3 / 4) || (renderer->cachedGlyphCount + length > renderer->maxCachedGlyphs))
+    {
+        ClearTextLayoutCache(renderer);
+        slot = hash & mask;
+    }
+
+    TextLayout layout = { 0 };
+    layout.hash = hash;
+    layout.fontSize = fontSize;
+    layout.spacing = spacing;
+    layout.firstGlyph = renderer->cachedGlyphCount;
+
+    if (length > renderer->maxCachedGlyphs)
+        return layout;
+
+    layout.glyphCount = ShapeText(renderer->font, text, fontSize, spacing, &renderer->cachedGlyphs[layout.firstGlyph], length);
+    layout.text = (char*)RL_MALLOC(length + 1);
+    memcpy(layout.text, text, length + 1);
+
+    renderer->cachedGlyphCount += layout.glyphCount;
+    renderer->layouts[slot] = layout;
+    renderer->layoutCount++;
+
+    return layout;
+}
+
+// Start queuing glyphs for an instanced text draw
+void BeginTextInstanced(TextRenderer* renderer)
+{
+    renderer->glyphCount = 0;
+}
+
+// Queue text glyphs, same parameters as DrawTextEx()
+void DrawTextInstanced(TextRenderer* renderer, const char* text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    TextLayout layout = GetTextLayout(renderer, text, fontSize, spacing);
+    float scale = fontSize / renderer->font.baseSize;
+
+    for (int i = 0; (i < layout.glyphCount) && (renderer->glyphCount < renderer->maxGlyphs); i++)
+    {
+        CachedGlyph glyph = renderer->cachedGlyphs[layout.firstGlyph + i];
+        GlyphInstance* instance = &renderer->glyphs[renderer->glyphCount++];
+        instance->position = Vector2Add(position, glyph.offset);
+        instance->scale = scale;
+        instance->color = tint;
+        instance->source = glyph.source;
+    }
+}
+
+// Upload queued glyphs and draw them with one instanced draw
+void EndTextInstanced(TextRenderer* renderer)
+{
+    if (renderer->glyphCount == 0)
+        return;
+
+    // Flush pending batched draws first
+    rlDrawRenderBatchActive();
+
+    rlUpdateVertexBuffer(renderer->instanceVboId, renderer->glyphs, renderer->glyphCount * sizeof(GlyphInstance), 0);
+
+    rlEnableShader(renderer->shader.id);
+
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix matMVP = MatrixMultiply(matModelView, rlGetMatrixProjection());
+    rlSetUniformMatrix(renderer->shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(renderer->shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(renderer->font.texture.id);
+
+    rlEnableVertexArray(renderer->vaoId);
+    rlDrawVertexArrayInstanced(0, 6, renderer->glyphCount);
+    rlDisableVertexArray();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+#endif // TEXT_INSTANCED_H
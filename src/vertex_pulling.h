@@ -0,0 +1,467 @@
+#ifndef VERTEX_PULLING_H
+#define VERTEX_PULLING_H
+
+#include "glad.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "rlgl_buffer_texture.h"
+
+// Required for: strstr(), strlen(), memcpy()
+#include <string.h>
+
+// Shader helpers file, replaces the '#include "vertex_pulling.glsl"' line of pulled shaders
+#ifndef VERTEX_PULLING_INCLUDE_PATH
+#define VERTEX_PULLING_INCLUDE_PATH "resources/shaders/vertex_pulling.glsl"
+#endif
+
+// Geometry pool layout: 2 x RGBA32F texels per vertex
+// texel 0: position.xyz, texcoord.x
+// texel 1: texcoord.y, normal.xyz
+#define RL_PULLED_VERTEX_FLOATS 8
+
+// Texture slots used by pulled draws (slot 0 is used by texture0)
+#define RL_PULLING_SLOT_VERTICES 1
+#define RL_PULLING_SLOT_INDICES 2
+#define RL_PULLING_SLOT_INSTANCE_WORDS 3
+#define RL_PULLING_SLOT_INSTANCE_TEXELS 4
+
+// Shader locations of the pulled draw base offsets, stored after the raylib locations
+#define RL_PULLING_LOC_VERTEX_BASE (RL_MAX_SHADER_LOCATIONS - 3)
+#define RL_PULLING_LOC_INDEX_BASE (RL_MAX_SHADER_LOCATIONS - 2)
+#define RL_PULLING_LOC_INSTANCE_BASE (RL_MAX_SHADER_LOCATIONS - 1)
+
+// Free-list allocator of contiguous ranges [offset, offset + size)
+typedef struct rlRangeAllocator {
+    int capacity;       // Total number of elements managed
+    int freeCount;      // Number of free blocks
+    int maxFree;        // Allocated size of free blocks arrays
+    int* freeOffsets;   // Free blocks offset, sorted by offset
+    int* freeSizes;     // Free blocks size
+} rlRangeAllocator;
+
+// Range of a mesh inside the geometry pool
+typedef struct rlGeometryRange {
+    int vertexOffset;   // First vertex in vertex pool
+    int vertexCount;    // Number of vertices
+    int indexOffset;    // First index in index pool
+    int indexCount;     // Number of indices (0 if allocation failed)
+} rlGeometryRange;
+
+// Geometry pool, vertex and index data of many meshes fetched with gl_VertexID
+typedef struct rlGeometryPool {
+    rlBufferTexture vertices;           // Vertex data (RGBA32F)
+    rlBufferTexture indices;            // Index data, relative to vertexOffset (R32UI)
+    rlRangeAllocator vertexAllocator;   // Vertex ranges allocator
+    rlRangeAllocator indexAllocator;    // Index ranges allocator
+    unsigned int vaoId;                 // Empty vertex array shared by every pulled draw
+} rlGeometryPool;
+
+// Indirect draw command, layout read by glDrawArraysIndirect()
+// NOTE: baseInstance must be 0 before OpenGL 4.2, pulled draws offset instances with instanceBase
+typedef struct rlDrawCommand {
+    unsigned int count;         // Vertices per instance (geometry range index count)
+    unsigned int instanceCount;
+    unsigned int first;
+    unsigned int baseInstance;
+} rlDrawCommand;
+
+// Instance pool, per-instance records fetched with gl_InstanceID
+// NOTE: Same storage viewed as raw words (R32UI) and as vec4 texels (RGBA32F)
+typedef struct rlInstancePool {
+    rlBufferTexture words;
+    rlBufferTexture texels;
+} rlInstancePool;
+
+//----------------------------------------------------------------------------------
+// Range allocator
+//----------------------------------------------------------------------------------
+rlRangeAllocator rlLoadRangeAllocator(int capacity)
+{
+    rlRangeAllocator allocator = { 0 };
+    allocator.capacity = capacity;
+    allocator.maxFree = 64;
+    allocator.freeOffsets = (int*)RL_CALLOC(allocator.maxFree, sizeof(int));
+    allocator.freeSizes = (int*)RL_CALLOC(allocator.maxFree, sizeof(int));
+
+    allocator.freeOffsets[0] = 0;
+    allocator.freeSizes[0] = capacity;
+    allocator.freeCount = 1;
+
+    return allocator;
+}
+
+void rlUnloadRangeAllocator(rlRangeAllocator* allocator)
+{
+    RL_FREE(allocator->freeOffsets);
+    RL_FREE(allocator->freeSizes);
+    *allocator = (rlRangeAllocator) { 0 };
+}
+
+// Allocate a range (first fit), returns -1 if no free block is large enough
+int rlAllocRange(rlRangeAllocator* allocator, int size)
+{
+    for (int i = 0; i < allocator->freeCount; i++)
+    {
+        if (allocator->freeSizes[i] < size)
+            continue;
+
+        int offset = allocator->freeOffsets[i];
+        allocator->freeOffsets[i] += size;
+        allocator->freeSizes[i] -= size;
+
+        // Remove exhausted block
+        if (allocator->freeSizes[i] == 0)
+        {
+            int moved = allocator->freeCount - i - 1;
+            memmove(&allocator->freeOffsets[i], &allocator->freeOffsets[i + 1], moved * sizeof(int));
+            memmove(&allocator->freeSizes[i], &allocator->freeSizes[i + 1], moved * sizeof(int));
+            allocator->freeCount--;
+        }
+
+        return offset;
+    }
+
+    return -1;
+}
+
+// Free a range, merging it with adjacent free blocks
+void rlFreeRange(rlRangeAllocator* allocator, int offset, int size)
+{
+    if ((offset < 0) || (size <= 0))
+        return;
+
+    // Find first free block after the range
+    int i = 0;
+    while ((i < allocator->freeCount) && (allocator->freeOffsets[i] < offset))
+        i++;
+
+    bool mergePrev = (i > 0) && (allocator->freeOffsets[i - 1] + allocator->freeSizes[i - 1] == offset);
+    bool mergeNext = (i < allocator->freeCount) && (offset + size == allocator->freeOffsets[i]);
+
+    if (mergePrev && mergeNext)
+    {
+        allocator->freeSizes[i - 1] += size + allocator->freeSizes[i];
+        int moved = allocator->freeCount - i - 1;
+        memmove(&allocator->freeOffsets[i], &allocator->freeOffsets[i + 1], moved * sizeof(int));
+        memmove(&allocator->freeSizes[i], &allocator->freeSizes[i + 1], moved * sizeof(int));
+        allocator->freeCount--;
+    }
+    else if (mergePrev)
+    {
+        allocator->freeSizes[i - 1] += size;
+    }
+    else if (mergeNext)
+    {
+        allocator->freeOffsets[i] = offset;
+        allocator->freeSizes[i] += size;
+    }
+    else
+    {
+        if (allocator->freeCount == allocator->maxFree)
+        {
+            allocator->maxFree *= 2;
+            allocator->freeOffsets = (int*)RL_REALLOC(allocator->freeOffsets, allocator->maxFree * sizeof(int));
+            allocator->freeSizes = (int*)RL_REALLOC(allocator->freeSizes, allocator->maxFree * sizeof(int));
+        }
+
+        int moved = allocator->freeCount - i;
+        memmove(&allocator->freeOffsets[i + 1], &allocator->freeOffsets[i], moved * sizeof(int));
+        memmove(&allocator->freeSizes[i + 1], &allocator->freeSizes[i], moved * sizeof(int));
+        allocator->freeOffsets[i] = offset;
+        allocator->freeSizes[i] = size;
+        allocator->freeCount++;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Geometry and instance pools
+//----------------------------------------------------------------------------------
+
+// Load geometry pool with capacity for a number of vertices and indices
+rlGeometryPool rlLoadGeometryPool(int vertexCapacity, int indexCapacity)
+{
+    rlGeometryPool pool = { 0 };
+
+    pool.vertices = rlLoadBufferTexture(NULL, vertexCapacity * RL_PULLED_VERTEX_FLOATS * sizeof(float), RL_BUFFER_TEXTURE_RGBA32F, false);
+    pool.indices = rlLoadBufferTexture(NULL, indexCapacity * sizeof(unsigned int), RL_BUFFER_TEXTURE_R32UI, false);
+    pool.vertexAllocator = rlLoadRangeAllocator(vertexCapacity);
+    pool.indexAllocator = rlLoadRangeAllocator(indexCapacity);
+
+    // No attributes are ever enabled, vertex data is fetched in the vertex shader
+    pool.vaoId = rlLoadVertexArray();
+
+    return pool;
+}
+
+void rlUnloadGeometryPool(rlGeometryPool* pool)
+{
+    rlUnloadBufferTexture(pool->vertices);
+    rlUnloadBufferTexture(pool->indices);
+    rlUnloadRangeAllocator(&pool->vertexAllocator);
+    rlUnloadRangeAllocator(&pool->indexAllocator);
+    rlUnloadVertexArray(pool->vaoId);
+}
+
+// Allocate and upload geometry, vertices use the RL_PULLED_VERTEX_FLOATS layout
+// NOTE: Indices are relative to the first vertex of the range
+rlGeometryRange rlLoadGeometry(rlGeometryPool* pool, const float* vertices, int vertexCount, const unsigned int* indices, int indexCount)
+{
+    rlGeometryRange range = { 0 };
+
+    int vertexOffset = rlAllocRange(&pool->vertexAllocator, vertexCount);
+    int indexOffset = rlAllocRange(&pool->indexAllocator, indexCount);
+    if ((vertexOffset < 0) || (indexOffset < 0))
+    {
+        rlFreeRange(&pool->vertexAllocator, vertexOffset, vertexCount);
+        rlFreeRange(&pool->indexAllocator, indexOffset, indexCount);
+        TraceLog(LOG_WARNING, "POOL: Failed to allocate geometry (%i vertices, %i indices)", vertexCount, indexCount);
+        return range;
+    }
+
+    int vertexSize = RL_PULLED_VERTEX_FLOATS * sizeof(float);
+    rlUpdateBufferTexture(pool->vertices, vertices, vertexCount * vertexSize, vertexOffset * vertexSize);
+    rlUpdateBufferTexture(pool->indices, indices, indexCount * sizeof(unsigned int), indexOffset * sizeof(unsigned int));
+
+    range.vertexOffset = vertexOffset;
+    range.vertexCount = vertexCount;
+    range.indexOffset = indexOffset;
+    range.indexCount = indexCount;
+
+    return range;
+}
+
+// Return geometry range to the pool
+void rlUnloadGeometry(rlGeometryPool* pool, rlGeometryRange range)
+{
+    rlFreeRange(&pool->vertexAllocator, range.vertexOffset, range.vertexCount);
+    rlFreeRange(&pool->indexAllocator, range.indexOffset, range.indexCount);
+}
+
+// Load instance pool with a size in bytes
+rlInstancePool rlLoadInstancePool(int size)
+{
+    rlInstancePool pool = { 0 };
+    pool.words = rlLoadBufferTexture(NULL, size, RL_BUFFER_TEXTURE_R32UI, true);
+    pool.texels = rlLoadBufferTextureView(pool.words, RL_BUFFER_TEXTURE_RGBA32F);
+    return pool;
+}
+
+// Update instance pool data, offset and size in bytes
+void rlUpdateInstancePool(rlInstancePool pool, const void* data, int size, int offset)
+{
+    rlUpdateBufferTexture(pool.words, data, size, offset);
+}
+
+void rlUnloadInstancePool(rlInstancePool pool)
+{
+    rlUnloadBufferTexture(pool.texels);
+    rlUnloadBufferTexture(pool.words);
+}
+
+//----------------------------------------------------------------------------------
+// raylib helpers
+//----------------------------------------------------------------------------------
+
+// Upload a raylib mesh into the geometry pool
+rlGeometryRange LoadMeshGeometry(rlGeometryPool* pool, Mesh mesh)
+{
+    float* vertices = (float*)RL_CALLOC(mesh.vertexCount * RL_PULLED_VERTEX_FLOATS, sizeof(float));
+    for (int i = 0; i < mesh.vertexCount; i++)
+    {
+        float* vertex = &vertices[i * RL_PULLED_VERTEX_FLOATS];
+        memcpy(&vertex[0], &mesh.vertices[i * 3], 3 * sizeof(float));
+        if (mesh.texcoords != NULL)
+        {
+            vertex[3] = mesh.texcoords[i * 2];
+            vertex[4] = mesh.texcoords[i * 2 + 1];
+        }
+        if (mesh.normals != NULL)
+            memcpy(&vertex[5], &mesh.normals[i * 3], 3 * sizeof(float));
+    }
+
+    // Non-indexed meshes get a sequential index list so every draw pulls through indices
+    int indexCount = (mesh.indices != NULL) ? mesh.triangleCount * 3 : mesh.vertexCount;
+    unsigned int* indices = (unsigned int*)RL_MALLOC(indexCount * sizeof(unsigned int));
+    for (int i = 0; i < indexCount; i++)
+        indices[i] = (mesh.indices != NULL) ? mesh.indices[i] : i;
+
+    rlGeometryRange range = rlLoadGeometry(pool, vertices, mesh.vertexCount, indices, indexCount);
+
+    RL_FREE(vertices);
+    RL_FREE(indices);
+
+    return range;
+}
+
+// Set pulled draw locations of a shader, pool samplers are bound to their slots once
+// NOTE: Required for shaders not loaded by LoadShaderPulled() (pulled shader variants)
+void SetShaderPulledLocations(Shader shader)
+{
+    if ((shader.id == 0) || (shader.id == rlGetShaderIdDefault()))
+        return;
+
+    shader.locs[RL_PULLING_LOC_VERTEX_BASE] = rlGetLocationUniform(shader.id, "vertexBase");
+    shader.locs[RL_PULLING_LOC_INDEX_BASE] = rlGetLocationUniform(shader.id, "indexBase");
+    shader.locs[RL_PULLING_LOC_INSTANCE_BASE] = rlGetLocationUniform(shader.id, "instanceBase");
+
+    int slots[4] = { RL_PULLING_SLOT_VERTICES, RL_PULLING_SLOT_INDICES, RL_PULLING_SLOT_INSTANCE_WORDS, RL_PULLING_SLOT_INSTANCE_TEXELS };
+    rlEnableShader(shader.id);
+    rlSetUniform(rlGetLocationUniform(shader.id, "vertexPool"), &slots[0], SHADER_UNIFORM_INT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "indexPool"), &slots[1], SHADER_UNIFORM_INT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "instanceWords"), &slots[2], SHADER_UNIFORM_INT, 1);
+    rlSetUniform(rlGetLocationUniform(shader.id, "instanceTexels"), &slots[3], SHADER_UNIFORM_INT, 1);
+    rlDisableShader();
+}
+
+// Load shader replacing the helpers include line of the vertex shader
+Shader LoadShaderPulled(const char* vsFileName, const char* fsFileName)
+{
+    const char* includeLine = "#include \"vertex_pulling.glsl\"";
+
+    char* vsText = LoadFileText(vsFileName);
+    char* fsText = (fsFileName != NULL) ? LoadFileText(fsFileName) : NULL;
+    char* helpers = LoadFileText(VERTEX_PULLING_INCLUDE_PATH);
+
+    char* vsCode = vsText;
+    char* include = (vsText != NULL && helpers != NULL) ? strstr(vsText, includeLine) : NULL;
+    if (include != NULL)
+    {
+        int headLength = include - vsText;
+        int helpersLength = strlen(helpers);
+        const char* tail = include + strlen(includeLine);
+
+        vsCode = (char*)RL_MALLOC(headLength + helpersLength + strlen(tail) + 1);
+        memcpy(vsCode, vsText, headLength);
+        memcpy(vsCode + headLength, helpers, helpersLength);
+        strcpy(vsCode + headLength + helpersLength, tail);
+    }
+
+    Shader shader = LoadShaderFromMemory(vsCode, fsText);
+
+    if (vsCode != vsText)
+        RL_FREE(vsCode);
+    UnloadFileText(vsText);
+    UnloadFileText(fsText);
+    UnloadFileText(helpers);
+
+    SetShaderPulledLocations(shader);
+
+    return shader;
+}
+
+//----------------------------------------------------------------------------------
+// Indirect draws
+//----------------------------------------------------------------------------------
+
+// Check if indirect draws are supported (OpenGL 4.0)
+bool rlIsIndirectDrawSupported(void)
+{
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    return (major * 10 + minor) >= 40;
+}
+
+// Load indirect buffer with capacity for a number of draw commands
+unsigned int rlLoadIndirectBuffer(int maxCommands)
+{
+    unsigned int id = 0;
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, id);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, maxCommands * sizeof(rlDrawCommand), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    return id;
+}
+
+// Update draw commands, offset in commands
+void rlUpdateIndirectBuffer(unsigned int id, const rlDrawCommand* commands, int count, int offset)
+{
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, id);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset * sizeof(rlDrawCommand), count * sizeof(rlDrawCommand), commands);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void rlUnloadIndirectBuffer(unsigned int id)
+{
+    glDeleteBuffers(1, &id);
+}
+
+//----------------------------------------------------------------------------------
+// Pulled draws
+//----------------------------------------------------------------------------------
+
+// Set shader, pools and texture of a pulled draw
+// NOTE: Shader locations are set by LoadShaderPulled() or SetShaderPulledLocations()
+void rlEnablePulledDraw(rlGeometryPool geometry, rlGeometryRange range, rlInstancePool instances, int instanceBase, Shader shader, Texture2D texture)
+{
+    // Flush pending batched draws first
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(shader.id);
+
+    // Model-view-projection as computed by DrawMesh()
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix matMVP = MatrixMultiply(matModelView, rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], matMVP);
+
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+
+    rlSetUniform(shader.locs[RL_PULLING_LOC_VERTEX_BASE], &range.vertexOffset, SHADER_UNIFORM_INT, 1);
+    rlSetUniform(shader.locs[RL_PULLING_LOC_INDEX_BASE], &range.indexOffset, SHADER_UNIFORM_INT, 1);
+    rlSetUniform(shader.locs[RL_PULLING_LOC_INSTANCE_BASE], &instanceBase, SHADER_UNIFORM_INT, 1);
+
+    rlEnableBufferTexture(geometry.vertices, RL_PULLING_SLOT_VERTICES);
+    rlEnableBufferTexture(geometry.indices, RL_PULLING_SLOT_INDICES);
+    rlEnableBufferTexture(instances.words, RL_PULLING_SLOT_INSTANCE_WORDS);
+    rlEnableBufferTexture(instances.texels, RL_PULLING_SLOT_INSTANCE_TEXELS);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(texture.id);
+
+    rlEnableVertexArray(geometry.vaoId);
+}
+
+// Restore state after a pulled draw, pool slots are unbound so later draws don't sample them
+void rlDisablePulledDraw(void)
+{
+    rlDisableVertexArray();
+
+    rlDisableBufferTexture(RL_PULLING_SLOT_VERTICES);
+    rlDisableBufferTexture(RL_PULLING_SLOT_INDICES);
+    rlDisableBufferTexture(RL_PULLING_SLOT_INSTANCE_WORDS);
+    rlDisableBufferTexture(RL_PULLING_SLOT_INSTANCE_TEXELS);
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Draw a pooled mesh instanced, only base offsets change between draws
+void DrawGeometryInstanced(rlGeometryPool geometry, rlGeometryRange range, rlInstancePool instances, int instanceBase, int instanceCount, Shader shader, Texture2D texture)
+{
+    if ((range.indexCount == 0) || (instanceCount == 0))
+        return;
+
+    rlEnablePulledDraw(geometry, range, instances, instanceBase, shader, texture);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, range.indexCount, instanceCount);
+    rlDisablePulledDraw();
+}
+
+// Draw a pooled mesh instanced, vertex and instance counts are read from a command of the indirect buffer
+void DrawGeometryIndirect(rlGeometryPool geometry, rlGeometryRange range, rlInstancePool instances, int instanceBase, unsigned int indirectId, int command, Shader shader, Texture2D texture)
+{
+    if (range.indexCount == 0)
+        return;
+
+    rlEnablePulledDraw(geometry, range, instances, instanceBase, shader, texture);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectId);
+    glDrawArraysIndirect(GL_TRIANGLES, (void*)(command * sizeof(rlDrawCommand)));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    rlDisablePulledDraw();
+}
+
+#endif // VERTEX_PULLING_H
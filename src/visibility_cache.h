@@ -0,0 +1,254 @@
+#ifndef VISIBILITY_CACHE_H
+#define VISIBILITY_CACHE_H
+
+#include "raylib.h"
+#include "raymath.h"
+
+// Required for: memset()
+#include <string.h>
+
+// Accumulated view rotation after which every node is tested again
+#ifndef VISIBILITY_MAX_ROTATION
+#define VISIBILITY_MAX_ROTATION 0.25f
+#endif
+
+// Node margins are shrunk to absorb float error in the motion bound
+#ifndef VISIBILITY_MARGIN_SCALE
+#define VISIBILITY_MARGIN_SCALE 0.99f
+#endif
+
+// Visibility cache stats, counters are totals since load
+typedef struct VisibilityStats {
+    int hits;               // Updates where every result was reused
+    int partials;           // Updates where only nodes near the frustum boundary were tested
+    int misses;             // Updates where every node was tested
+    long long tested;       // Node tests
+    long long reused;       // Node results reused
+    int changed;            // Nodes that changed visibility in last update
+} VisibilityStats;
+
+// Frustum culling results kept between frames
+// NOTE: A node is only tested again once the view moved more than its distance to the
+// nearest frustum plane, the plane displacement at a node is bounded by
+// translation + rotation * distance to the view position (rotation is the largest
+// change of a unit vector of the view frame)
+typedef struct VisibilityCache {
+    int count;              // Number of nodes
+    unsigned char* visible; // Node visibility (1 = inside frustum)
+    float* margins;         // Node distance to a visibility change at last test
+    float* distances;       // Node distance to the view position at last test
+    float* baselines;       // Accumulated motion bound at last test
+    float minMargin;        // Smallest margin left, all nodes are reused below it
+
+    Vector3 viewPosition;   // View at last update
+    Vector3 viewForward;
+    Vector3 viewRight;
+    Vector3 viewUp;
+    float fovy;
+    float aspect;
+    float translation;      // Motion accumulated since last full test
+    float rotation;
+    float maxDistance;      // Furthest node at last full test
+    bool valid;             // Results valid, cleared to force a full test
+
+    VisibilityStats stats;
+} VisibilityCache;
+
+// Load visibility cache for a number of nodes
+VisibilityCache LoadVisibilityCache(int count)
+{
+    VisibilityCache cache = { 0 };
+    cache.count = count;
+    cache.visible = (unsigned char*)RL_CALLOC(count, sizeof(unsigned char));
+    cache.margins = (float*)RL_CALLOC(count, sizeof(float));
+    cache.distances = (float*)RL_CALLOC(count, sizeof(float));
+    cache.baselines = (float*)RL_CALLOC(count, sizeof(float));
+
+    return cache;
+}
+
+// Unload visibility cache
+void UnloadVisibilityCache(VisibilityCache* cache)
+{
+    RL_FREE(cache->visible);
+    RL_FREE(cache->margins);
+    RL_FREE(cache->distances);
+    RL_FREE(cache->baselines);
+}
+
+// Force every node to be tested on next update (nodes moved, field of view reset...)
+void InvalidateVisibilityCache(VisibilityCache* cache)
+{
+    cache->valid = false;
+}
+
+// Extract normalized frustum planes from a view projection matrix (ax + by + cz + d >= 0 inside)
+void GetFrustumPlanes(Matrix viewProjection, Vector4* planes)
+{
+    Matrix m = viewProjection;
+
+    // Rows of the matrix in raylib layout (m0, m4, m8, m12 is the first row)
+    Vector4 row0 = { m.m0, m.m4, m.m8, m.m12 };
+    Vector4 row1 = { m.m1, m.m5, m.m9, m.m13 };
+    Vector4 row2 = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row3 = { m.m3, m.m7, m.m11, m.m15 };
+
+    Vector4 rows[3] = { row0, row1, row2 };
+    for (int i = 0; i < 3; i++)
+    {
+        planes[i * 2] = (Vector4) { row3.x + rows[i].x, row3.y + rows[i].y, row3.z + rows[i].z, row3.w + rows[i].w };
+        planes[i * 2 + 1] = (Vector4) { row3.x - rows[i].x, row3.y - rows[i].y, row3.z - rows[i].z, row3.w - rows[i].w };
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        float length = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+        if (length > 0.0f)
+            planes[i] = (Vector4) { planes[i].x / length, planes[i].y / length, planes[i].z / length, planes[i].w / length };
+    }
+}
+
+// Test a sphere against frustum planes, margin is the distance the planes can move without changing the result
+bool TestFrustumSphere(const Vector4* planes, Vector3 center, float radius, float* margin)
+{
+    bool inside = true;
+    *margin = 1e30f;
+
+    for (int i = 0; i < 6; i++)
+    {
+        float distance = planes[i].x * center.x + planes[i].y * center.y + planes[i].z * center.z + planes[i].w + radius;
+        if (distance < 0.0f)
+            inside = false;
+
+        *margin = fminf(*margin, fabsf(distance));
+    }
+
+    return inside;
+}
+
+// Test one node and store its result
+void UpdateVisibilityNode(VisibilityCache* cache, int index, const Vector4* planes, Vector4 sphere, Vector3 viewPosition)
+{
+    Vector3 center = { sphere.x, sphere.y, sphere.z };
+    float margin = 0.0f;
+
+    unsigned char visible = TestFrustumSphere(planes, center, sphere.w, &margin);
+    if (visible != cache->visible[index])
+        cache->stats.changed++;
+
+    cache->visible[index] = visible;
+    cache->margins[index] = margin * VISIBILITY_MARGIN_SCALE;
+    cache->distances[index] = Vector3Distance(center, viewPosition);
+    cache->baselines[index] = cache->translation + cache->rotation * (cache->distances[index] + cache->translation);
+}
+
+// Update node visibility, spheres are node bounds (center, radius)
+// NOTE: view is the camera in the same space as the spheres and viewProjection,
+// dirty tells the view changed since last update (see CameraFP.dirty).
+// Returns true if any node visibility changed
+bool UpdateVisibilityCache(VisibilityCache* cache, const Vector4* spheres, Matrix viewProjection, Camera3D view, float aspect, bool dirty)
+{
+    cache->stats.changed = 0;
+
+    // Nothing moved, every result is still valid
+    if (cache->valid && !dirty)
+    {
+        cache->stats.hits++;
+        cache->stats.reused += cache->count;
+        return false;
+    }
+
+    // View frame, any unit vector moves at most by the length of the frame vectors change
+    Vector3 viewPosition = view.position;
+    Vector3 forward = Vector3Normalize(Vector3Subtract(view.target, view.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, view.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+
+    float frameChange = Vector3LengthSqr(Vector3Subtract(forward, cache->viewForward)) +
+        Vector3LengthSqr(Vector3Subtract(right, cache->viewRight)) + Vector3LengthSqr(Vector3Subtract(up, cache->viewUp));
+
+    // Field of view changes turn the side planes, horizontal planes turn up to aspect / cos^2 times more
+    float halfFovy = fmaxf(view.fovy, cache->fovy) * 0.5f * DEG2RAD;
+    float fovyChange = fabsf(view.fovy - cache->fovy) * 0.5f * DEG2RAD * fmaxf(aspect, 1.0f) / (cosf(halfFovy) * cosf(halfFovy));
+
+    // Accumulate motion since last full test
+    cache->translation += Vector3Distance(viewPosition, cache->viewPosition);
+    cache->rotation += sqrtf(frameChange) + fovyChange;
+
+    cache->viewPosition = viewPosition;
+    cache->viewForward = forward;
+    cache->viewRight = right;
+    cache->viewUp = up;
+    cache->fovy = view.fovy;
+
+    Vector4 planes[6] = { 0 };
+    GetFrustumPlanes(viewProjection, planes);
+
+    bool full = !cache->valid || (aspect != cache->aspect) || (cache->rotation > VISIBILITY_MAX_ROTATION);
+    if (full)
+    {
+        bool reset = !cache->valid;
+
+        cache->translation = 0.0f;
+        cache->rotation = 0.0f;
+        cache->aspect = aspect;
+        cache->maxDistance = 0.0f;
+        cache->minMargin = 1e30f;
+
+        if (reset)
+            memset(cache->visible, 0, cache->count);
+
+        for (int i = 0; i < cache->count; i++)
+        {
+            UpdateVisibilityNode(cache, i, planes, spheres[i], viewPosition);
+            cache->maxDistance = fmaxf(cache->maxDistance, cache->distances[i]);
+            cache->minMargin = fminf(cache->minMargin, cache->margins[i]);
+        }
+
+        cache->valid = true;
+        cache->stats.misses++;
+        cache->stats.tested += cache->count;
+
+        // Results after a reset are all new, even if no node is visible
+        return reset || (cache->stats.changed > 0);
+    }
+
+    // Motion smaller than the closest node margin, no node can have changed
+    float bound = cache->translation + cache->rotation * (cache->maxDistance + cache->translation);
+    if (bound < cache->minMargin)
+    {
+        cache->stats.hits++;
+        cache->stats.reused += cache->count;
+        return false;
+    }
+
+    // Test again only nodes whose margin was used up by the motion since their last test
+    int tested = 0;
+    for (int i = 0; i < cache->count; i++)
+    {
+        float motion = cache->translation + cache->rotation * (cache->distances[i] + cache->translation) - cache->baselines[i];
+        if (motion >= cache->margins[i])
+        {
+            UpdateVisibilityNode(cache, i, planes, spheres[i], viewPosition);
+            tested++;
+        }
+    }
+
+    // Global bound is loose now, it is rebuilt on next full test
+    cache->minMargin = 0.0f;
+
+    cache->stats.partials++;
+    cache->stats.tested += tested;
+    cache->stats.reused += cache->count - tested;
+
+    return cache->stats.changed > 0;
+}
+
+// Get share of node results reused instead of tested
+float GetVisibilityCacheHitRate(VisibilityCache cache)
+{
+    long long total = cache.stats.tested + cache.stats.reused;
+    return (total > 0) ? (float)cache.stats.reused / (float)total : 0.0f;
+}
+
+#endif // VISIBILITY_CACHE_H
@@ -0,0 +1,172 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "raylib.h"
+
+// Required for: clock_gettime()
+#include <time.h>
+// Required for: pthread_create(), pthread_mutex_lock(), pthread_cond_wait()
+#include <pthread.h>
+// Required for: sysconf()
+#include <unistd.h>
+
+// Maximum pool threads, main thread included
+#ifndef WORKER_POOL_MAX_THREADS
+#define WORKER_POOL_MAX_THREADS 32
+#endif
+
+// Run the part of a job assigned to a thread, index goes from 0 to the pool thread count
+// NOTE: Called from several threads at once, must not call raylib/rlgl
+typedef void (*WorkerPoolFunc)(void* userData, int index);
+
+typedef struct WorkerPool WorkerPool;
+
+// Pool thread
+typedef struct PoolWorker {
+    WorkerPool* pool;
+    int index;
+    pthread_t thread;
+} PoolWorker;
+
+// Persistent threads running one job at a time, the calling thread runs part 0 of every job
+// NOTE: Workers sleep on a condition between jobs, a job costs one broadcast and one wait
+struct WorkerPool {
+    int threadCount;                                // Pool threads, main thread included
+    PoolWorker workers[WORKER_POOL_MAX_THREADS];    // Worker 0 is the main thread
+
+    pthread_mutex_t mutex;                          // Protects job state
+    pthread_cond_t start;                           // Signals a new job (or shutdown)
+    pthread_cond_t done;                            // Signals a finished part
+    unsigned int generation;                        // Job counter, workers run once per generation
+    int remaining;                                  // Workers still running current job
+    bool running;                                   // Workers keep running while set
+
+    // Current job
+    WorkerPoolFunc func;
+    void* userData;
+};
+
+// Get time in seconds, GetTime() is not safe to call from pool threads
+double GetWorkerTime(void)
+{
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Get number of online CPU cores
+int GetWorkerCoreCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count < 1) ? 1 : (count > WORKER_POOL_MAX_THREADS) ? WORKER_POOL_MAX_THREADS : (int)count;
+}
+
+// Get range [first, last) of count items assigned to a thread, items are split evenly
+void GetWorkerRange(const WorkerPool* pool, int count, int index, int* first, int* last)
+{
+    *first = (int)((long long)count * index / pool->threadCount);
+    *last = (int)((long long)count * (index + 1) / pool->threadCount);
+}
+
+// Worker thread, runs its part once per job
+void* WorkerPoolThread(void* arg)
+{
+    PoolWorker* worker = (PoolWorker*)arg;
+    WorkerPool* pool = worker->pool;
+    unsigned int generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true)
+    {
+        while (pool->running && (pool->generation == generation))
+            pthread_cond_wait(&pool->start, &pool->mutex);
+
+        if (!pool->running)
+            break;
+
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool->func(pool->userData, worker->index);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->remaining--;
+        if (pool->remaining == 0)
+            pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+// Load worker pool, threadCount <= 0 uses every core
+WorkerPool* LoadWorkerPool(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = GetWorkerCoreCount();
+    if (threadCount > WORKER_POOL_MAX_THREADS)
+        threadCount = WORKER_POOL_MAX_THREADS;
+
+    WorkerPool* pool = (WorkerPool*)RL_CALLOC(1, sizeof(WorkerPool));
+    pool->threadCount = threadCount;
+    pool->running = true;
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+
+        if ((i > 0) && (pthread_create(&pool->workers[i].thread, NULL, WorkerPoolThread, &pool->workers[i]) != 0))
+        {
+            TraceLog(LOG_WARNING, "POOL: Failed to start worker thread %i", i);
+            pool->threadCount = i;
+            break;
+        }
+    }
+
+    return pool;
+}
+
+// Stop pool threads and unload worker pool
+void UnloadWorkerPool(WorkerPool* pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->running = false;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->threadCount; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+
+    RL_FREE(pool);
+}
+
+// Run a job on every thread, returns when all parts are done
+void RunWorkerPool(WorkerPool* pool, WorkerPoolFunc func, void* userData)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->func = func;
+    pool->userData = userData;
+    pool->remaining = pool->threadCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    // Main thread runs the first part
+    func(userData, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->remaining > 0)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+#endif // WORKER_POOL_H